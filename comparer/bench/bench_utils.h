@@ -0,0 +1,58 @@
+#ifndef _BENCH_UTILS_H_
+
+#define _BENCH_UTILS_H_
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+// Helpers shared by the benchmarks: a wall clock timer, the peak resident size of the process and dumps written to the
+// temporary directory of the system.
+namespace BenchUtils {
+    using Clock = std::chrono::steady_clock;
+
+    // seconds since the given time
+    inline double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // peak resident size of the process in megabytes
+    inline long peakResidentMegabytes() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss / 1024;
+    }
+
+    // positive number given as the argument, the default if the argument is missing
+    inline size_t parseCount(int argc, char* argv[], int index, size_t defaultCount) {
+        if (argc <= index) {
+            return defaultCount;
+        }
+        char* end = nullptr;
+        unsigned long long count = std::strtoull(argv[index], &end, 10);
+        if (end == argv[index] || *end != '\0' || count == 0) {
+            throw std::invalid_argument(std::string("Expected a positive number instead of ") + argv[index]);
+        }
+        return static_cast<size_t>(count);
+    }
+
+    // writes the lines as a text dump into the temporary directory, returns its path
+    inline std::string writeDump(const std::string& fileName, const std::vector<std::string>& lines) {
+        std::string path = (std::filesystem::temp_directory_path() / fileName).string();
+        std::ofstream file(path, std::ios::trunc);
+        for (const std::string& line : lines) {
+            file << line << "\n";
+        }
+        if (!file) {
+            throw std::runtime_error("Could not write " + path);
+        }
+        return path;
+    }
+}
+
+#endif
@@ -0,0 +1,97 @@
+#include "bench_utils.h"
+#include "../include/decl_join.h"
+#include "../include/null_database_wrapper.h"
+#include "../include/tree.h"
+#include "../include/tree_comparer.h"
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // dump of namespaces holding functions with a statement each, the second dump drops and adds some of the functions
+    std::vector<std::string> generateDump(size_t declarationCount, bool isSecond) {
+        std::mt19937 random(isSecond ? 2 : 1);
+        std::vector<std::string> lines = {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0"};
+        for (size_t n = 0, declarations = 0; declarations < declarationCount; ++n) {
+            std::string path = "/gen/file" + std::to_string(n % 2000) + ".h";
+            lines.push_back(" Declaration\tNamespace\tc:@N@ns" + std::to_string(n) + "\t" + path + "\t1\t1");
+            ++declarations;
+            for (size_t f = 0; f < 20 && declarations < declarationCount; ++f) {
+                if (random() % 10 == 0) {
+                    continue; // only in the other dump
+                }
+                std::string line = std::to_string(10 * f + 2);
+                lines.push_back("  Declaration\tFunction\tc:@N@ns" + std::to_string(n) + "@F@function" + std::to_string(f) + "\t" +
+                                path + "\t" + line + "\t1");
+                lines.push_back("   Statement\tReturnStmt\tN/A\t" + path + "\t" + line + "\t5");
+                ++declarations;
+            }
+        }
+        return lines;
+    }
+}
+
+// Times the join of the declaration keys of two trees on its own, next to the per-key lookups it replaced and the whole
+// comparison. Without arguments two dumps of 300000 declarations are generated.
+//
+//     decl_join_bench [first dump second dump] [thread count, 1 by default]
+//     decl_join_bench [declaration count]
+int main(int argc, char* argv[]) {
+    try {
+        std::string firstPath;
+        std::string secondPath;
+        std::vector<std::string> generatedPaths;
+        unsigned int threadCount = 1;
+        if (argc > 2) {
+            firstPath = argv[1];
+            secondPath = argv[2];
+            threadCount = static_cast<unsigned int>(BenchUtils::parseCount(argc, argv, 3, 1));
+        } else {
+            size_t declarationCount = BenchUtils::parseCount(argc, argv, 1, 300000);
+            firstPath = BenchUtils::writeDump("decl_join_bench_1.txt", generateDump(declarationCount, false));
+            secondPath = BenchUtils::writeDump("decl_join_bench_2.txt", generateDump(declarationCount, true));
+            generatedPaths = {firstPath, secondPath};
+        }
+
+        {
+            auto start = BenchUtils::Clock::now();
+            Tree firstTree(firstPath, threadCount);
+            Tree secondTree(secondPath, threadCount);
+            std::cout << "keys " << firstTree.getDeclNodeMultiMap().keyCount() << "/" << secondTree.getDeclNodeMultiMap().keyCount()
+                      << ", build " << BenchUtils::secondsSince(start) << " s" << std::endl;
+
+            // the join is repeated, the first run also pays for the page faults of its arrays
+            for (int repetition = 0; repetition < 3; ++repetition) {
+                start = BenchUtils::Clock::now();
+                DeclJoin join(firstTree, secondTree, threadCount);
+                double joinSeconds = BenchUtils::secondsSince(start);
+
+                start = BenchUtils::Clock::now();
+                size_t lookupMatches = 0;
+                firstTree.getDeclNodeMultiMap().forEachRun([&secondTree, &lookupMatches](uint32_t, auto first, auto) {
+                    lookupMatches += secondTree.isDeclNodeInAST(first->first);
+                });
+                double lookupSeconds = BenchUtils::secondsSince(start);
+
+                std::cout << "join " << joinSeconds << " s (" << join.getMatchedKeyCount() << " matched keys), per-key lookups "
+                          << lookupSeconds << " s (" << lookupMatches << " matched keys)" << std::endl;
+            }
+
+            NullDatabaseWrapper sink;
+            TreeComparer comparer(firstTree, secondTree, sink, threadCount);
+            start = BenchUtils::Clock::now();
+            comparer.printDifferences();
+            std::cout << "compare " << BenchUtils::secondsSince(start) << " s, including the join" << std::endl;
+        }
+
+        for (const std::string& path : generatedPaths) {
+            std::filesystem::remove(path);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "bench_utils.h"
+#include "../include/flat_index.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    // builds the index from the values and looks up the probes, prints the timings, the growth of the peak resident size
+    // and the sum of the values found, which is the same for both indices
+    template<typename Build, typename Lookup>
+    void run(const std::string& name, Build&& build, Lookup&& lookup, const std::vector<uint32_t>& probes) {
+        long baseMegabytes = BenchUtils::peakResidentMegabytes();
+        auto start = BenchUtils::Clock::now();
+        auto index = build();
+        double buildSeconds = BenchUtils::secondsSince(start);
+
+        start = BenchUtils::Clock::now();
+        size_t sum = 0;
+        for (uint32_t probe : probes) {
+            sum += lookup(index, probe);
+        }
+        double lookupSeconds = BenchUtils::secondsSince(start);
+        std::cout << name << ": build " << buildSeconds << " s, lookup " << lookupSeconds << " s, +"
+                  << BenchUtils::peakResidentMegabytes() - baseMegabytes << " MB, sum " << sum << std::endl;
+    }
+}
+
+// Builds an index from 32-bit keys to values, then looks up random keys. The values are spread over three quarters as many
+// keys, so some keys hold several values. FlatIndex and the unordered_multimap it replaced are timed in separate runs, so
+// the peak resident size of one does not hide the other.
+//
+//     flat_index_bench [flat|multimap] [value count, 10000000 by default]
+int main(int argc, char* argv[]) {
+    try {
+        std::string indexName = argc > 1 ? argv[1] : "flat";
+        if (indexName != "flat" && indexName != "multimap") {
+            throw std::invalid_argument("Expected flat or multimap instead of " + indexName);
+        }
+        size_t valueCount = BenchUtils::parseCount(argc, argv, 2, 10000000);
+        uint32_t keyRange = static_cast<uint32_t>(valueCount * 3 / 4 + 1);
+
+        std::mt19937 random(1);
+        std::vector<uint32_t> keys(valueCount);
+        for (uint32_t& key : keys) {
+            key = random() % keyRange;
+        }
+        std::vector<uint32_t> probes(valueCount);
+        for (uint32_t& probe : probes) {
+            probe = random() % keyRange;
+        }
+
+        if (indexName == "flat") {
+            run("FlatIndex", [&keys]() {
+                FlatIndex<uint32_t> index;
+                index.build(keys.size(), [&keys](auto&& addValue) {
+                    for (uint32_t i = 0; i < keys.size(); ++i) {
+                        addValue(keys[i], i);
+                    }
+                });
+                return index;
+            }, [](const FlatIndex<uint32_t>& index, uint32_t probe) {
+                size_t sum = 0;
+                auto [first, last] = index.equal_range(probe);
+                for (auto it = first; it != last; ++it) {
+                    sum += *it;
+                }
+                return sum;
+            }, probes);
+        } else {
+            run("unordered_multimap", [&keys]() {
+                std::unordered_multimap<uint32_t, uint32_t> index;
+                index.reserve(keys.size());
+                for (uint32_t i = 0; i < keys.size(); ++i) {
+                    index.emplace(keys[i], i);
+                }
+                return index;
+            }, [](const std::unordered_multimap<uint32_t, uint32_t>& index, uint32_t probe) {
+                size_t sum = 0;
+                auto [first, last] = index.equal_range(probe);
+                for (auto it = first; it != last; ++it) {
+                    sum += it->second;
+                }
+                return sum;
+            }, probes);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "bench_utils.h"
+#include "../include/counting_database_wrapper.h"
+#include "../include/tree.h"
+#include "../include/tree_comparer.h"
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compares one function with a long body against a copy with 1% of its statements changed. The statements are drawn from
+// four kinds, so most of them share their key with thousands of others, the case a nested loop over the body is quadratic in.
+//
+//     statement_match_bench [statement count, 100000 by default]
+int main(int argc, char* argv[]) {
+    try {
+        size_t statementCount = BenchUtils::parseCount(argc, argv, 1, 100000);
+
+        const char* kinds[] = {"ExprStmt", "IfStmt", "ReturnStmt", "DeclStmt"};
+        std::mt19937 random(1);
+        std::vector<std::string> firstLines = {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+                                               " Declaration\tFunction\tc:@F@generated\t/gen/big.cpp\t1\t1"};
+        std::vector<std::string> secondLines = firstLines;
+        for (size_t i = 0; i < statementCount; ++i) {
+            std::string position = "\tN/A\t/gen/big.cpp\t" + std::to_string(i + 2) + "\t3";
+            std::string kind = kinds[random() % 4];
+            firstLines.push_back("  Statement\t" + kind + position);
+            secondLines.push_back("  Statement\t" + (random() % 100 == 0 ? std::string("NullStmt") : kind) + position);
+        }
+        std::string firstPath = BenchUtils::writeDump("statement_match_bench_1.txt", firstLines);
+        std::string secondPath = BenchUtils::writeDump("statement_match_bench_2.txt", secondLines);
+
+        {
+            auto start = BenchUtils::Clock::now();
+            Tree firstTree(firstPath, 1);
+            Tree secondTree(secondPath, 1);
+            double buildSeconds = BenchUtils::secondsSince(start);
+
+            CountingDatabaseWrapper counter;
+            TreeComparer comparer(firstTree, secondTree, counter);
+            start = BenchUtils::Clock::now();
+            comparer.printDifferences();
+            double compareSeconds = BenchUtils::secondsSince(start);
+
+            std::cout << "statements " << statementCount << ", build " << buildSeconds << " s, compare " << compareSeconds
+                      << " s, " << counter.getNodeCount() << " differences" << std::endl;
+        }
+
+        std::filesystem::remove(firstPath);
+        std::filesystem::remove(secondPath);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
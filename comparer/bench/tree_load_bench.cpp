@@ -0,0 +1,86 @@
+#include "bench_utils.h"
+#include "../include/tree.h"
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+    std::atomic<size_t> allocationCount{0};
+
+    // namespaces of functions with a compound statement and a return each, 3 nodes per function
+    std::vector<std::string> generateDump(size_t nodeCount) {
+        std::vector<std::string> lines = {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0"};
+        for (size_t n = 0; lines.size() < nodeCount; ++n) {
+            std::string path = "/gen/file" + std::to_string(n % 2000) + ".h";
+            lines.push_back(" Declaration\tNamespace\tc:@N@ns" + std::to_string(n) + "\t" + path + "\t1\t1");
+            for (size_t f = 0; f < 20 && lines.size() < nodeCount; ++f) {
+                std::string line = std::to_string(10 * f + 2);
+                lines.push_back("  Declaration\tFunction\tc:@N@ns" + std::to_string(n) + "@F@function" + std::to_string(f) + "\t" +
+                                path + "\t" + line + "\t1");
+                lines.push_back("   Statement\tCompoundStmt\tN/A\t" + path + "\t" + line + "\t5");
+                lines.push_back("    Statement\tReturnStmt\tN/A\t" + path + "\t" + line + "\t7");
+            }
+        }
+        return lines;
+    }
+}
+
+// every heap allocation of the benchmark goes through here and is counted, the arrays as well
+void* operator new(size_t size) {
+    ++allocationCount;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+// Loads a dump and deletes the tree again, prints the load and teardown times, the heap allocations of the load and the peak
+// resident size. Without a dump argument a dump of 3 million nodes is generated.
+//
+//     tree_load_bench [dump] [thread count, 1 by default]
+//     tree_load_bench [node count]
+int main(int argc, char* argv[]) {
+    try {
+        std::string path;
+        bool isGenerated = false;
+        unsigned int threadCount = 1;
+        if (argc > 1 && std::filesystem::exists(argv[1])) {
+            path = argv[1];
+            threadCount = static_cast<unsigned int>(BenchUtils::parseCount(argc, argv, 2, 1));
+        } else {
+            path = BenchUtils::writeDump("tree_load_bench.txt", generateDump(BenchUtils::parseCount(argc, argv, 1, 3000000)));
+            isGenerated = true;
+        }
+
+        size_t baseAllocations = allocationCount;
+        auto start = BenchUtils::Clock::now();
+        {
+            Tree tree(path, threadCount);
+            std::cout << "nodes " << tree.getNodeCount() << ", load " << BenchUtils::secondsSince(start) << " s, "
+                      << allocationCount - baseAllocations << " allocations" << std::endl;
+            start = BenchUtils::Clock::now();
+        }
+        std::cout << "teardown " << BenchUtils::secondsSince(start) << " s, peak " << BenchUtils::peakResidentMegabytes() << " MB"
+                  << std::endl;
+
+        if (isGenerated) {
+            std::filesystem::remove(path);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ast-tree-comparer.dir/src/main.cpp.o"
+  "CMakeFiles/ast-tree-comparer.dir/src/main.cpp.o.d"
+  "ast-tree-comparer"
+  "ast-tree-comparer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ast-tree-comparer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
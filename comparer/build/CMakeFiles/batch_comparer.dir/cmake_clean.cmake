@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/batch_comparer.dir/src/batch_comparer.cpp.o"
+  "CMakeFiles/batch_comparer.dir/src/batch_comparer.cpp.o.d"
+  "libbatch_comparer.a"
+  "libbatch_comparer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/batch_comparer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
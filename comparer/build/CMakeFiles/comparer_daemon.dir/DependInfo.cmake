@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/comparer/src/comparer_daemon.cpp" "CMakeFiles/comparer_daemon.dir/src/comparer_daemon.cpp.o" "gcc" "CMakeFiles/comparer_daemon.dir/src/comparer_daemon.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/comparer/build/CMakeFiles/tree_comparer.dir/DependInfo.cmake"
+  "/root/repo/comparer/build/CMakeFiles/tree.dir/DependInfo.cmake"
+  "/root/repo/comparer/build/CMakeFiles/utils.dir/DependInfo.cmake"
+  "/root/repo/comparer/build/CMakeFiles/thread_pool.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/comparer_daemon.dir/src/comparer_daemon.cpp.o"
+  "CMakeFiles/comparer_daemon.dir/src/comparer_daemon.cpp.o.d"
+  "libcomparer_daemon.a"
+  "libcomparer_daemon.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/comparer_daemon.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
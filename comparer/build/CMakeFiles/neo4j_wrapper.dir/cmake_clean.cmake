@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/neo4j_wrapper.dir/src/neo4j_database_wrapper.cpp.o"
+  "CMakeFiles/neo4j_wrapper.dir/src/neo4j_database_wrapper.cpp.o.d"
+  "libneo4j_wrapper.a"
+  "libneo4j_wrapper.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/neo4j_wrapper.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libneo4j_wrapper.a"
+)
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_pool.dir/src/thread_pool.cpp.o"
+  "CMakeFiles/thread_pool.dir/src/thread_pool.cpp.o.d"
+  "libthread_pool.a"
+  "libthread_pool.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/thread_pool.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/comparer/src/decompressing_stream.cpp" "CMakeFiles/tree.dir/src/decompressing_stream.cpp.o" "gcc" "CMakeFiles/tree.dir/src/decompressing_stream.cpp.o.d"
+  "/root/repo/comparer/src/mapped_file.cpp" "CMakeFiles/tree.dir/src/mapped_file.cpp.o" "gcc" "CMakeFiles/tree.dir/src/mapped_file.cpp.o.d"
+  "/root/repo/comparer/src/node_arena.cpp" "CMakeFiles/tree.dir/src/node_arena.cpp.o" "gcc" "CMakeFiles/tree.dir/src/node_arena.cpp.o.d"
+  "/root/repo/comparer/src/tree.cpp" "CMakeFiles/tree.dir/src/tree.cpp.o" "gcc" "CMakeFiles/tree.dir/src/tree.cpp.o.d"
+  "/root/repo/comparer/src/tree_layout.cpp" "CMakeFiles/tree.dir/src/tree_layout.cpp.o" "gcc" "CMakeFiles/tree.dir/src/tree_layout.cpp.o.d"
+  "/root/repo/comparer/src/tree_snapshot.cpp" "CMakeFiles/tree.dir/src/tree_snapshot.cpp.o" "gcc" "CMakeFiles/tree.dir/src/tree_snapshot.cpp.o.d"
+  "/root/repo/comparer/src/tree_spill.cpp" "CMakeFiles/tree.dir/src/tree_spill.cpp.o" "gcc" "CMakeFiles/tree.dir/src/tree_spill.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/comparer/build/CMakeFiles/thread_pool.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tree.dir/src/decompressing_stream.cpp.o"
+  "CMakeFiles/tree.dir/src/decompressing_stream.cpp.o.d"
+  "CMakeFiles/tree.dir/src/mapped_file.cpp.o"
+  "CMakeFiles/tree.dir/src/mapped_file.cpp.o.d"
+  "CMakeFiles/tree.dir/src/node_arena.cpp.o"
+  "CMakeFiles/tree.dir/src/node_arena.cpp.o.d"
+  "CMakeFiles/tree.dir/src/tree.cpp.o"
+  "CMakeFiles/tree.dir/src/tree.cpp.o.d"
+  "CMakeFiles/tree.dir/src/tree_layout.cpp.o"
+  "CMakeFiles/tree.dir/src/tree_layout.cpp.o.d"
+  "CMakeFiles/tree.dir/src/tree_snapshot.cpp.o"
+  "CMakeFiles/tree.dir/src/tree_snapshot.cpp.o.d"
+  "CMakeFiles/tree.dir/src/tree_spill.cpp.o"
+  "CMakeFiles/tree.dir/src/tree_spill.cpp.o.d"
+  "libtree.a"
+  "libtree.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tree.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/comparer/src/counting_database_wrapper.cpp" "CMakeFiles/tree_comparer.dir/src/counting_database_wrapper.cpp.o" "gcc" "CMakeFiles/tree_comparer.dir/src/counting_database_wrapper.cpp.o.d"
+  "/root/repo/comparer/src/csv_import_writer.cpp" "CMakeFiles/tree_comparer.dir/src/csv_import_writer.cpp.o" "gcc" "CMakeFiles/tree_comparer.dir/src/csv_import_writer.cpp.o.d"
+  "/root/repo/comparer/src/decl_join.cpp" "CMakeFiles/tree_comparer.dir/src/decl_join.cpp.o" "gcc" "CMakeFiles/tree_comparer.dir/src/decl_join.cpp.o.d"
+  "/root/repo/comparer/src/difference_buffer.cpp" "CMakeFiles/tree_comparer.dir/src/difference_buffer.cpp.o" "gcc" "CMakeFiles/tree_comparer.dir/src/difference_buffer.cpp.o.d"
+  "/root/repo/comparer/src/tree_comparer.cpp" "CMakeFiles/tree_comparer.dir/src/tree_comparer.cpp.o" "gcc" "CMakeFiles/tree_comparer.dir/src/tree_comparer.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/comparer/build/CMakeFiles/thread_pool.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tree_comparer.dir/src/counting_database_wrapper.cpp.o"
+  "CMakeFiles/tree_comparer.dir/src/counting_database_wrapper.cpp.o.d"
+  "CMakeFiles/tree_comparer.dir/src/csv_import_writer.cpp.o"
+  "CMakeFiles/tree_comparer.dir/src/csv_import_writer.cpp.o.d"
+  "CMakeFiles/tree_comparer.dir/src/decl_join.cpp.o"
+  "CMakeFiles/tree_comparer.dir/src/decl_join.cpp.o.d"
+  "CMakeFiles/tree_comparer.dir/src/difference_buffer.cpp.o"
+  "CMakeFiles/tree_comparer.dir/src/difference_buffer.cpp.o.d"
+  "CMakeFiles/tree_comparer.dir/src/tree_comparer.cpp.o"
+  "CMakeFiles/tree_comparer.dir/src/tree_comparer.cpp.o.d"
+  "libtree_comparer.a"
+  "libtree_comparer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tree_comparer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/comparer/src/batch_scheduler.cpp" "CMakeFiles/utils.dir/src/batch_scheduler.cpp.o" "gcc" "CMakeFiles/utils.dir/src/batch_scheduler.cpp.o.d"
+  "/root/repo/comparer/src/interned_string.cpp" "CMakeFiles/utils.dir/src/interned_string.cpp.o" "gcc" "CMakeFiles/utils.dir/src/interned_string.cpp.o.d"
+  "/root/repo/comparer/src/json_writer.cpp" "CMakeFiles/utils.dir/src/json_writer.cpp.o" "gcc" "CMakeFiles/utils.dir/src/json_writer.cpp.o.d"
+  "/root/repo/comparer/src/neo4j_node_ids.cpp" "CMakeFiles/utils.dir/src/neo4j_node_ids.cpp.o" "gcc" "CMakeFiles/utils.dir/src/neo4j_node_ids.cpp.o.d"
+  "/root/repo/comparer/src/utils.cpp" "CMakeFiles/utils.dir/src/utils.cpp.o" "gcc" "CMakeFiles/utils.dir/src/utils.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/utils.dir/src/batch_scheduler.cpp.o"
+  "CMakeFiles/utils.dir/src/batch_scheduler.cpp.o.d"
+  "CMakeFiles/utils.dir/src/interned_string.cpp.o"
+  "CMakeFiles/utils.dir/src/interned_string.cpp.o.d"
+  "CMakeFiles/utils.dir/src/json_writer.cpp.o"
+  "CMakeFiles/utils.dir/src/json_writer.cpp.o.d"
+  "CMakeFiles/utils.dir/src/neo4j_node_ids.cpp.o"
+  "CMakeFiles/utils.dir/src/neo4j_node_ids.cpp.o.d"
+  "CMakeFiles/utils.dir/src/utils.cpp.o"
+  "CMakeFiles/utils.dir/src/utils.cpp.o.d"
+  "libutils.a"
+  "libutils.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/utils.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,61 @@
+#ifndef _BATCH_COMPARER_H_
+
+#define _BATCH_COMPARER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "tree.h"
+#include "idatabase_wrapper.h"
+
+// Compares many pairs of dumps in one process. The pairs are loaded and compared on a bounded thread pool, a pair is only
+// started while the estimated memory of the running pairs stays below the limit, a pair above the limit alone runs when no
+// other pair is running. Every pair is compared into its own buffer, the differences are written to the one shared writer
+// under a lock, the pair at a time, named by beginComparison.
+class BatchComparer {
+public:
+    using TreeLoader = std::function<std::unique_ptr<Tree>(const std::string&)>;
+    using Pair = std::pair<std::string, std::string>;
+
+    struct Options {
+        unsigned int threadCount = 0;                            // pairs compared at the same time, 0 for all hardware threads
+        size_t memoryLimit = 0;                                  // bytes of the trees of the running pairs, 0 for no limit
+        std::function<size_t(const std::string&)> estimateMemory = estimateTreeMemory; // bytes of the tree of a dump
+    };
+
+    struct Report {
+        size_t pairs = 0;
+        size_t failed = 0;                                       // pairs that could not be loaded or compared
+        uint64_t differences = 0;                                // nodes and relationships written
+        double seconds = 0;
+
+        double getPairsPerMinute() const;
+    };
+
+    BatchComparer(IDatabaseWrapper&, TreeLoader, Options);
+
+    Report run(const std::vector<Pair>&);
+    static std::vector<Pair> readManifest(const std::string&);
+    static size_t estimateTreeMemory(const std::string&);
+
+private:
+    IDatabaseWrapper& writer;
+    TreeLoader loadTree;
+    Options options;
+
+    std::mutex writerMutex;                                      // guards the writer and the report
+    std::mutex memoryMutex;
+    std::condition_variable memoryReleased;
+    size_t memoryInUse = 0;                                      // estimated bytes of the running pairs
+
+    void comparePair(const Pair&, Report&);
+    void acquireMemory(size_t);
+    void releaseMemory(size_t);
+};
+
+#endif
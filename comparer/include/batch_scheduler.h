@@ -0,0 +1,56 @@
+#ifndef _BATCH_SCHEDULER_H_
+
+#define _BATCH_SCHEDULER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// Bounded queue between the comparison, which fills batches of nodes and relationships, and the writer threads sending them.
+// Node batches can be taken in any order and finish out of order. A relationship batch is only handed out once all node
+// batches submitted before it have finished, because its relationships match nodes of these batches. Submitting waits while
+// the queue is full, draining waits until every submitted batch has finished, and after stop() the writers still get the
+// queued batches before take() returns false. The buffers of finished batches are handed back by submit for the next batches.
+class BatchScheduler {
+public:
+    // a batch holds either nodes or relationships, serialized as the comma separated elements of a JSON array
+    struct Batch {
+        std::string nodes;
+        std::string relationships;
+        uint64_t nodeBatchIndex = 0;     // index of a node batch, number of node batches a relationship batch waits for
+    };
+
+    BatchScheduler(size_t maxQueuedBatches);
+
+    BatchScheduler(const BatchScheduler&) = delete;
+    BatchScheduler& operator=(const BatchScheduler&) = delete;
+
+    std::string submitNodes(std::string&&);
+    std::string submitRelationships(std::string&&);
+    bool take(Batch&);
+    void finish(Batch&);
+    void drain();
+    void stop();
+
+private:
+    size_t maxQueuedBatches;             // full batches waiting for the writers, submitting waits beyond that
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<Batch> queuedBatches;     // batches in the order they were submitted
+    std::vector<std::string> spareBuffers; // buffers of finished batches, reused for the next batches
+    size_t activeWrites = 0;             // batches taken from the queue and not finished yet
+    uint64_t submittedNodeBatches = 0;
+    uint64_t finishedNodeBatches = 0;    // the node batches before this index are finished
+    std::set<uint64_t> finishedLaterNodeBatches; // node batches that finished before an earlier one
+    bool isStopping = false;
+
+    std::string queueBatch(Batch&&);
+    std::deque<Batch>::iterator findReadyBatch();
+};
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef _BINARY_DUMP_H_
+
+#define _BINARY_DUMP_H_
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Binary AST dump, written by the dump tool and read by the comparer. The file starts with a fixed size header:
+//
+//     magic "ASTB" | version (uint32, little endian) | node count (uint64, little endian, 0 if unknown)
+//
+// followed by one record per node in preorder:
+//
+//     depth (varint) | type (byte) | kind, usr, path (string references) | line (varint) | column (varint) | flags (byte)
+//
+// A string reference is the varint id of an already defined string, or 0 followed by the varint length and the bytes of a
+// new string, which gets the next id starting from 1. The string table is built while writing, so the dump can be streamed.
+namespace BinaryDump {
+    const char magic[4] = {'A', 'S', 'T', 'B'};
+    const uint32_t version = 1;
+    const size_t headerSize = 16;
+    const size_t nodeCountOffset = 8;
+
+    const uint8_t declarationType = 0;
+    const uint8_t statementType = 1;
+    const uint8_t implicitFlag = 1;
+
+    struct Record {
+        uint32_t depth = 0;
+        uint8_t type = declarationType;
+        uint32_t kind = 0;               // Index in the string table of the reader
+        uint32_t usr = 0;
+        uint32_t path = 0;
+        uint32_t lineNumber = 0;
+        uint32_t columnNumber = 0;
+        uint8_t flags = 0;
+    };
+
+    /*
+    Description:
+        Checks if the contents start with the header of a binary dump.
+    */
+    inline bool isBinaryDump(std::string_view contents) {
+        return contents.size() >= sizeof(magic) && std::memcmp(contents.data(), magic, sizeof(magic)) == 0;
+    }
+
+    class Writer {
+    public:
+        explicit Writer(std::ostream& output) : output(output) {}
+
+        /*
+        Description:
+            Writes the header, the node count is filled in by finish() when the output is seekable.
+        */
+        void writeHeader() {
+            buffer.append(magic, sizeof(magic));
+            writeFixed(version, 4);
+            writeFixed(0, 8);
+        }
+
+        /*
+        Description:
+            Writes one node, nodes have to be written in preorder.
+        */
+        void writeNode(uint32_t depth, uint8_t type, std::string_view kind, std::string_view usr, std::string_view path,
+                       uint32_t lineNumber, uint32_t columnNumber, uint8_t flags = 0) {
+            writeVarint(depth);
+            buffer.push_back(static_cast<char>(type));
+            writeString(kind);
+            writeString(usr);
+            writeString(path);
+            writeVarint(lineNumber);
+            writeVarint(columnNumber);
+            buffer.push_back(static_cast<char>(flags));
+            ++nodeCount;
+
+            if (buffer.size() >= flushSize) {
+                flush();
+            }
+        }
+
+        /*
+        Description:
+            Writes the buffered records and patches the node count of the header if the output supports seeking.
+        */
+        void finish() {
+            flush();
+
+            std::ostream::pos_type end = output.tellp();
+            if (end == std::ostream::pos_type(-1)) {
+                return;
+            }
+
+            output.seekp(nodeCountOffset);
+            writeFixed(nodeCount, 8);
+            flush();
+            output.seekp(end);
+        }
+
+        uint64_t getNodeCount() const {
+            return nodeCount;
+        }
+
+    private:
+        static const size_t flushSize = 1 << 16;
+
+        std::ostream& output;
+        std::string buffer;
+        std::deque<std::string> stringStorage;                      // keys of stringIds point into it
+        std::unordered_map<std::string_view, uint32_t> stringIds;
+        uint64_t nodeCount = 0;
+
+        void flush() {
+            output.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+
+        void writeFixed(uint64_t value, int byteCount) {
+            for (int i = 0; i < byteCount; ++i) {
+                buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+            }
+        }
+
+        void writeVarint(uint64_t value) {
+            while (value >= 0x80) {
+                buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+            buffer.push_back(static_cast<char>(value));
+        }
+
+        void writeString(std::string_view value) {
+            auto it = stringIds.find(value);
+            if (it != stringIds.end()) {
+                writeVarint(it->second);
+                return;
+            }
+
+            stringStorage.emplace_back(value);
+            stringIds.emplace(stringStorage.back(), static_cast<uint32_t>(stringIds.size() + 1));
+
+            writeVarint(0);
+            writeVarint(value.size());
+            buffer.append(value.data(), value.size());
+        }
+    };
+
+    class Reader {
+    public:
+        Reader() = default;
+
+        /*
+        Description:
+            Reads a complete dump, throws if it is not a binary dump of a supported version.
+        */
+        explicit Reader(std::string_view contents) {
+            setContents(contents, true);
+        }
+
+        /*
+        Description:
+            Sets the next part of the dump when it is read in blocks, the bytes of the previous part after getPosition() have
+            to be repeated at the start of the new one. The header is read from the first part.
+        */
+        void setContents(std::string_view newContents, bool isLastPart) {
+            contents = newContents;
+            position = 0;
+            isLast = isLastPart;
+
+            if (isHeaderRead) {
+                return;
+            }
+            if (contents.size() < headerSize) {
+                if (isLast) {
+                    throw std::runtime_error("Invalid binary dump header.");
+                }
+                return;
+            }
+            if (!isBinaryDump(contents)) {
+                throw std::runtime_error("Invalid binary dump header.");
+            }
+
+            uint32_t fileVersion = static_cast<uint32_t>(readFixed(sizeof(magic), 4));
+            if (fileVersion != version) {
+                throw std::runtime_error("Unsupported binary dump version: " + std::to_string(fileVersion));
+            }
+            nodeCount = readFixed(nodeCountOffset, 8);
+
+            strings.emplace_back(); // id 0 is the marker of a new string
+            position = headerSize;
+            isHeaderRead = true;
+        }
+
+        /*
+        Description:
+            Reads the next record, returns false when the current contents hold no further complete record. A record cut off 
+            at the end of the last part is an error.
+        */
+        bool readNode(Record& record) {
+            if (!isHeaderRead || position == contents.size()) {
+                return false;
+            }
+
+            size_t recordStart = position;
+            size_t stringCount = strings.size();
+            isTruncated = false;
+
+            record.depth = static_cast<uint32_t>(readVarint());
+            record.type = readByte();
+            record.kind = readString();
+            record.usr = readString();
+            record.path = readString();
+            record.lineNumber = static_cast<uint32_t>(readVarint());
+            record.columnNumber = static_cast<uint32_t>(readVarint());
+            record.flags = readByte();
+
+            if (isTruncated) {
+                if (isLast) {
+                    throw std::runtime_error("Unexpected end of the binary dump.");
+                }
+                position = recordStart;
+                strings.resize(stringCount);
+                return false;
+            }
+            return true;
+        }
+
+        size_t getPosition() const {
+            return position;
+        }
+
+        uint64_t getNodeCount() const {
+            return nodeCount;
+        }
+
+        size_t getStringCount() const {
+            return strings.size();
+        }
+
+        /*
+        Description:
+            Returns a string of the table, the view points into the contents the string was read from. When the dump is read
+            in parts, strings have to be copied before the part that defined them is released.
+        */
+        std::string_view getString(uint32_t id) const {
+            return strings[id];
+        }
+
+    private:
+        std::string_view contents;
+        size_t position = 0;
+        bool isLast = false;
+        bool isHeaderRead = false;
+        bool isTruncated = false;
+        uint64_t nodeCount = 0;
+        std::vector<std::string_view> strings;
+
+        uint64_t readFixed(size_t offset, int byteCount) const {
+            uint64_t value = 0;
+            for (int i = 0; i < byteCount; ++i) {
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(contents[offset + i])) << (8 * i);
+            }
+            return value;
+        }
+
+        uint8_t readByte() {
+            if (position >= contents.size()) {
+                isTruncated = true;
+                return 0;
+            }
+            return static_cast<uint8_t>(contents[position++]);
+        }
+
+        uint64_t readVarint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                uint8_t byte = readByte();
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("Invalid varint in the binary dump.");
+        }
+
+        uint32_t readString() {
+            uint64_t id = readVarint();
+            if (isTruncated) {
+                return 0;
+            }
+            if (id != 0) {
+                if (id >= strings.size()) {
+                    throw std::runtime_error("Invalid string reference in the binary dump: " + std::to_string(id));
+                }
+                return static_cast<uint32_t>(id);
+            }
+
+            uint64_t length = readVarint();
+            if (isTruncated || length > contents.size() - position) {
+                isTruncated = true;
+                return 0;
+            }
+            strings.push_back(contents.substr(position, length));
+            position += length;
+            return static_cast<uint32_t>(strings.size() - 1);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef _COMPARER_DAEMON_H_
+
+#define _COMPARER_DAEMON_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "tree.h"
+#include "idatabase_wrapper.h"
+
+// Long running comparer that keeps baseline trees and the database connection resident. Clients connect to a Unix socket
+// and send one request per line, every request is answered with one line:
+//
+//     compare <TAB> baseline <TAB> candidate    ok <TAB> nodes=N <TAB> relationships=N <TAB> TYPE:AST=N ... <TAB> load_ms=N <TAB> compare_ms=N
+//     load <TAB> baseline                       ok <TAB> nodes=N
+//     unload <TAB> baseline                     ok
+//     status                                    ok <TAB> baselines=N
+//     shutdown                                  ok, the daemon stops after the answer
+//
+// Failed requests are answered with error <TAB> message. A baseline is loaded on its first request and kept until it is
+// unloaded, the candidate is loaded for its request only. A comparison does not change the trees, so a resident baseline is
+// compared with any number of candidates. The requests are served one at a time, they share the database connection. A
+// client that sends no complete request or does not take its answer within the client timeout is disconnected, so an idle
+// or hung client cannot block the others.
+class ComparerDaemon {
+public:
+    using TreeLoader = std::function<std::unique_ptr<Tree>(const std::string&)>;
+
+    ComparerDaemon(const std::string&, IDatabaseWrapper&, TreeLoader, unsigned int threadCount = 0, unsigned int clientTimeoutMs = 30000);
+
+    Tree& loadBaseline(const std::string&);
+    void run();
+    std::string handleRequest(const std::string&);
+    bool isStopping() const;
+
+private:
+    std::string socketPath;
+    IDatabaseWrapper& dbWrapper;
+    TreeLoader loadTree;
+    unsigned int threadCount;                                        // threads of a comparison, 0 for all hardware threads
+    unsigned int clientTimeoutMs;                                    // longest wait for a client to send or receive
+    std::unordered_map<std::string, std::unique_ptr<Tree>> baselines; // resident baselines by the path of their dump
+    bool stopRequested = false;
+
+    std::string compare(const std::string&, const std::string&);
+    void serveClient(int);
+    static bool writeLine(int, const std::string&);
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef _COUNTING_DATABASE_WRAPPER_H_
+
+#define _COUNTING_DATABASE_WRAPPER_H_
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include "node.h"
+#include "idatabase_wrapper.h"
+
+// Database wrapper that counts the differences of a comparison by difference type and AST, and the relationships. The calls
+// are passed on to the next wrapper when there is one, so the counts can summarize a comparison that is written elsewhere.
+class CountingDatabaseWrapper : public IDatabaseWrapper {
+public:
+    CountingDatabaseWrapper(IDatabaseWrapper* next = nullptr);
+
+    void addNodeToBatch(const Node&, bool, const std::string&, const std::string&) override;
+    void addRelationshipToBatch(const Node&, const Node&) override;
+    void finalize() override;
+    void createIndices() override;
+    void clearDatabase() override;
+    void beginComparison(const std::string&) override;
+
+    size_t getNodeCount() const;
+    size_t getNodeCount(const std::string&, const std::string&) const;
+    size_t getRelationshipCount() const;
+    const std::map<std::pair<std::string, std::string>, size_t>& getNodeCounts() const;
+    void reset();
+    void printSummary(std::ostream&) const;
+
+private:
+    IDatabaseWrapper* next;
+    std::map<std::pair<std::string, std::string>, size_t> nodeCounts;   // nodes by difference type and AST
+    size_t nodeCount = 0;
+    size_t relationshipCount = 0;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef _CSV_IMPORT_WRITER_H_
+
+#define _CSV_IMPORT_WRITER_H_
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "node.h"
+#include "idatabase_wrapper.h"
+#include "neo4j_node_ids.h"
+
+// Database wrapper that writes the differences as CSV files for the offline import of neo4j-admin instead of sending them to
+// a database. The nodes and the HAS_CHILD relationships are streamed into part files of at most the given size, the column
+// headers are in separate header files, and the nodes have the same integer ids as written by Neo4jDatabaseWrapper. Every
+// finalize writes import.args with the options of `neo4j-admin database import full` for all parts, createIndices writes the
+// constraint and indices to schema.cypher, to be run after the import. Only the current row and a bit per written node
+// are kept in memory, every id is written once and relationships only connect written nodes, as the import requires.
+class CsvImportWriter : public IDatabaseWrapper {
+public:
+    CsvImportWriter(const std::string&, size_t maxPartBytes = size_t(1) << 30);
+
+    void addNodeToBatch(const Node&, bool, const std::string&, const std::string&) override;
+    void addRelationshipToBatch(const Node&, const Node&) override;
+    void finalize() override;
+    void createIndices() override;
+    void clearDatabase() override;
+    void beginComparison(const std::string&) override;
+
+    const std::vector<std::string>& getNodeFiles() const;
+    const std::vector<std::string>& getRelationshipFiles() const;
+
+private:
+    // the part files of nodes or relationships, the first file is the header
+    struct PartFiles {
+        std::string name;
+        std::vector<std::string> files;
+        std::ofstream out;
+        size_t partBytes = 0;            // bytes written to the current part
+    };
+
+    std::string directory;
+    size_t maxPartBytes;
+    std::string comparison;
+    Neo4jNodeIds nodeIds;
+    PartFiles nodeFiles;
+    PartFiles relationshipFiles;
+    std::string row;                     // row being written, reused for every row
+
+    void writeHeader(PartFiles&, const std::string&);
+    void writeRow(PartFiles&);
+    std::string getPath(const std::string&) const;
+    static void appendField(std::string&, std::string_view);
+};
+
+#endif
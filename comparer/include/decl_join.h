@@ -0,0 +1,48 @@
+#ifndef _DECL_JOIN_H_
+
+#define _DECL_JOIN_H_
+
+#include <cstdint>
+#include <vector>
+#include "enums.h"
+#include "flat_index.h"
+#include "tree.h"
+
+// Declarations of two in-memory trees matched by their key before the traversal. The runs of the declaration indices of
+// both trees are radix partitioned by their key, every partition is small enough for a cache resident hash table and is
+// joined on its own, the partitions are joined in parallel. The traversal then finds the declarations with the same key in
+// the other tree with two array reads instead of hashing the key.
+class DeclJoin {
+public:
+    static constexpr uint32_t noRun = 0xffffffffu;
+
+    DeclJoin(const Tree&, const Tree&, unsigned int threadCount = 1);
+
+    uint32_t getRun(ASTId, uint32_t) const;
+    uint32_t getPartnerRun(ASTId, uint32_t) const;
+    size_t getMatchedKeyCount() const;
+
+private:
+    struct KeyRun {
+        uint32_t key;                    // Interned id of the key
+        uint32_t run;                    // Run of the key in the declaration index of its tree
+    };
+
+    struct Partitions {
+        std::vector<KeyRun> entries;     // Runs grouped by partition
+        std::vector<size_t> starts;      // Start of every partition in entries, one more entry than partitions
+        int bits = 0;                    // Top bits of the spread key that select the partition
+    };
+
+    std::vector<uint32_t> nodeRuns[2];    // Run of every declaration by preorder index, noRun for statements
+    std::vector<uint32_t> partnerRuns[2]; // Run with the same key in the other tree by run, noRun if the key is missing
+    size_t matchedKeyCount = 0;           // Keys declared in both trees
+
+    template<typename Function>
+    static void runTasks(size_t, size_t, Function&&);
+    static Partitions partition(const DeclNodeIndex&, int, size_t);
+    void assignNodeRuns(const Tree&, ASTId, size_t);
+    size_t joinPartitions(const Partitions&, const Partitions&, size_t, size_t);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef _DECOMPRESSING_STREAM_H_
+
+#define _DECOMPRESSING_STREAM_H_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Decompresses a gzip or zstd compressed dump on a background thread, the decompressed contents are handed over in blocks,
+// so the dump can be parsed while the rest of it is still being decompressed.
+class DecompressingStream {
+public:
+    enum Codec {
+        NONE,
+        GZIP,
+        ZSTD
+    };
+
+    DecompressingStream(std::string_view, Codec);
+    ~DecompressingStream();
+
+    DecompressingStream(const DecompressingStream&) = delete;
+    DecompressingStream& operator=(const DecompressingStream&) = delete;
+
+    bool next(std::string&);
+
+    static Codec detectCodec(std::string_view);
+    static bool isCodecAvailable(Codec);
+
+private:
+    static const size_t blockSize = 1 << 20;     // size of the decompressed blocks
+    static const size_t maxQueuedBlocks = 8;     // blocks decompressed ahead of the parser
+
+    std::string_view input;
+    Codec codec;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::string> blocks;
+    std::exception_ptr error;
+    bool isFinished = false;
+    bool isCancelled = false;
+
+    void decompress();
+    void decompressGzip();
+    void decompressZstd();
+    bool pushBlock(std::string&);
+};
+
+#endif
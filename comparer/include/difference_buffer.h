@@ -0,0 +1,48 @@
+#ifndef _DIFFERENCE_BUFFER_H_
+
+#define _DIFFERENCE_BUFFER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "node.h"
+#include "idatabase_wrapper.h"
+
+// Database wrapper that records the differences of a comparison thread instead of writing them. The differences are grouped
+// into steps of the traversal, every step is tagged with its position in the sequential traversal, so the buffers of all
+// threads can be replayed into the real wrapper in the order of a sequential comparison.
+class DifferenceBuffer : public IDatabaseWrapper {
+public:
+    void beginStep(uint64_t);
+
+    void addNodeToBatch(const Node&, bool, const std::string&, const std::string&) override;
+    void addRelationshipToBatch(const Node&, const Node&) override;
+    void finalize() override {}
+    void createIndices() override {}
+    void clearDatabase() override {}
+
+    size_t size() const;
+    static void replay(const std::vector<DifferenceBuffer>&, IDatabaseWrapper&);
+
+private:
+    struct Entry {
+        const Node* node;                // Node of the difference, parent of a relationship
+        const Node* child;               // Child of a relationship, nullptr for a node
+        uint8_t differenceType;          // Index in labels
+        uint8_t astOrigin;
+        bool isHighLevel;
+    };
+
+    struct Step {
+        uint64_t order;                  // Position of the step in the sequential traversal
+        size_t firstEntry;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<Step> steps;
+    std::vector<std::string> labels;     // Difference types and AST names, only a handful of distinct values
+
+    uint8_t getLabel(const std::string&);
+};
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef _FLAT_INDEX_H_
+
+#define _FLAT_INDEX_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "node.h"
+
+// Read-only index from 32-bit keys to runs of values, built once from all values. The keys are stored in an open-addressing
+// table with linear probing, the values of a key form a contiguous run in insertion order, so a lookup touches one slot and
+// a range of one array instead of a chain of allocated nodes. The table is presized from the expected number of keys and kept
+// at most half full.
+template<typename Value>
+class FlatIndex {
+public:
+    using value_type = Value;
+    using const_iterator = typename std::vector<Value>::const_iterator;
+
+    template<typename Function>
+    void build(size_t, Function&&);
+
+    std::pair<const_iterator, const_iterator> equal_range(uint32_t) const;
+    size_t count(uint32_t) const;
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+    size_t keyCount() const { return runKeys.size(); }
+    uint32_t getRunKey(uint32_t run) const { return runKeys[run]; }
+    std::pair<const_iterator, const_iterator> getRun(uint32_t) const;
+    const_iterator begin() const { return values.begin(); }
+    const_iterator end() const { return values.end(); }
+
+    template<typename Function>
+    void forEachRun(Function&&) const;
+
+private:
+    static constexpr uint32_t emptyKey = 0xffffffffu;
+
+    struct Slot {
+        uint32_t key;                    // Key of the slot, emptyKey for a free slot
+        uint32_t run;                    // Run of the values of the key
+    };
+
+    std::vector<Slot> slots;             // Power of two slots
+    std::vector<uint32_t> runKeys;       // Key of every run, in order of first insertion
+    std::vector<uint32_t> runStarts;     // Start of every run in values, one more entry than runs
+    std::vector<Value> values;           // Values grouped by run
+    int shift = 64;                      // 64 - log2 of the slot count
+
+    size_t findSlot(uint32_t) const;
+    void resize(size_t);
+};
+
+// Declarations by their interned key, the interface follows the multimap it replaced
+class DeclNodeIndex : public FlatIndex<std::pair<InternedString, Node*>> {
+public:
+    std::pair<const_iterator, const_iterator> equal_range(const InternedString& key) const {
+        return FlatIndex::equal_range(key.id());
+    }
+    size_t count(const InternedString& key) const {
+        return FlatIndex::count(key.id());
+    }
+};
+
+/*
+Description:
+    Builds the index, the function is called twice with a callback taking a key and a value, and has to pass the same values
+    in the same order both times: first the runs are counted, then the values are placed. The expected key count sizes the
+    table, the table grows if it is too small.
+*/
+template<typename Value>
+template<typename Function>
+void FlatIndex<Value>::build(size_t expectedKeyCount, Function&& forEachValue) {
+    runKeys.clear();
+    runStarts.clear();
+    values.clear();
+    resize(expectedKeyCount);
+
+    std::vector<uint32_t> runSizes;
+    forEachValue([this, &runSizes](uint32_t key, const Value&) {
+        if ((runKeys.size() + 1) * 2 > slots.size()) {
+            resize(slots.size());
+        }
+
+        Slot& slot = slots[findSlot(key)];
+        if (slot.key == emptyKey) {
+            slot = {key, static_cast<uint32_t>(runKeys.size())};
+            runKeys.push_back(key);
+            runSizes.push_back(0);
+        }
+        ++runSizes[slot.run];
+    });
+
+    runStarts.resize(runKeys.size() + 1, 0);
+    for (size_t run = 0; run < runKeys.size(); ++run) {
+        runStarts[run + 1] = runStarts[run] + runSizes[run];
+    }
+
+    values.resize(runStarts.back());
+    std::vector<uint32_t>& positions = runSizes;
+    positions.assign(runStarts.begin(), runStarts.end() - 1);
+    forEachValue([this, &positions](uint32_t key, const Value& value) {
+        values[positions[slots[findSlot(key)].run]++] = value;
+    });
+}
+
+/*
+Description:
+    Returns the run of values of the key, an empty range if the key is not in the index.
+*/
+template<typename Value>
+std::pair<typename FlatIndex<Value>::const_iterator, typename FlatIndex<Value>::const_iterator> FlatIndex<Value>::equal_range(uint32_t key) const {
+    if (slots.empty() || key == emptyKey) {
+        return {values.end(), values.end()};
+    }
+
+    const Slot& slot = slots[findSlot(key)];
+    if (slot.key == emptyKey) {
+        return {values.end(), values.end()};
+    }
+    return {values.begin() + runStarts[slot.run], values.begin() + runStarts[slot.run + 1]};
+}
+
+/*
+Description:
+    Returns the values of a run by its position in the order of first insertion.
+*/
+template<typename Value>
+std::pair<typename FlatIndex<Value>::const_iterator, typename FlatIndex<Value>::const_iterator> FlatIndex<Value>::getRun(uint32_t run) const {
+    return {values.begin() + runStarts[run], values.begin() + runStarts[run + 1]};
+}
+
+/*
+Description:
+    Returns the number of values of the key.
+*/
+template<typename Value>
+size_t FlatIndex<Value>::count(uint32_t key) const {
+    auto [first, last] = equal_range(key);
+    return static_cast<size_t>(last - first);
+}
+
+/*
+Description:
+    Calls the function with the key and the range of values of every run, in order of first insertion.
+*/
+template<typename Value>
+template<typename Function>
+void FlatIndex<Value>::forEachRun(Function&& function) const {
+    for (size_t run = 0; run < runKeys.size(); ++run) {
+        function(runKeys[run], values.begin() + runStarts[run], values.begin() + runStarts[run + 1]);
+    }
+}
+
+/*
+Description:
+    Returns the slot of the key, or the free slot where it would be inserted. The key is spread by Fibonacci hashing, the
+    interned ids and preorder indices are dense, so neighbouring keys land in distant slots.
+*/
+template<typename Value>
+size_t FlatIndex<Value>::findSlot(uint32_t key) const {
+    size_t mask = slots.size() - 1;
+    size_t position = static_cast<size_t>((static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ULL) >> shift);
+    while (slots[position].key != emptyKey && slots[position].key != key) {
+        position = (position + 1) & mask;
+    }
+    return position;
+}
+
+/*
+Description:
+    Resizes the table to at least twice the given number of keys and reinserts the keys of the runs.
+*/
+template<typename Value>
+void FlatIndex<Value>::resize(size_t keyCount) {
+    size_t slotCount = 16;
+    shift = 60;
+    while (slotCount < keyCount * 2) {
+        slotCount <<= 1;
+        --shift;
+    }
+
+    slots.assign(slotCount, Slot{emptyKey, 0});
+    for (size_t run = 0; run < runKeys.size(); ++run) {
+        slots[findSlot(runKeys[run])] = {runKeys[run], static_cast<uint32_t>(run)};
+    }
+}
+
+#endif
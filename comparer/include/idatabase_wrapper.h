@@ -11,6 +11,9 @@ public:
     virtual void finalize() = 0;
     virtual void createIndices() = 0;
     virtual void clearDatabase() = 0;
+
+    // the following differences belong to the named comparison, so the differences of several comparisons can share a database
+    virtual void beginComparison(const std::string&) {}
 };
 
 #endif
\ No newline at end of file
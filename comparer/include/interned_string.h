@@ -0,0 +1,78 @@
+#ifndef _INTERNED_STRING_H_
+
+#define _INTERNED_STRING_H_
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Handle to a string stored once in the process wide intern pool, equal strings share the same entry, so comparing two
+// handles is a pointer comparison. Interned entries are never freed, the handles stay valid for the lifetime of the process.
+// Entries taken with acquire() are reference counted instead and freed by the last release(), unless the same string was
+// interned permanently in the meantime. They back the nodes of the trees, which release them when the tree is deleted or
+// the page of an out-of-core tree is evicted, so a long running process does not keep the strings of every tree it loaded.
+class InternedString {
+public:
+    struct Entry {
+        std::string value;           // The interned characters
+        size_t hash;                 // Hash of the value
+        uint32_t id;                 // Dense identifier, 0 is the empty string, ids of freed entries are reused
+        uint32_t references = 0;     // Handles taken with acquire() that are not released yet
+        bool isPermanent = true;     // Interned by the constructor, never freed
+    };
+
+    InternedString();
+    InternedString(std::string_view);
+    InternedString(const std::string&);
+    InternedString(const char*);
+
+    const std::string& str() const { return entry->value; }
+    operator const std::string&() const { return entry->value; }
+    const char* c_str() const { return entry->value.c_str(); }
+    size_t size() const { return entry->value.size(); }
+    bool empty() const { return entry->value.empty(); }
+    size_t hash() const { return entry->hash; }
+    uint32_t id() const { return entry->id; }
+
+    static size_t poolSize();
+    static void reservePool(size_t);
+    static InternedString find(std::string_view);
+    static InternedString acquire(std::string_view);
+    static void release(const InternedString&);
+
+    friend bool operator==(const InternedString& lhs, const InternedString& rhs) { return lhs.entry == rhs.entry; }
+    friend bool operator!=(const InternedString& lhs, const InternedString& rhs) { return lhs.entry != rhs.entry; }
+    friend bool operator==(const InternedString& lhs, const std::string& rhs) { return lhs.entry->value == rhs; }
+    friend bool operator!=(const InternedString& lhs, const std::string& rhs) { return lhs.entry->value != rhs; }
+    friend bool operator==(const std::string& lhs, const InternedString& rhs) { return rhs == lhs; }
+    friend bool operator!=(const std::string& lhs, const InternedString& rhs) { return rhs != lhs; }
+    friend bool operator==(const InternedString& lhs, const char* rhs) { return lhs.entry->value == rhs; }
+    friend bool operator!=(const InternedString& lhs, const char* rhs) { return lhs.entry->value != rhs; }
+    friend bool operator==(const char* lhs, const InternedString& rhs) { return rhs == lhs; }
+    friend bool operator!=(const char* lhs, const InternedString& rhs) { return rhs != lhs; }
+
+    friend std::string operator+(const InternedString& lhs, const std::string& rhs) { return lhs.str() + rhs; }
+    friend std::string operator+(const InternedString& lhs, const char* rhs) { return lhs.str() + rhs; }
+    friend std::string operator+(const std::string& lhs, const InternedString& rhs) { return lhs + rhs.str(); }
+    friend std::string operator+(const char* lhs, const InternedString& rhs) { return lhs + rhs.str(); }
+
+    friend std::ostream& operator<<(std::ostream& stream, const InternedString& string) { return stream << string.str(); }
+
+private:
+    const Entry* entry;
+
+    explicit InternedString(const Entry* entry) : entry(entry) {}
+
+    static const Entry* intern(std::string_view);
+};
+
+namespace std {
+    template<>
+    struct hash<InternedString> {
+        size_t operator()(const InternedString& string) const noexcept { return string.id(); }
+    };
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef _JSON_WRITER_H_
+
+#define _JSON_WRITER_H_
+
+#include <string>
+#include <string_view>
+
+// Appends JSON values to a string, the batches of the database are serialized straight into their request buffers instead
+// of building a document first. Strings are escaped, invalid UTF-8 is replaced with U+FFFD, so any path or USR gives valid JSON.
+class JsonWriter {
+public:
+    static void appendString(std::string&, std::string_view);
+    static void appendNumber(std::string&, long long);
+    static void appendBool(std::string&, bool);
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef _MAPPED_FILE_H_
+
+#define _MAPPED_FILE_H_
+
+#include <string>
+#include <string_view>
+
+class MappedFile {
+public:
+    MappedFile(const std::string&);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const;
+    size_t size() const;
+    std::string_view view() const;
+
+private:
+    const char* mappedData = nullptr;   // start of the read-only mapping
+    size_t mappedSize = 0;              // size of the mapping in bytes
+    std::string fallbackBuffer;         // used where mmap is not available (Windows)
+};
+
+#endif
@@ -2,17 +2,29 @@
 
 #define _NEO4J_DATABASE_WRAPPER_H_
 
+#include <atomic>
 #include <string>
 #include <curl/curl.h>
 #include <memory>
+#include <thread>
 #include <vector>
-#include <nlohmann/json.hpp>
+#include "batch_scheduler.h"
 #include "node.h"
 #include "idatabase_wrapper.h"
-
+#include "neo4j_node_ids.h"
+
+// Writes the differences to Neo4j in batches. Full batches are handed to background writer threads through a bounded queue
+// (see BatchScheduler), so the comparison fills the next batch while the previous ones are sent. Every writer has its own
+// connection, so several node batches are in flight at once. A relationship batch is only sent after all node batches
+// submitted before it have committed, because its relationships match nodes of these batches. When the queue is full the
+// comparison waits for the writers, and the synchronous requests (clearing the database, creating the indices) wait until
+// the queued batches are written.
+//
+// Every node gets a compact integer id (see Neo4jNodeIds) backed by a uniqueness constraint, so a relationship finds both of
+// its nodes with two lookups of the constraint index.
 class Neo4jDatabaseWrapper : public IDatabaseWrapper {
 public:
-    Neo4jDatabaseWrapper(const std::string&, const std::string&, const std::string&);
+    Neo4jDatabaseWrapper(const std::string&, const std::string&, const std::string&, size_t connectionCount = 4);
     ~Neo4jDatabaseWrapper() override;
 
     void addNodeToBatch(const Node&, bool, const std::string&, const std::string&) override;
@@ -20,21 +32,32 @@ public:
     void clearDatabase() override;
     void createIndices();
     void finalize() override;
+    void beginComparison(const std::string&) override;
 
 private:
-    bool isCircuitBreakerActive = false; // prevents execution if set
-    int consecutiveFailures = 0;         // counts consecutive failures
+    std::atomic<bool> isCircuitBreakerActive{false}; // prevents execution if set
+    std::atomic<int> consecutiveFailures{0};         // counts consecutive failures
     const int failureThreshold = 3;      // maximum allowed failures
+    const size_t batchSize = 3000;       // nodes or relationships of a full batch
 
     std::string dbUri;
     std::string authHeader;
+    std::string comparison;              // name of the current comparison, stored with its nodes
+    Neo4jNodeIds nodeIds;
     CURL* curl;
 
-    std::vector<nlohmann::json> nodeBatch;
-    std::vector<nlohmann::json> relationshipBatch;
+    std::string nodeBatch;               // nodes of the current batch, serialized
+    std::string relationshipBatch;       // relationships of the current batch, serialized
+    size_t nodeBatchSize = 0;
+    size_t relationshipBatchSize = 0;
+
+    BatchScheduler scheduler;            // full batches waiting for the writers
+    std::vector<std::thread> writers;
 
-    bool executeBatch();
-    bool sendRequest(const std::string&);
+    void submitBatch();
+    void writerLoop();
+    bool executeBatch(CURL*, const BatchScheduler::Batch&, std::string&);
+    bool sendRequest(CURL*, const std::string&);
 };
 
 #endif
\ No newline at end of file
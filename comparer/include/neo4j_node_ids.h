@@ -0,0 +1,42 @@
+#ifndef _NEO4J_NODE_IDS_H_
+
+#define _NEO4J_NODE_IDS_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "node.h"
+
+// Compact integer ids of the difference nodes in Neo4j, shared by the database wrapper and the import file writer. An id is
+// made of the number of the comparison, the index of the difference type and AST of the node and its topological order,
+// which is unique within a tree. The comparer adds the relationship of a subtree node right after the node and the parent
+// belongs to the same subtree, so both ends of a relationship get the difference type and AST of the last added node.
+// A node can be reported more than once with the same difference type and AST, for example a moved declaration whose
+// statements are reported by the subtree of its old parent as well. The written ids are remembered, one bit per
+// topological order for every difference type and AST, so a node is written once and a relationship only connects
+// written nodes, which an offline import requires.
+class Neo4jNodeIds {
+public:
+    bool addNode(const Node&, const std::string&, const std::string&, uint64_t&);
+    bool getRelationshipIds(const Node&, const Node&, uint64_t&, uint64_t&);
+    void beginComparison();
+    void clearWrittenNodes();
+
+    static const std::vector<std::string>& getSchemaStatements();
+
+private:
+    uint64_t comparisonNumber = 0;       // counts the comparisons, part of the ids
+    std::vector<std::pair<std::string, std::string>> labels; // difference types and ASTs, only a handful of combinations
+    const Node* lastNode = nullptr;      // node added last, the child of a following relationship
+    uint64_t lastLabel = 0;              // index of the difference type and AST of the last node in labels
+    std::vector<std::vector<uint64_t>> writtenNodes;   // bits of the written nodes by label and topological order
+    std::vector<std::vector<uint64_t>> linkedNodes;    // bits of the nodes whose parent relationship is written
+
+    uint64_t getLabel(const std::string&, const std::string&);
+    uint64_t getId(uint64_t, int) const;
+    static bool testAndSet(std::vector<uint64_t>&, int);
+    static bool isSet(const std::vector<uint64_t>&, int);
+};
+
+#endif
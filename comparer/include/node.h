@@ -2,27 +2,57 @@
 
 #define _NODE_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "enums.h"
+#include "interned_string.h"
+
+struct Node;
+
+// Children of a node, a view into the CSR arrays of the tree's layout
+struct NodeChildren {
+    const uint32_t* indices = nullptr;   // Preorder indices of the children
+    Node* const* nodes = nullptr;        // Node table of the layout, indexed by preorder index
+    size_t count = 0;                    // Number of children
+
+    class iterator {
+    public:
+        iterator(const uint32_t* index, Node* const* nodes) : index(index), nodes(nodes) {}
+        Node* operator*() const { return nodes[*index]; }
+        iterator& operator++() { ++index; return *this; }
+        bool operator==(const iterator& other) const { return index == other.index; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+    private:
+        const uint32_t* index;
+        Node* const* nodes;
+    };
+
+    iterator begin() const { return iterator(indices, nodes); }
+    iterator end() const { return iterator(indices + count, nodes); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Node* operator[](size_t position) const { return nodes[indices[position]]; }
+};
+
 struct Node {
     // Node properties
     NodeType type;                   // Declaration/Statement
-    std::string kind;                // FunctionDecl/VarDecl/IfStmt/WhileStmt/...
-    std::string usr;                 // USR
-    std::string path;                // Source file path
+    InternedString kind;             // FunctionDecl/VarDecl/IfStmt/WhileStmt/...
+    InternedString usr;              // USR
+    InternedString path;             // Source file path
     int lineNumber;                  // Which line in the source file
     int columnNumber;                // Which column in the source file
     int topologicalOrder = -1;       // Topological order of the node
 
     // Relationships
     Node* parent = nullptr;          // Parent node pointer
-    std::vector<Node*> children;     // Children of this node
+    NodeChildren children;           // Children of this node
 
     // Unique properties and flags
-    std::string enhancedKey;         // Identifier (combination of kind, usr and path)
-    size_t fingerprint = 0;          // Hashed fingerprint value of the node
-    bool isProcessed = false;        // Flag for processed nodes
+    InternedString enhancedKey;      // Identifier (combination of kind, usr and path)
+    size_t fingerprint = 0;          // Merkle hash of the node and its subtree
+    bool hasUniqueDeclKeys = false;  // Every declaration of the subtree has a key that occurs once in the tree
 };
 
-#endif
\ No newline at end of file
+#endif
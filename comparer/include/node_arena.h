@@ -0,0 +1,56 @@
+#ifndef _NODE_ARENA_H_
+
+#define _NODE_ARENA_H_
+
+#include <vector>
+#include "node.h"
+
+class NodeArena {
+public:
+    NodeArena() = default;
+    ~NodeArena();
+
+    NodeArena(NodeArena&&) noexcept;
+    NodeArena& operator=(NodeArena&&) noexcept;
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    Node* createNode();
+    void reserve(size_t);
+    void absorb(NodeArena&);
+
+    size_t size() const;
+    size_t blockCount() const;
+
+    template<typename Function>
+    void forEachNode(Function&& function) const;
+
+private:
+    static const size_t nodesPerBlock = 4096;
+
+    // raw storage for nodesPerBlock nodes, the first count of them are constructed
+    struct NodeBlock {
+        Node* nodes;
+        size_t count;
+    };
+
+    std::vector<NodeBlock> nodeBlocks;
+    size_t nodeCount = 0;
+
+    void release();
+};
+
+/*
+Description:
+    Calls the function for every node in creation order, for a parsed tree it is the preorder of the nodes.
+*/
+template<typename Function>
+void NodeArena::forEachNode(Function&& function) const {
+    for (const NodeBlock& block : nodeBlocks) {
+        for (size_t i = 0; i < block.count; ++i) {
+            function(&block.nodes[i]);
+        }
+    }
+}
+
+#endif
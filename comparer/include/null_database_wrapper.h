@@ -0,0 +1,20 @@
+#ifndef _NULL_DATABASE_WRAPPER_H_
+
+#define _NULL_DATABASE_WRAPPER_H_
+
+#include <string>
+#include "node.h"
+#include "idatabase_wrapper.h"
+
+// Database wrapper that drops every difference, a comparison against it measures the comparison alone. The calls are inline
+// no-ops, so the sink costs no more than the virtual calls of the comparer.
+class NullDatabaseWrapper : public IDatabaseWrapper {
+public:
+    void addNodeToBatch(const Node&, bool, const std::string&, const std::string&) override {}
+    void addRelationshipToBatch(const Node&, const Node&) override {}
+    void finalize() override {}
+    void createIndices() override {}
+    void clearDatabase() override {}
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef _PROCESSED_NODES_H_
+
+#define _PROCESSED_NODES_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "enums.h"
+
+// Processed flags of the nodes of both trees for one comparison, one bit per node indexed by AST and preorder index. The
+// comparison keeps its state here instead of in the nodes, so a loaded tree is never changed by a comparison and can be
+// compared any number of times. In-memory trees can also be compared by concurrent comparisons, out-of-core trees cannot,
+// their page cache changes on every access (see Tree::beginTraversal). The workers of a parallel comparison share one set, the
+// bits are set with an atomic or, because neighbouring nodes of different groups share a word. Indices outside of the trees
+// are never processed.
+class ProcessedNodes {
+public:
+    ProcessedNodes(uint32_t firstNodeCount, uint32_t secondNodeCount) {
+        nodeCounts[FIRST_AST] = firstNodeCount;
+        nodeCounts[SECOND_AST] = secondNodeCount;
+        words[FIRST_AST] = std::vector<std::atomic<uint64_t>>((firstNodeCount + 63) / 64);
+        words[SECOND_AST] = std::vector<std::atomic<uint64_t>>((secondNodeCount + 63) / 64);
+    }
+
+    bool isProcessed(ASTId ast, uint32_t index) const {
+        if (index >= nodeCounts[ast]) {
+            return false;
+        }
+        return (words[ast][index / 64].load(std::memory_order_relaxed) >> (index % 64)) & 1;
+    }
+
+    void markProcessed(ASTId ast, uint32_t index) {
+        if (index < nodeCounts[ast]) {
+            words[ast][index / 64].fetch_or(uint64_t(1) << (index % 64), std::memory_order_relaxed);
+        }
+    }
+
+    // marks the indices [first, last), whole words are set at once
+    void markRange(ASTId ast, uint32_t first, uint32_t last) {
+        last = last < nodeCounts[ast] ? last : nodeCounts[ast];
+        while (first < last) {
+            uint32_t wordEnd = (first / 64 + 1) * 64;
+            uint32_t end = last < wordEnd ? last : wordEnd;
+            uint64_t bits = end - first == 64 ? ~uint64_t(0) : ((uint64_t(1) << (end - first)) - 1) << (first % 64);
+            words[ast][first / 64].fetch_or(bits, std::memory_order_relaxed);
+            first = end;
+        }
+    }
+
+private:
+    std::vector<std::atomic<uint64_t>> words[2];     // Bits of the nodes of both ASTs
+    uint32_t nodeCounts[2];                          // Nodes of both ASTs, including the roots
+};
+
+#endif
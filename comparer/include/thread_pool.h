@@ -0,0 +1,58 @@
+#ifndef _THREAD_POOL_H_
+
+#define _THREAD_POOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template<typename Function>
+    auto submit(Function&& function) -> std::future<decltype(function())>;
+
+    size_t size() const;
+    static size_t defaultThreadCount();
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool isStopping = false;
+
+    void workerLoop();
+};
+
+/*
+Description:
+    Schedules the function on the pool, the returned future holds its result or the exception it has thrown.
+*/
+template<typename Function>
+auto ThreadPool::submit(Function&& function) -> std::future<decltype(function())> {
+    using Result = decltype(function());
+
+    // std::function needs a copyable target, the packaged task is shared instead
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+    std::future<Result> result = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.emplace([task]() { (*task)(); });
+    }
+    condition.notify_one();
+
+    return result;
+}
+
+#endif
@@ -2,36 +2,109 @@
 
 #define _TREE_H_
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <unordered_map>
 #include <unordered_set>
 #include "node.h"
+#include "node_arena.h"
+#include "flat_index.h"
+#include "tree_layout.h"
+#include "binary_dump.h"
+#include "decompressing_stream.h"
+#include "tree_snapshot.h"
+#include "tree_spill.h"
 
 class Tree {
 public:
-    Tree(const std::string&);
+    Tree(const std::string&, unsigned int threadCount = 0, const std::string& snapshotDirectory = "");
+    Tree(const std::string&, const TreeSpill::Options&);
     ~Tree();
     
     Node* getRoot() const;
-    const std::pair<std::unordered_multimap<std::string, Node*>::const_iterator,
-                    std::unordered_multimap<std::string, Node*>::const_iterator> getDeclNodes(const std::string& nodeKey) const;
+    const TreeLayout& getLayout() const;
+    const std::pair<DeclNodeIndex::const_iterator, DeclNodeIndex::const_iterator> getDeclNodes(const InternedString& nodeKey) const;
     const std::pair<std::vector<Node*>::const_iterator, std::vector<Node*>::const_iterator> getStmtNodes(const std::string& nodeKey) const;
-    const std::unordered_multimap<std::string, Node*>& getDeclNodeMultiMap() const;
+    const std::pair<std::vector<Node*>::const_iterator, std::vector<Node*>::const_iterator> getStmtNodes(const Node* declaration) const;
+    const DeclNodeIndex& getDeclNodeMultiMap() const;
     const std::unordered_map<std::string, std::vector<Node*>>& getStmtNodeMultiMap() const;
 
-    bool isDeclNodeInAST(const std::string&) const;
+    bool isDeclNodeInAST(const InternedString&) const;
     void processSubTree(Node*, std::function<void(Node*, int)>);
+
+    // access by preorder index, works for both in-memory and out-of-core trees
+    bool isOutOfCore() const;
+    uint32_t getNodeCount() const;
+    Node* getNode(uint32_t) const;
+    NodeType getNodeType(uint32_t) const;
+    std::pair<const uint32_t*, const uint32_t*> getChildIndices(uint32_t) const;
+    void releaseNodes();
+
+    // a traversal of a comparison, an out-of-core tree allows one at a time
+    void beginTraversal();
+    void endTraversal();
 private:
-    Node* root;
-    std::unordered_multimap<std::string, Node*> declNodeMultiMap;
-    std::unordered_map<std::string, std::vector<Node*>> stmtNodeMultiMap;
-
-    Node* buildTree(std::ifstream&);
-    void addStmtNodeToNodeMap(Node*, const Node*);
-    void addDeclNodeToNodeMap(Node*);
-    void deleteTree(Node*);
+    friend class TreeSnapshot;
+
+    Node* root = nullptr;
+    NodeArena nodeArena;
+    TreeLayout layout;
+    DeclNodeIndex declNodeMultiMap;                                     // declarations by their key
+    FlatIndex<Node*> stmtNodeGroups;                                    // statements by the preorder index of their declaration
+    mutable std::unordered_map<std::string, std::vector<Node*>> stmtNodeMultiMap; // statements by the string key, built on request
+    mutable std::once_flag stmtNodeMultiMapFlag;                       // builds the map once, also for concurrent requests
+    std::atomic<bool> isTraversed{false};                               // an out-of-core tree is being compared
+    std::unique_ptr<TreeSpill> spill;                                   // pages of an out-of-core tree
+    mutable DeclNodeIndex declNodeLookup;                               // result of the last lookup of an out-of-core tree
+    mutable std::vector<Node*> stmtNodeLookup;
+    std::vector<InternedString> ownedStrings;                          // acquired strings of the nodes, released with the tree
+
+    // part of the dump parsed by one thread, nodes are numbered locally until the chunks are merged
+    struct ParseChunk {
+        ParseChunk() = default;
+        ParseChunk(ParseChunk&&) = default;
+        ParseChunk& operator=(ParseChunk&&) = default;
+        ~ParseChunk();
+
+        std::string_view contents;                                      // lines of the chunk
+        NodeArena arena;                                                // nodes in preorder
+        std::vector<Node*> nodeStack;                                   // path from the root to the last node
+        int nextTopologicalOrder = 0;                                   // local order of the next node
+        std::vector<InternedString> dumpStrings;                        // string table of a binary dump
+        std::vector<std::pair<const Node*, Node*>> stmtNodes;           // statements with their declaration parent
+        std::vector<std::pair<uint32_t, std::vector<Node*>>> stmtGroups; // statements grouped by the order of the declaration
+        Node* root = nullptr;                                           // root when the chunk is the whole file
+        bool reachedRootLevel = false;                                  // found a depth 0 line after the root
+        TreeSpill* spill = nullptr;                                     // pages of an out-of-core tree
+        NodeArena rootArena;                                            // root of an out-of-core tree
+        std::vector<InternedString> acquiredStrings;                    // strings of the chunk, or of the current page of an out-of-core tree
+        std::vector<InternedString> stringCache;                        // recently acquired strings, acquired once per chunk
+
+        InternedString makeString(std::string_view);
+    };
+
+    Node* buildTreeFromFile(const std::string&, std::string_view, unsigned int);
+    Node* buildTree(std::string_view);
+    Node* buildTreeInParallel(std::string_view, unsigned int);
+    Node* buildTreeFromStream(DecompressingStream&);
+    Node* finishTree(std::vector<ParseChunk>&);
+    std::vector<std::string_view> splitAtTopLevelNodes(std::string_view, size_t) const;
+    void parseChunk(ParseChunk&, Node*) const;
+    void parseBinaryChunk(ParseChunk&) const;
+    void parseBinaryRecords(ParseChunk&, BinaryDump::Reader&) const;
+    void addParsedNode(ParseChunk&, size_t, NodeType, const InternedString&, const InternedString&, const InternedString&,
+                       int, int) const;
+    uint32_t findStmtGroupDeclaration(const std::string&) const;
+    void flushPage(ParseChunk&, bool) const;
+    void groupStmtNodes(ParseChunk&, int) const;
+    void mergeChunks(std::vector<ParseChunk>&);
+    void buildDeclNodeIndex();
+    void computeSubtreeFingerPrints();
 };
 
 #endif
\ No newline at end of file
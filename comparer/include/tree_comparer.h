@@ -10,33 +10,58 @@
 #include <queue>
 #include "node.h"
 #include "tree.h"
+#include "flat_index.h"
+#include "decl_join.h"
+#include "processed_nodes.h"
+#include "difference_buffer.h"
 #include "neo4j_database_wrapper.h"
 #include "idatabase_wrapper.h"
 
 class TreeComparer {
 public:
-    TreeComparer(Tree&, Tree&, IDatabaseWrapper&);
+    TreeComparer(Tree&, Tree&, IDatabaseWrapper&, unsigned int threadCount = 1);
     void printDifferences();
+    const ProcessedNodes& getProcessedNodes() const;
 
 protected:
     Tree& firstASTTree;
     Tree& secondASTTree;
     IDatabaseWrapper& dbWrapper;
     std::function<bool(const Node*, const Node*)> topologicalComparer;
+    unsigned int threadCount;                        // threads of the comparison, 0 for all hardware threads
+    FlatIndex<uint32_t> stmtBuckets;                 // positions of the statements of the second AST by key, rebuilt per call
+    std::vector<uint32_t> stmtBucketCursors;         // matched prefix of every group, indexed by the start of the group
+    std::shared_ptr<ProcessedNodes> processedNodes;  // processed flags of this comparison, shared with the workers
+    std::shared_ptr<const DeclJoin> declJoin;        // declarations matched across in-memory trees, shared with the workers
+    const std::string* joinedKey = nullptr;          // key of the runs below, set by processDeclNodes from the join
+    uint32_t joinedFirstRun = DeclJoin::noRun;       // run of the key in the declaration index of the first AST
+    uint32_t joinedSecondRun = DeclJoin::noRun;      // run of the key in the declaration index of the second AST
 
+    bool isProcessed(const ASTId, const Node*) const;
+    void markProcessed(const ASTId, const Node*);
     virtual void compareSourceLocations(const Node*, const Node*);
     virtual void compareParents(const Node*, const Node*);
     virtual void compareSimilarDeclNodes(Node*, Node*);
     virtual void compareStmtNodes(const Node*, const Node*);
+    Node* findStmtMatch(const Node*, std::vector<Node*>::const_iterator);
+    bool isUnchangedSubTree(const Node*, const Node*) const;
+    void skipUnchangedSubTree(Node*, Tree&, const ASTId);
     virtual void processNodesInSingleAST(Node*, Tree&, const ASTId, bool);
-    void processMultiDeclNodes(const std::pair<std::unordered_multimap<std::string, Node*>::const_iterator,
-                                               std::unordered_multimap<std::string, Node*>::const_iterator>&,
-                               const std::pair<std::unordered_multimap<std::string, Node*>::const_iterator,
-                                               std::unordered_multimap<std::string, Node*>::const_iterator>&);
+    void processMultiDeclNodes(const std::pair<DeclNodeIndex::const_iterator, DeclNodeIndex::const_iterator>&,
+                               const std::pair<DeclNodeIndex::const_iterator, DeclNodeIndex::const_iterator>&);
     virtual void processDeclNodesInBothASTs(const std::string&);
     void processDeclNodes(Node*);
+    bool findJoinedRuns(const Node*);
+    bool isInCorrespondingAST(const Node*, const ASTId) const;
     void processRemainingNodes(std::vector<Node*>::const_iterator, std::vector<Node*>::const_iterator, Tree&, const ASTId);
-    void enqueueChildren(Node*, std::queue<Node*>&);
+    void enqueueChildren(Tree&, uint32_t, std::queue<std::pair<Tree*, uint32_t>>&);
+    void processStep(std::queue<std::pair<Tree*, uint32_t>>&);
+    uint64_t getStepOrder(const std::pair<Tree*, uint32_t>&) const;
+    std::vector<std::vector<std::pair<Tree*, uint32_t>>> partitionSteps(std::queue<std::pair<Tree*, uint32_t>>&) const;
+    void compareInParallel(std::queue<std::pair<Tree*, uint32_t>>&);
+
+private:
+    TreeComparer(Tree&, Tree&, DifferenceBuffer&, std::shared_ptr<ProcessedNodes>, std::shared_ptr<const DeclJoin>);
 };
 
 #endif
\ No newline at end of file
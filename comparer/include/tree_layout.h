@@ -0,0 +1,40 @@
+#ifndef _TREE_LAYOUT_H_
+
+#define _TREE_LAYOUT_H_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "node.h"
+#include "node_arena.h"
+
+// Preorder struct-of-arrays view of a parsed tree, the index of a node is its topological order. The subtree of a node is
+// the contiguous index range [index, subtreeEnd), the children are stored in CSR form. The Node objects stay available
+// through the node table, their children are views into the arrays of the layout.
+class TreeLayout {
+public:
+    static constexpr uint32_t noIndex = std::numeric_limits<uint32_t>::max();
+
+    void build(const NodeArena&);
+
+    size_t size() const;
+    uint32_t indexOf(const Node*) const;
+    Node* getNode(uint32_t index) const { return nodes[index]; }
+    NodeType getType(uint32_t index) const { return static_cast<NodeType>(types[index]); }
+    uint32_t getParent(uint32_t index) const { return parents[index]; }
+    uint32_t getDepth(uint32_t index) const { return depths[index]; }
+    uint32_t getSubtreeEnd(uint32_t index) const { return subtreeEnds[index]; }
+    const uint32_t* childrenBegin(uint32_t index) const { return childIndices.data() + childOffsets[index]; }
+    const uint32_t* childrenEnd(uint32_t index) const { return childIndices.data() + childOffsets[index + 1]; }
+
+private:
+    std::vector<Node*> nodes;                // Node of every index
+    std::vector<uint8_t> types;              // Declaration/Statement
+    std::vector<uint32_t> parents;           // Index of the parent, noIndex for the root
+    std::vector<uint32_t> depths;            // Distance from the root
+    std::vector<uint32_t> subtreeEnds;       // One past the last index of the subtree
+    std::vector<uint32_t> childOffsets;      // Start of the children in childIndices, one more entry than nodes
+    std::vector<uint32_t> childIndices;      // Indices of the children, grouped by parent in file order
+};
+
+#endif
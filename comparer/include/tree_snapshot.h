@@ -0,0 +1,63 @@
+#ifndef _TREE_SNAPSHOT_H_
+
+#define _TREE_SNAPSHOT_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class Tree;
+
+// Cache of fully built trees. A snapshot stores the nodes in preorder as fixed size records, the string table, and the
+// statement groups, all references are indices relative to the start of their section. The file name is the content hash of
+// the source dump, so a changed dump never matches an old snapshot. Snapshots are written in native byte order and are only
+// meant to be reused on the machine that wrote them.
+//
+//     header | string offsets (uint64, stringCount + 1) | string bytes (padded to 8) | node records | statement groups |
+//     statement node indices (uint32)
+class TreeSnapshot {
+public:
+    static uint64_t hashContents(std::string_view);
+    static std::string getPath(const std::string&, uint64_t);
+
+    static bool load(Tree&, const std::string&, uint64_t, uint64_t);
+    static void save(const Tree&, const std::string&, uint64_t, uint64_t);
+
+private:
+    static const uint32_t version = 2;
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceHash;             // Content hash of the dump the tree was built from
+        uint64_t sourceSize;             // Size of that dump in bytes
+        uint64_t nodeCount;
+        uint64_t stringCount;
+        uint64_t stringBytes;            // Size of the string bytes without the padding
+        uint64_t stmtGroupCount;
+        uint64_t stmtNodeCount;
+    };
+
+    struct NodeRecord {
+        uint32_t parent;                 // Preorder index of the parent, TreeLayout::noIndex for a root
+        uint32_t kind;                   // Index in the string table
+        uint32_t usr;
+        uint32_t path;
+        uint32_t enhancedKey;
+        int32_t lineNumber;
+        int32_t columnNumber;
+        uint32_t type;
+        uint64_t fingerprint;
+    };
+
+    struct StmtGroupRecord {
+        uint32_t declaration;            // Preorder index of the declaration
+        uint32_t firstNode;              // First entry of the group in the statement node indices
+        uint32_t nodeCount;
+        uint32_t padding;
+    };
+
+    static bool read(Tree&, std::string_view, uint64_t, uint64_t);
+};
+
+#endif
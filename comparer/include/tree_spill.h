@@ -0,0 +1,151 @@
+#ifndef _TREE_SPILL_H_
+
+#define _TREE_SPILL_H_
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "node.h"
+#include "node_arena.h"
+#include "mapped_file.h"
+
+// Disk storage of an out-of-core tree. While the dump is parsed, the nodes are written in pages of complete top-level subtrees,
+// the keys of the declarations go to a sorted index file. Afterwards pages are materialized when one of their nodes is needed
+// and evicted at safe points of the comparison, when the materialized pages exceed the memory limit. The root stays in memory,
+// the processed flags of the nodes are kept by the comparison, so an evicted page needs no state of its own.
+//
+//     page:  header | string offsets (uint32, stringCount + 1) | string bytes (padded to 8) | node records |
+//            statement groups | statement node indices (uint32)
+//     index: key entries sorted by hash and node index, the key texts are stored in a separate file for verification
+class TreeSpill {
+public:
+    struct Options {
+        std::string directory;           // Directory of the spill files, removed with the tree
+        size_t memoryLimit = 0;          // Bytes of materialized pages kept between the steps of a comparison
+    };
+
+    explicit TreeSpill(const Options&);
+    ~TreeSpill();
+
+    TreeSpill(const TreeSpill&) = delete;
+    TreeSpill& operator=(const TreeSpill&) = delete;
+
+    // construction
+    size_t getPageNodeLimit() const;
+    void setRoot(Node*);
+    void writePage(const NodeArena&, const std::vector<std::pair<const Node*, Node*>>&);
+    void finish();
+
+    // access
+    uint32_t size() const;
+    Node* getNode(uint32_t);
+    NodeType getType(uint32_t) const;
+    std::pair<const uint32_t*, const uint32_t*> getChildIndices(uint32_t);
+    bool containsDeclKey(const InternedString&) const;
+    void findDeclNodes(const InternedString&, std::vector<Node*>&);
+    void findStmtNodes(uint32_t, std::vector<Node*>&);
+    void processSubTree(uint32_t, const std::function<void(Node*, int)>&);
+    void releaseNodes();
+
+    size_t getPageCount() const;
+    size_t getResidentPageCount() const;
+    size_t getResidentBytes() const;
+
+private:
+    static const size_t residentPageTarget = 4;     // pages that fit into the memory limit
+    static const size_t estimatedNodeBytes = sizeof(Node) + 64; // node, its arrays and a share of its strings
+
+    struct PageEntry {
+        uint32_t firstNode;              // Preorder index of the first node of the page
+        uint32_t nodeCount;
+        uint64_t offset;                 // Position of the page in the pages file
+        uint64_t size;
+    };
+
+    struct KeyEntry {
+        uint64_t hash;                   // Hash of the enhanced key
+        uint32_t node;                   // Preorder index of the declaration
+        uint32_t keyLength;
+        uint64_t keyOffset;              // Position of the key text in the keys file
+    };
+
+    struct PageHeader {
+        uint32_t nodeCount;
+        uint32_t stringCount;
+        uint32_t stmtGroupCount;
+        uint32_t stmtNodeCount;
+        uint64_t stringBytes;
+    };
+
+    struct NodeRecord {
+        uint32_t parent;                 // Preorder index of the parent, 0 is the root
+        uint32_t kind;                   // Index in the string table of the page
+        uint32_t usr;
+        uint32_t path;
+        uint32_t enhancedKey;
+        int32_t lineNumber;
+        int32_t columnNumber;
+        uint32_t type;
+        uint64_t fingerprint;
+    };
+
+    struct StmtGroupRecord {
+        uint32_t declaration;            // Preorder index of the declaration
+        uint32_t firstNode;              // First entry of the group in the statement node indices
+        uint32_t nodeCount;
+        uint32_t padding;
+    };
+
+    // materialized page, the vectors are filled before the children of the nodes point into them
+    struct ResidentPage {
+        NodeArena arena;
+        std::vector<Node*> nodes;                    // Nodes by position in the page
+        std::vector<uint32_t> depths;                // Distance from the root
+        std::vector<uint32_t> subtreeEnds;           // One past the last preorder index of the subtree
+        std::vector<uint32_t> childOffsets;          // Start of the children, one more entry than nodes
+        std::vector<uint32_t> localChildren;         // Positions of the children in the page
+        std::vector<uint32_t> globalChildren;        // Preorder indices of the children
+        std::vector<InternedString> strings;         // Acquired strings of the page
+        std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> stmtGroups; // Declaration to range of stmtNodes
+        std::vector<uint32_t> stmtNodes;
+        size_t bytes = 0;                            // Estimated memory of the page
+        std::list<uint32_t>::iterator lruPosition;
+    };
+
+    Options options;
+    std::string pagesFileName;
+    std::string keysFileName;
+    std::string indexFileName;
+    std::ofstream pagesOutput;
+    std::ofstream keysOutput;
+    mutable std::ifstream pagesInput;
+    mutable std::ifstream keysInput;
+    uint64_t pagesSize = 0;
+    uint64_t keysSize = 0;
+    std::vector<KeyEntry> keyEntries;                // Index while the tree is built
+    std::unique_ptr<MappedFile> index;               // Sorted key entries after the tree is built
+
+    Node* root = nullptr;
+    uint32_t nodeCount = 1;
+    std::vector<uint32_t> topLevelNodes;             // Children of the root
+    std::vector<uint32_t> rootStmtNodes;             // Statements whose declaration parent is the root
+    size_t rootChildrenHash = 0;                     // Combined fingerprints of the top-level nodes
+    std::vector<PageEntry> pages;
+    std::vector<uint8_t> types;                      // Type of every node
+    std::vector<std::unique_ptr<ResidentPage>> residentPages;
+    std::list<uint32_t> leastRecentlyUsed;           // Resident pages, most recently used first
+    size_t residentBytes = 0;
+
+    uint32_t pageOf(uint32_t) const;
+    ResidentPage& loadPage(uint32_t);
+    void evictPage(uint32_t);
+    std::pair<const KeyEntry*, const KeyEntry*> findKeyEntries(const InternedString&) const;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define _UTILS_H_
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include "node.h"
 #include "enums.h"
@@ -10,17 +11,20 @@ class Utils {
 public:
     static std::string getStmtKey(const Node*, const std::string&);
     static std::string getEnhancedDeclKey(const Node*);
-    static size_t getFingerPrint(const Node*);
+    static size_t getFingerPrint(const Node*, size_t);
+    static size_t addChildFingerPrint(size_t, size_t, uint32_t);
     static const Node* findDeclarationParent(const Node*);
 
     static std::string astIdToString(const ASTId);
     static std::string nodeTypeToString(const NodeType);
-    static NodeType stringToNodeType(const std::string&);
+    static NodeType stringToNodeType(std::string_view);
     static std::string differenceTypeToString(const DifferenceType);
 
     static void printSeparators();
     static void printNodeDetails(const Node*, std::string);
     static std::vector<std::string> splitString(const std::string&, const char delimiter = '\t');
+    static size_t splitLine(std::string_view, std::string_view*, size_t, const char delimiter = '\t');
+    static bool parseInt(std::string_view, int&);
     static void ltrim(std::string&);
     static void rtrim(std::string&);
 
@@ -0,0 +1,181 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include "../include/batch_comparer.h"
+#include "../include/binary_dump.h"
+#include "../include/decompressing_stream.h"
+#include "../include/difference_buffer.h"
+#include "../include/thread_pool.h"
+#include "../include/tree_comparer.h"
+#include "../include/utils.h"
+
+/*
+Description:
+    Creates the batch comparer, the trees are built by the loader, so a batch uses the same in-memory, snapshot or out-of-core
+    settings as a single comparison.
+*/
+BatchComparer::BatchComparer(IDatabaseWrapper& writer, TreeLoader loader, Options options)
+    : writer(writer), loadTree(std::move(loader)), options(std::move(options)) {
+    if (!loadTree) {
+        throw std::invalid_argument("BatchComparer needs a tree loader.");
+    }
+    if (!this->options.estimateMemory) {
+        this->options.estimateMemory = estimateTreeMemory;
+    }
+}
+
+/*
+Description:
+    Reads the pairs of a manifest, every line holds the paths of the first and the second dump separated by a tab. Empty lines
+    and lines starting with # are skipped.
+*/
+std::vector<BatchComparer::Pair> BatchComparer::readManifest(const std::string& manifestPath) {
+    std::ifstream manifest(manifestPath);
+    if (!manifest.is_open()) {
+        throw std::runtime_error("Could not open manifest: " + manifestPath);
+    }
+
+    std::vector<Pair> pairs;
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(manifest, line); ++lineNumber) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::vector<std::string> fields = Utils::splitString(line, '\t');
+        if (fields.size() != 2 || fields[0].empty() || fields[1].empty()) {
+            throw std::runtime_error("Invalid manifest line " + std::to_string(lineNumber) + " in " + manifestPath + ": " + line);
+        }
+        pairs.emplace_back(fields[0], fields[1]);
+    }
+    return pairs;
+}
+
+/*
+Description:
+    Estimates the memory of the tree built from the dump by the size of the dump. The factors are the resident size of the
+    tree of a 3M-node dump over its file size, rounded up: 3.8 for text, 21 for binary and 49 for a zstd compressed binary
+    dump (35 for compressed text). The format inside a compressed dump is not known without decompressing it, so it gets
+    the binary factor. A missing dump is estimated with 0, its pair fails when it is loaded.
+*/
+size_t BatchComparer::estimateTreeMemory(const std::string& filePath) {
+    const size_t textFactor = 4;
+    const size_t binaryFactor = 22;
+    const size_t compressedFactor = 50;
+
+    std::error_code error;
+    uintmax_t fileSize = std::filesystem::file_size(filePath, error);
+    if (error) {
+        return 0;
+    }
+
+    char magic[4] = {};
+    std::ifstream file(filePath, std::ios::binary);
+    file.read(magic, sizeof(magic));
+    std::string_view header(magic, static_cast<size_t>(file.gcount()));
+
+    size_t factor = textFactor;
+    if (DecompressingStream::detectCodec(header) != DecompressingStream::NONE) {
+        factor = compressedFactor;
+    } else if (BinaryDump::isBinaryDump(header)) {
+        factor = binaryFactor;
+    }
+    return static_cast<size_t>(fileSize) * factor;
+}
+
+/*
+Description:
+    Compares all pairs and returns the report of the batch. A failed pair is reported on std::cerr and does not stop the
+    batch. The writer is finalized once, after the last pair.
+*/
+BatchComparer::Report BatchComparer::run(const std::vector<Pair>& pairs) {
+    auto start = std::chrono::steady_clock::now();
+    Report report;
+    report.pairs = pairs.size();
+
+    {
+        ThreadPool pool(options.threadCount);
+        std::vector<std::future<void>> results;
+        results.reserve(pairs.size());
+        for (const Pair& pair : pairs) {
+            results.push_back(pool.submit([this, &pair, &report]() { comparePair(pair, report); }));
+        }
+        for (std::future<void>& result : results) {
+            result.get();
+        }
+    }
+    writer.finalize();
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+/*
+Description:
+    Loads and compares one pair once its memory is admitted, the differences are buffered and written to the shared writer
+    afterwards, so the comparisons of the pairs run in parallel while the writer is used by one pair at a time.
+*/
+void BatchComparer::comparePair(const Pair& pair, Report& report) {
+    size_t memory = options.estimateMemory(pair.first) + options.estimateMemory(pair.second);
+    acquireMemory(memory);
+
+    try {
+        std::unique_ptr<Tree> firstTree = loadTree(pair.first);
+        std::unique_ptr<Tree> secondTree = loadTree(pair.second);
+
+        // the pool already runs a pair per thread, a pair is compared sequentially
+        std::vector<DifferenceBuffer> buffers(1);
+        buffers[0].beginStep(0);
+        TreeComparer comparer(*firstTree, *secondTree, buffers[0], 1);
+        comparer.printDifferences();
+
+        std::lock_guard<std::mutex> lock(writerMutex);
+        writer.beginComparison(pair.first + "\t" + pair.second);
+        DifferenceBuffer::replay(buffers, writer);
+        report.differences += buffers[0].size();
+        // the trees are deleted with their nodes and strings here, before their memory is released for the next pair
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: comparison of " << pair.first << " and " << pair.second << " failed: " << e.what() << std::endl;
+        std::lock_guard<std::mutex> lock(writerMutex);
+        ++report.failed;
+    }
+
+    releaseMemory(memory);
+}
+
+/*
+Description:
+    Waits until the memory fits next to the running pairs. A pair larger than the limit waits until no other pair is running.
+*/
+void BatchComparer::acquireMemory(size_t memory) {
+    std::unique_lock<std::mutex> lock(memoryMutex);
+    memoryReleased.wait(lock, [this, memory]() {
+        return options.memoryLimit == 0 || memoryInUse == 0 || memoryInUse + memory <= options.memoryLimit;
+    });
+    memoryInUse += memory;
+}
+
+/*
+Description:
+    Returns the memory of a finished pair and wakes the waiting pairs.
+*/
+void BatchComparer::releaseMemory(size_t memory) {
+    {
+        std::lock_guard<std::mutex> lock(memoryMutex);
+        memoryInUse -= memory;
+    }
+    memoryReleased.notify_all();
+}
+
+/*
+Description:
+    Returns the throughput of the batch.
+*/
+double BatchComparer::Report::getPairsPerMinute() const {
+    return seconds > 0 ? pairs * 60.0 / seconds : 0;
+}
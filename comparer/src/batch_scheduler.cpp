@@ -0,0 +1,144 @@
+#include "../include/batch_scheduler.h"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+Description:
+    Creates the scheduler, submitting waits while the given number of batches is queued.
+*/
+BatchScheduler::BatchScheduler(size_t maxQueuedBatches) : maxQueuedBatches(maxQueuedBatches) {
+    if (maxQueuedBatches == 0) {
+        throw std::invalid_argument("BatchScheduler needs room for at least one queued batch.");
+    }
+}
+
+/*
+Description:
+    Queues a node batch, it gets the next node batch index. Returns the buffer for the next batch.
+*/
+std::string BatchScheduler::submitNodes(std::string&& nodes) {
+    Batch batch;
+    batch.nodes = std::move(nodes);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.nodeBatchIndex = submittedNodeBatches++;
+    }
+    return queueBatch(std::move(batch));
+}
+
+/*
+Description:
+    Queues a relationship batch, it is handed out once the node batches submitted before it have finished. Returns the buffer
+    for the next batch.
+*/
+std::string BatchScheduler::submitRelationships(std::string&& relationships) {
+    Batch batch;
+    batch.relationships = std::move(relationships);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.nodeBatchIndex = submittedNodeBatches;
+    }
+    return queueBatch(std::move(batch));
+}
+
+/*
+Description:
+    Waits for the next batch that can be sent and moves it into the given batch. Returns false once the scheduler is stopped
+    and the queue is empty.
+*/
+bool BatchScheduler::take(Batch& batch) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto ready = queuedBatches.end();
+        changed.wait(lock, [this, &ready]() {
+            ready = findReadyBatch();
+            return ready != queuedBatches.end() || (isStopping && queuedBatches.empty());
+        });
+        if (ready == queuedBatches.end()) {
+            return false;
+        }
+        batch = std::move(*ready);
+        queuedBatches.erase(ready);
+        ++activeWrites;
+    }
+    changed.notify_all(); // room for the next batch
+    return true;
+}
+
+/*
+Description:
+    Records a batch returned by take() as finished, written or failed. Node batches finish out of order, the relationships
+    wait for all earlier ones. The buffer of the batch is kept for the next batches.
+*/
+void BatchScheduler::finish(Batch& batch) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!batch.nodes.empty()) {
+            finishedLaterNodeBatches.insert(batch.nodeBatchIndex);
+            while (!finishedLaterNodeBatches.empty() && *finishedLaterNodeBatches.begin() == finishedNodeBatches) {
+                finishedLaterNodeBatches.erase(finishedLaterNodeBatches.begin());
+                ++finishedNodeBatches;
+            }
+        }
+        --activeWrites;
+        // only the buffer holding the batch is kept, the other one was never filled
+        std::string& buffer = batch.nodes.empty() ? batch.relationships : batch.nodes;
+        if (spareBuffers.size() < maxQueuedBatches) {
+            buffer.clear();
+            spareBuffers.push_back(std::move(buffer));
+        }
+    }
+    changed.notify_all();
+}
+
+/*
+Description:
+    Waits until every submitted batch has finished, afterwards the calling thread may send requests in order.
+*/
+void BatchScheduler::drain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return queuedBatches.empty() && activeWrites == 0; });
+}
+
+/*
+Description:
+    Lets take() return false once the queued batches are handed out.
+*/
+void BatchScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    changed.notify_all();
+}
+
+/*
+Description:
+    Appends the batch to the queue, waits while the queue is full. Returns an empty buffer for the next batch, the buffer of
+    a finished batch when there is one, so its memory is reused.
+*/
+std::string BatchScheduler::queueBatch(Batch&& batch) {
+    std::string buffer;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return queuedBatches.size() < maxQueuedBatches; });
+        queuedBatches.push_back(std::move(batch));
+        if (!spareBuffers.empty()) {
+            buffer = std::move(spareBuffers.back());
+            spareBuffers.pop_back();
+        }
+    }
+    changed.notify_all();
+    return buffer;
+}
+
+/*
+Description:
+    Returns the first queued batch that can be sent: a node batch, or a relationship batch whose node batches are finished.
+    The mutex has to be held.
+*/
+std::deque<BatchScheduler::Batch>::iterator BatchScheduler::findReadyBatch() {
+    return std::find_if(queuedBatches.begin(), queuedBatches.end(), [this](const Batch& batch) {
+        return !batch.nodes.empty() || batch.nodeBatchIndex <= finishedNodeBatches;
+    });
+}
@@ -0,0 +1,224 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../include/comparer_daemon.h"
+#include "../include/counting_database_wrapper.h"
+#include "../include/tree_comparer.h"
+#include "../include/utils.h"
+
+/*
+Description:
+    Creates the daemon, the trees are built by the loader, so the daemon uses the same in-memory, snapshot or out-of-core
+    settings as a single comparison. The socket is opened by run().
+*/
+ComparerDaemon::ComparerDaemon(const std::string& socketPath, IDatabaseWrapper& db, TreeLoader loader, unsigned int threadCount,
+                               unsigned int clientTimeoutMs)
+    : socketPath(socketPath), dbWrapper(db), loadTree(std::move(loader)), threadCount(threadCount), clientTimeoutMs(clientTimeoutMs) {
+    if (!loadTree) {
+        throw std::invalid_argument("ComparerDaemon needs a tree loader.");
+    }
+    if (clientTimeoutMs == 0) {
+        throw std::invalid_argument("ComparerDaemon needs a positive client timeout.");
+    }
+}
+
+/*
+Description:
+    Returns the resident baseline of the dump, loads it on the first request.
+*/
+Tree& ComparerDaemon::loadBaseline(const std::string& filePath) {
+    auto it = baselines.find(filePath);
+    if (it == baselines.end()) {
+        it = baselines.emplace(filePath, loadTree(filePath)).first;
+    }
+    return *it->second;
+}
+
+/*
+Description:
+    Returns true after a shutdown request was answered.
+*/
+bool ComparerDaemon::isStopping() const {
+    return stopRequested;
+}
+
+/*
+Description:
+    Serves the clients of the socket until a shutdown request. An existing socket file is replaced, the socket file is
+    removed when the daemon stops.
+*/
+void ComparerDaemon::run() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path: " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket < 0) {
+        throw std::runtime_error("Could not create socket: " + std::string(std::strerror(errno)));
+    }
+    unlink(socketPath.c_str());
+    if (bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listenSocket, 16) < 0) {
+        std::string error = std::strerror(errno);
+        close(listenSocket);
+        throw std::runtime_error("Could not listen on socket " + socketPath + ": " + error);
+    }
+    std::cout << "Listening on " << socketPath << std::endl;
+
+    while (!stopRequested) {
+        int clientSocket = accept(listenSocket, nullptr, nullptr);
+        if (clientSocket < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Warning: accept failed on " << socketPath << ": " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        // a client that does not send or receive within the timeout is disconnected
+        timeval timeout{};
+        timeout.tv_sec = static_cast<time_t>(clientTimeoutMs / 1000);
+        timeout.tv_usec = static_cast<suseconds_t>(clientTimeoutMs % 1000) * 1000;
+        setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(clientSocket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        serveClient(clientSocket);
+        close(clientSocket);
+    }
+
+    close(listenSocket);
+    unlink(socketPath.c_str());
+}
+
+/*
+Description:
+    Answers the requests of a client line by line until the client closes the connection, the client timeout expires or the
+    daemon is stopped.
+*/
+void ComparerDaemon::serveClient(int clientSocket) {
+    std::string buffer;
+    char chunk[4096];
+    while (!stopRequested) {
+        size_t lineEnd = buffer.find('\n');
+        if (lineEnd == std::string::npos) {
+            ssize_t received = recv(clientSocket, chunk, sizeof(chunk), 0);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                std::cerr << "Warning: disconnecting a client of " << socketPath << " that sent no request within "
+                          << clientTimeoutMs << " ms" << std::endl;
+                return;
+            }
+            if (received <= 0) {
+                return;
+            }
+            buffer.append(chunk, static_cast<size_t>(received));
+            continue;
+        }
+
+        std::string line = buffer.substr(0, lineEnd);
+        buffer.erase(0, lineEnd + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (!writeLine(clientSocket, handleRequest(line))) {
+            return;
+        }
+    }
+}
+
+/*
+Description:
+    Writes a line of the answer, returns false if the client is gone.
+*/
+bool ComparerDaemon::writeLine(int clientSocket, const std::string& line) {
+    std::string data = line + "\n";
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t sent = send(clientSocket, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+/*
+Description:
+    Executes one request line and returns its answer, failures of the request are answered with an error line.
+*/
+std::string ComparerDaemon::handleRequest(const std::string& line) {
+    std::vector<std::string> fields = Utils::splitString(line, '\t');
+    if (fields.empty()) {
+        return "error\tEmpty request";
+    }
+    const std::string& command = fields[0];
+
+    try {
+        if (command == "compare" && fields.size() == 3) {
+            return compare(fields[1], fields[2]);
+        }
+        if (command == "load" && fields.size() == 2) {
+            return "ok\tnodes=" + std::to_string(loadBaseline(fields[1]).getNodeCount());
+        }
+        if (command == "unload" && fields.size() == 2) {
+            if (baselines.erase(fields[1]) == 0) {
+                return "error\tBaseline is not loaded: " + fields[1];
+            }
+            return "ok";
+        }
+        if (command == "status" && fields.size() == 1) {
+            return "ok\tbaselines=" + std::to_string(baselines.size());
+        }
+        if (command == "shutdown" && fields.size() == 1) {
+            stopRequested = true;
+            return "ok";
+        }
+    } catch (const std::exception& e) {
+        return "error\t" + std::string(e.what());
+    }
+    return "error\tUnknown request: " + line;
+}
+
+/*
+Description:
+    Compares the candidate with the resident baseline, the baseline is the first AST. The database is cleared first, like
+    by a single comparison, the answer summarizes the written differences.
+*/
+std::string ComparerDaemon::compare(const std::string& baselinePath, const std::string& candidatePath) {
+    auto start = std::chrono::steady_clock::now();
+    Tree& baseline = loadBaseline(baselinePath);
+    std::unique_ptr<Tree> candidate = loadTree(candidatePath);
+    auto loaded = std::chrono::steady_clock::now();
+
+    dbWrapper.clearDatabase();
+    CountingDatabaseWrapper counter(&dbWrapper);
+    TreeComparer comparer(baseline, *candidate, counter, threadCount);
+    comparer.printDifferences();
+    auto compared = std::chrono::steady_clock::now();
+
+    std::ostringstream answer;
+    answer << "ok\tnodes=" << counter.getNodeCount() << "\trelationships=" << counter.getRelationshipCount();
+    for (const auto& [labels, count] : counter.getNodeCounts()) {
+        answer << "\t" << labels.first << ":" << labels.second << "=" << count;
+    }
+    answer << "\tload_ms=" << std::chrono::duration_cast<std::chrono::milliseconds>(loaded - start).count()
+           << "\tcompare_ms=" << std::chrono::duration_cast<std::chrono::milliseconds>(compared - loaded).count();
+    return answer.str();
+}
@@ -0,0 +1,125 @@
+#include "../include/counting_database_wrapper.h"
+
+/*
+Description:
+    Creates the counter, the calls are passed on to the next wrapper if it is not nullptr.
+*/
+CountingDatabaseWrapper::CountingDatabaseWrapper(IDatabaseWrapper* next) : next(next) {}
+
+/*
+Description:
+    Counts a node by its difference type and AST.
+*/
+void CountingDatabaseWrapper::addNodeToBatch(const Node& node, bool isHighLevel, const std::string& differenceType, const std::string& astOrigin) {
+    ++nodeCounts[{differenceType, astOrigin}];
+    ++nodeCount;
+    if (next) {
+        next->addNodeToBatch(node, isHighLevel, differenceType, astOrigin);
+    }
+}
+
+/*
+Description:
+    Counts a relationship.
+*/
+void CountingDatabaseWrapper::addRelationshipToBatch(const Node& parent, const Node& child) {
+    ++relationshipCount;
+    if (next) {
+        next->addRelationshipToBatch(parent, child);
+    }
+}
+
+/*
+Description:
+    Passes the call on to the next wrapper.
+*/
+void CountingDatabaseWrapper::finalize() {
+    if (next) {
+        next->finalize();
+    }
+}
+
+/*
+Description:
+    Passes the call on to the next wrapper.
+*/
+void CountingDatabaseWrapper::createIndices() {
+    if (next) {
+        next->createIndices();
+    }
+}
+
+/*
+Description:
+    Passes the call on to the next wrapper.
+*/
+void CountingDatabaseWrapper::clearDatabase() {
+    if (next) {
+        next->clearDatabase();
+    }
+}
+
+/*
+Description:
+    Passes the call on to the next wrapper.
+*/
+void CountingDatabaseWrapper::beginComparison(const std::string& comparison) {
+    if (next) {
+        next->beginComparison(comparison);
+    }
+}
+
+/*
+Description:
+    Returns the number of counted nodes.
+*/
+size_t CountingDatabaseWrapper::getNodeCount() const {
+    return nodeCount;
+}
+
+/*
+Description:
+    Returns the number of counted nodes with the difference type and AST.
+*/
+size_t CountingDatabaseWrapper::getNodeCount(const std::string& differenceType, const std::string& astOrigin) const {
+    auto it = nodeCounts.find({differenceType, astOrigin});
+    return it == nodeCounts.end() ? 0 : it->second;
+}
+
+/*
+Description:
+    Returns the number of counted relationships.
+*/
+size_t CountingDatabaseWrapper::getRelationshipCount() const {
+    return relationshipCount;
+}
+
+/*
+Description:
+    Returns the node counts by difference type and AST, ordered by both.
+*/
+const std::map<std::pair<std::string, std::string>, size_t>& CountingDatabaseWrapper::getNodeCounts() const {
+    return nodeCounts;
+}
+
+/*
+Description:
+    Clears the counts for the next comparison.
+*/
+void CountingDatabaseWrapper::reset() {
+    nodeCounts.clear();
+    nodeCount = 0;
+    relationshipCount = 0;
+}
+
+/*
+Description:
+    Prints the counted nodes by difference type and AST followed by the totals, one tab separated count per line.
+*/
+void CountingDatabaseWrapper::printSummary(std::ostream& out) const {
+    for (const auto& [labels, count] : nodeCounts) {
+        out << labels.first << "\t" << labels.second << "\t" << count << "\n";
+    }
+    out << "nodes\t\t" << nodeCount << "\n";
+    out << "relationships\t\t" << relationshipCount << std::endl;
+}
@@ -0,0 +1,248 @@
+#include "../include/csv_import_writer.h"
+#include "../include/json_writer.h"
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+
+/*
+Description:
+    Creates the writer, the directory is created if needed and the header files are written. A part file is closed once the
+    next row would exceed maxPartBytes, a single larger row gets a part of its own.
+*/
+CsvImportWriter::CsvImportWriter(const std::string& directory, size_t maxPartBytes) : directory(directory), maxPartBytes(maxPartBytes) {
+    if (maxPartBytes == 0) {
+        throw std::invalid_argument("CsvImportWriter needs a positive part size.");
+    }
+    std::filesystem::create_directories(directory);
+    nodeFiles.name = "nodes";
+    relationshipFiles.name = "relationships";
+    writeHeader(nodeFiles, "id:ID(Node),enhancedKey,type:int,kind,usr,path,lineNumber:int,columnNumber:int,topologicalOrder:int,"
+                           "isHighLevel:boolean,diffType,ast,comparison");
+    writeHeader(relationshipFiles, ":START_ID(Node),:END_ID(Node)");
+}
+
+/*
+Description:
+    Writes the node as a row of the node parts, with the id of Neo4jNodeIds. A node already written with the same difference
+    type and AST is skipped, the import rejects duplicate ids.
+*/
+void CsvImportWriter::addNodeToBatch(const Node& node, bool isHighLevel, const std::string& differenceType, const std::string& astOrigin) {
+    uint64_t id = 0;
+    if (!nodeIds.addNode(node, differenceType, astOrigin, id)) {
+        return;
+    }
+
+    row.clear();
+    JsonWriter::appendNumber(row, static_cast<long long>(id));
+    row += ',';
+    appendField(row, node.enhancedKey.str());
+    row += ',';
+    JsonWriter::appendNumber(row, node.type);
+    row += ',';
+    appendField(row, node.kind.str());
+    row += ',';
+    appendField(row, node.usr.str());
+    row += ',';
+    appendField(row, node.path.str());
+    row += ',';
+    JsonWriter::appendNumber(row, node.lineNumber);
+    row += ',';
+    JsonWriter::appendNumber(row, node.columnNumber);
+    row += ',';
+    JsonWriter::appendNumber(row, node.topologicalOrder);
+    row += ',';
+    JsonWriter::appendBool(row, isHighLevel);
+    row += ',';
+    appendField(row, differenceType);
+    row += ',';
+    appendField(row, astOrigin);
+    row += ',';
+    appendField(row, comparison);
+    row += '\n';
+    writeRow(nodeFiles);
+}
+
+/*
+Description:
+    Writes the relationship as a row of the relationship parts. A relationship without both of its nodes in the node parts,
+    or written before, is skipped, the import rejects relationships to missing nodes.
+*/
+void CsvImportWriter::addRelationshipToBatch(const Node& parent, const Node& child) {
+    uint64_t parentId = 0;
+    uint64_t childId = 0;
+    if (!nodeIds.getRelationshipIds(parent, child, parentId, childId)) {
+        return;
+    }
+
+    row.clear();
+    JsonWriter::appendNumber(row, static_cast<long long>(parentId));
+    row += ',';
+    JsonWriter::appendNumber(row, static_cast<long long>(childId));
+    row += '\n';
+    writeRow(relationshipFiles);
+}
+
+/*
+Description:
+    Flushes the parts and writes import.args, the options of neo4j-admin for the files written so far.
+*/
+void CsvImportWriter::finalize() {
+    for (PartFiles* parts : {&nodeFiles, &relationshipFiles}) {
+        if (parts->out.is_open()) {
+            parts->out.flush();
+        }
+    }
+
+    std::ofstream args(getPath("import.args"), std::ios::trunc);
+    if (!args.is_open()) {
+        throw std::runtime_error("Could not write import arguments to " + directory);
+    }
+    const std::pair<const char*, const PartFiles*> groups[] = {{"--nodes=Node=", &nodeFiles}, {"--relationships=HAS_CHILD=", &relationshipFiles}};
+    for (const auto& [option, parts] : groups) {
+        if (parts->files.size() < 2) {
+            continue; // only the header
+        }
+        args << option;
+        for (size_t i = 0; i < parts->files.size(); ++i) {
+            args << (i == 0 ? "" : ",") << parts->files[i];
+        }
+        args << "\n";
+    }
+    args << "--id-type=INTEGER\n--multiline-fields=true\n";
+    if (!args) {
+        throw std::runtime_error("Could not write import arguments to " + directory);
+    }
+}
+
+/*
+Description:
+    Writes the constraint and indices of the database to schema.cypher, they are created after the import.
+*/
+void CsvImportWriter::createIndices() {
+    std::ofstream schema(getPath("schema.cypher"), std::ios::trunc);
+    for (const std::string& statement : Neo4jNodeIds::getSchemaStatements()) {
+        schema << statement << ";\n";
+    }
+    if (!schema) {
+        throw std::runtime_error("Could not write schema to " + directory);
+    }
+}
+
+/*
+Description:
+    Removes the parts of the directory, also the ones left by an earlier run, the next differences start with the first part
+    again.
+*/
+void CsvImportWriter::clearDatabase() {
+    for (PartFiles* parts : {&nodeFiles, &relationshipFiles}) {
+        if (parts->out.is_open()) {
+            parts->out.close();
+        }
+        parts->files.resize(1);
+        parts->partBytes = 0;
+    }
+    nodeIds.clearWrittenNodes();
+
+    std::vector<std::filesystem::path> parts;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::string fileName = entry.path().filename().string();
+        if (fileName.rfind(nodeFiles.name + "_part_", 0) == 0 || fileName.rfind(relationshipFiles.name + "_part_", 0) == 0) {
+            parts.push_back(entry.path());
+        }
+    }
+    for (const auto& path : parts) {
+        std::filesystem::remove(path);
+    }
+}
+
+/*
+Description:
+    Names the comparison of the following differences, its nodes get ids of their own.
+*/
+void CsvImportWriter::beginComparison(const std::string& name) {
+    comparison = name;
+    nodeIds.beginComparison();
+}
+
+/*
+Description:
+    Returns the header and the parts of the nodes.
+*/
+const std::vector<std::string>& CsvImportWriter::getNodeFiles() const {
+    return nodeFiles.files;
+}
+
+/*
+Description:
+    Returns the header and the parts of the relationships.
+*/
+const std::vector<std::string>& CsvImportWriter::getRelationshipFiles() const {
+    return relationshipFiles.files;
+}
+
+/*
+Description:
+    Writes the header file of the parts.
+*/
+void CsvImportWriter::writeHeader(PartFiles& parts, const std::string& header) {
+    std::string path = getPath(parts.name + "_header.csv");
+    std::ofstream out(path, std::ios::trunc);
+    out << header << "\n";
+    if (!out) {
+        throw std::runtime_error("Could not write " + path);
+    }
+    parts.files.push_back(path);
+}
+
+/*
+Description:
+    Appends the row to the current part, starts the next part when the row does not fit.
+*/
+void CsvImportWriter::writeRow(PartFiles& parts) {
+    if (!parts.out.is_open() || (parts.partBytes != 0 && parts.partBytes + row.size() > maxPartBytes)) {
+        if (parts.out.is_open()) {
+            parts.out.close();
+        }
+        char partName[32];
+        std::snprintf(partName, sizeof(partName), "_part_%04zu.csv", parts.files.size());
+        std::string path = getPath(parts.name + partName);
+        parts.out.open(path, std::ios::binary | std::ios::trunc);
+        if (!parts.out.is_open()) {
+            throw std::runtime_error("Could not open " + path);
+        }
+        parts.files.push_back(path);
+        parts.partBytes = 0;
+    }
+
+    parts.out.write(row.data(), static_cast<std::streamsize>(row.size()));
+    if (!parts.out) {
+        throw std::runtime_error("Could not write " + parts.files.back());
+    }
+    parts.partBytes += row.size();
+}
+
+/*
+Description:
+    Returns the path of a file in the output directory.
+*/
+std::string CsvImportWriter::getPath(const std::string& fileName) const {
+    return (std::filesystem::path(directory) / fileName).string();
+}
+
+/*
+Description:
+    Appends a quoted CSV field, quotes inside the value are doubled.
+*/
+void CsvImportWriter::appendField(std::string& out, std::string_view value) {
+    out += '"';
+    size_t runStart = 0;
+    for (size_t position = 0; position < value.size(); ++position) {
+        if (value[position] == '"') {
+            out.append(value.data() + runStart, position + 1 - runStart);
+            out += '"';
+            runStart = position + 1;
+        }
+    }
+    out.append(value.data() + runStart, value.size() - runStart);
+    out += '"';
+}
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include "../include/decl_join.h"
+#include "../include/thread_pool.h"
+
+namespace {
+    // partitions are sized to keep the hash table of a partition in the L2 cache
+    constexpr size_t partitionSize = 4096;
+    constexpr int maxPartitionBits = 12;
+
+    uint64_t spreadKey(uint32_t key) {
+        return static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ULL;
+    }
+}
+
+/*
+Description:
+    Matches the declaration keys of two in-memory trees. The runs of both indices are partitioned by the top bits of their
+    spread key, the partitions with the same bits are joined with a hash table of the runs of the first tree. Every step is
+    split between the threads, 0 uses all hardware threads.
+*/
+DeclJoin::DeclJoin(const Tree& firstTree, const Tree& secondTree, unsigned int threadCount) {
+    if (firstTree.isOutOfCore() || secondTree.isOutOfCore()) {
+        throw std::invalid_argument("DeclJoin needs two in-memory trees.");
+    }
+
+    size_t taskCount = threadCount == 0 ? ThreadPool::defaultThreadCount() : threadCount;
+    const DeclNodeIndex& firstIndex = firstTree.getDeclNodeMultiMap();
+    const DeclNodeIndex& secondIndex = secondTree.getDeclNodeMultiMap();
+
+    assignNodeRuns(firstTree, FIRST_AST, taskCount);
+    assignNodeRuns(secondTree, SECOND_AST, taskCount);
+
+    int partitionBits = 0;
+    size_t runCount = std::max(firstIndex.keyCount(), secondIndex.keyCount());
+    while (partitionBits < maxPartitionBits && (runCount >> partitionBits) > partitionSize) {
+        ++partitionBits;
+    }
+
+    Partitions firstPartitions = partition(firstIndex, partitionBits, taskCount);
+    Partitions secondPartitions = partition(secondIndex, partitionBits, taskCount);
+
+    partnerRuns[FIRST_AST].assign(firstIndex.keyCount(), noRun);
+    partnerRuns[SECOND_AST].assign(secondIndex.keyCount(), noRun);
+
+    size_t partitionCount = firstPartitions.starts.size() - 1;
+    std::vector<size_t> matchedKeys(taskCount, 0);
+    runTasks(partitionCount, taskCount, [&](size_t task, size_t first, size_t last) {
+        matchedKeys[task] = joinPartitions(firstPartitions, secondPartitions, first, last);
+    });
+    for (size_t count : matchedKeys) {
+        matchedKeyCount += count;
+    }
+}
+
+/*
+Description:
+    Returns the run of the declaration at the preorder index in the declaration index of its tree, noRun for statements.
+*/
+uint32_t DeclJoin::getRun(ASTId ast, uint32_t index) const {
+    const std::vector<uint32_t>& runs = nodeRuns[ast];
+    return index < runs.size() ? runs[index] : noRun;
+}
+
+/*
+Description:
+    Returns the run in the declaration index of the other tree that holds the key of the given run, noRun if the other tree
+    does not declare the key.
+*/
+uint32_t DeclJoin::getPartnerRun(ASTId ast, uint32_t run) const {
+    return run == noRun ? noRun : partnerRuns[ast][run];
+}
+
+/*
+Description:
+    Returns the number of keys declared in both trees.
+*/
+size_t DeclJoin::getMatchedKeyCount() const {
+    return matchedKeyCount;
+}
+
+/*
+Description:
+    Splits the items into contiguous ranges and calls the function with the task number and the range of every task, on a
+    thread pool if there is more than one task.
+*/
+template<typename Function>
+void DeclJoin::runTasks(size_t itemCount, size_t taskCount, Function&& function) {
+    taskCount = std::max<size_t>(1, std::min(taskCount, itemCount));
+    size_t itemsPerTask = (itemCount + taskCount - 1) / taskCount;
+    if (taskCount == 1) {
+        function(0, 0, itemCount);
+        return;
+    }
+
+    ThreadPool pool(taskCount);
+    std::vector<std::future<void>> results;
+    for (size_t task = 0; task < taskCount; ++task) {
+        size_t first = std::min(itemCount, task * itemsPerTask);
+        size_t last = std::min(itemCount, first + itemsPerTask);
+        results.push_back(pool.submit([&function, task, first, last]() { function(task, first, last); }));
+    }
+    for (std::future<void>& result : results) {
+        result.get();
+    }
+}
+
+/*
+Description:
+    Writes the run of every declaration of the tree into the preorder table of the tree, the runs are split between the tasks.
+*/
+void DeclJoin::assignNodeRuns(const Tree& tree, ASTId ast, size_t taskCount) {
+    const DeclNodeIndex& index = tree.getDeclNodeMultiMap();
+    std::vector<uint32_t>& runs = nodeRuns[ast];
+    runs.assign(tree.getNodeCount(), noRun);
+
+    runTasks(index.keyCount(), taskCount, [&index, &runs](size_t, size_t firstRun, size_t lastRun) {
+        for (size_t run = firstRun; run < lastRun; ++run) {
+            auto [first, last] = index.getRun(static_cast<uint32_t>(run));
+            for (auto it = first; it != last; ++it) {
+                runs[static_cast<uint32_t>(it->second->topologicalOrder)] = static_cast<uint32_t>(run);
+            }
+        }
+    });
+}
+
+/*
+Description:
+    Radix partitions the runs of the index by the top bits of their spread key. Every task counts the partitions of its
+    range of runs, the counts are summed into the start of every task in every partition, then the tasks scatter their runs
+    without synchronization.
+*/
+DeclJoin::Partitions DeclJoin::partition(const DeclNodeIndex& index, int partitionBits, size_t taskCount) {
+    size_t runCount = index.keyCount();
+    size_t partitionCount = size_t{1} << partitionBits;
+    taskCount = std::max<size_t>(1, std::min(taskCount, runCount));
+    auto partitionOf = [partitionBits](uint32_t key) {
+        return partitionBits == 0 ? size_t{0} : static_cast<size_t>(spreadKey(key) >> (64 - partitionBits));
+    };
+
+    // histogram of every task
+    std::vector<std::vector<size_t>> positions(taskCount, std::vector<size_t>(partitionCount, 0));
+    runTasks(runCount, taskCount, [&](size_t task, size_t first, size_t last) {
+        for (size_t run = first; run < last; ++run) {
+            ++positions[task][partitionOf(index.getRunKey(static_cast<uint32_t>(run)))];
+        }
+    });
+
+    Partitions partitions;
+    partitions.bits = partitionBits;
+    partitions.starts.assign(partitionCount + 1, 0);
+    size_t offset = 0;
+    for (size_t partition = 0; partition < partitionCount; ++partition) {
+        partitions.starts[partition] = offset;
+        for (size_t task = 0; task < taskCount; ++task) {
+            size_t count = positions[task][partition];
+            positions[task][partition] = offset;
+            offset += count;
+        }
+    }
+    partitions.starts[partitionCount] = offset;
+
+    // scatter, the tasks cover the same ranges as the histograms
+    partitions.entries.resize(runCount);
+    runTasks(runCount, taskCount, [&](size_t task, size_t first, size_t last) {
+        std::vector<size_t>& taskPositions = positions[task];
+        for (size_t run = first; run < last; ++run) {
+            uint32_t key = index.getRunKey(static_cast<uint32_t>(run));
+            partitions.entries[taskPositions[partitionOf(key)]++] = {key, static_cast<uint32_t>(run)};
+        }
+    });
+    return partitions;
+}
+
+/*
+Description:
+    Joins a range of partitions: the runs of the first tree are put into an open-addressing table, the runs of the second
+    tree probe it, matching runs are written into the partner tables of both trees. Keys are unique within the runs of an
+    index, so every run has at most one partner. Returns the number of matched keys.
+*/
+size_t DeclJoin::joinPartitions(const Partitions& firstPartitions, const Partitions& secondPartitions, size_t firstPartition, size_t lastPartition) {
+    std::vector<KeyRun> table;
+    size_t matchedKeys = 0;
+
+    for (size_t partition = firstPartition; partition < lastPartition; ++partition) {
+        size_t firstBegin = firstPartitions.starts[partition];
+        size_t firstEnd = firstPartitions.starts[partition + 1];
+        size_t secondBegin = secondPartitions.starts[partition];
+        size_t secondEnd = secondPartitions.starts[partition + 1];
+        if (firstBegin == firstEnd || secondBegin == secondEnd) {
+            continue;
+        }
+
+        // the partition bits are the top bits of the spread key, the slots use the bits below them
+        size_t slotCount = 16;
+        int slotBits = 4;
+        while (slotCount < (firstEnd - firstBegin) * 2) {
+            slotCount <<= 1;
+            ++slotBits;
+        }
+        size_t mask = slotCount - 1;
+        int partitionBits = firstPartitions.bits;
+        auto slotOf = [partitionBits, slotBits](uint32_t key) {
+            return static_cast<size_t>((spreadKey(key) << partitionBits) >> (64 - slotBits));
+        };
+
+        table.assign(slotCount, KeyRun{0, noRun});
+        for (size_t position = firstBegin; position < firstEnd; ++position) {
+            const KeyRun& entry = firstPartitions.entries[position];
+            size_t slot = slotOf(entry.key);
+            while (table[slot].run != noRun) {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = entry;
+        }
+
+        for (size_t position = secondBegin; position < secondEnd; ++position) {
+            const KeyRun& entry = secondPartitions.entries[position];
+            for (size_t slot = slotOf(entry.key); table[slot].run != noRun; slot = (slot + 1) & mask) {
+                if (table[slot].key == entry.key) {
+                    partnerRuns[FIRST_AST][table[slot].run] = entry.run;
+                    partnerRuns[SECOND_AST][entry.run] = table[slot].run;
+                    ++matchedKeys;
+                    break;
+                }
+            }
+        }
+    }
+    return matchedKeys;
+}
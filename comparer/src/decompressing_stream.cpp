@@ -0,0 +1,243 @@
+#include "../include/decompressing_stream.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+
+/*
+Description:
+    Starts decompressing the input on a background thread, the input has to stay valid until the stream is destroyed.
+*/
+DecompressingStream::DecompressingStream(std::string_view input, Codec codec) : input(input), codec(codec) {
+    if (!isCodecAvailable(codec)) {
+        throw std::runtime_error(std::string("The comparer was built without support for ") + (codec == GZIP ? "gzip" : "zstd") + " compressed dumps.");
+    }
+
+    worker = std::thread([this]() { decompress(); });
+}
+
+/*
+Description:
+    Stops the background thread, even if the blocks were not consumed.
+*/
+DecompressingStream::~DecompressingStream() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isCancelled = true;
+    }
+    condition.notify_all();
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/*
+Description:
+    Waits for the next decompressed block and moves it into the given string, returns false when the whole input has been
+    decompressed. Errors of the background thread are rethrown here.
+*/
+bool DecompressingStream::next(std::string& block) {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this]() { return !blocks.empty() || isFinished; });
+
+    if (!blocks.empty()) {
+        block.swap(blocks.front());
+        blocks.pop_front();
+        condition.notify_all();
+        return true;
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return false;
+}
+
+/*
+Description:
+    Detects the compression of the contents from their magic number.
+*/
+DecompressingStream::Codec DecompressingStream::detectCodec(std::string_view contents) {
+    static const unsigned char gzipMagic[] = {0x1f, 0x8b};
+    static const unsigned char zstdMagic[] = {0x28, 0xb5, 0x2f, 0xfd};
+
+    if (contents.size() >= sizeof(zstdMagic) && std::memcmp(contents.data(), zstdMagic, sizeof(zstdMagic)) == 0) {
+        return ZSTD;
+    }
+    if (contents.size() >= sizeof(gzipMagic) && std::memcmp(contents.data(), gzipMagic, sizeof(gzipMagic)) == 0) {
+        return GZIP;
+    }
+    return NONE;
+}
+
+/*
+Description:
+    Checks if the comparer was built with the library of the codec.
+*/
+bool DecompressingStream::isCodecAvailable(Codec codec) {
+    switch (codec) {
+#ifdef WITH_ZLIB
+        case GZIP: return true;
+#endif
+#ifdef WITH_ZSTD
+        case ZSTD: return true;
+#endif
+        default: return false;
+    }
+}
+
+/*
+Description:
+    Main function of the background thread, decompresses the input and marks the stream as finished, also on errors.
+*/
+void DecompressingStream::decompress() {
+    std::exception_ptr decompressionError;
+    try {
+        if (codec == GZIP) {
+            decompressGzip();
+        } else {
+            decompressZstd();
+        }
+    } catch (...) {
+        decompressionError = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    error = decompressionError;
+    isFinished = true;
+    condition.notify_all();
+}
+
+/*
+Description:
+    Decompresses gzip input, concatenated gzip members are decompressed one after the other.
+*/
+void DecompressingStream::decompressGzip() {
+#ifdef WITH_ZLIB
+    z_stream stream{};
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        throw std::runtime_error("Could not initialize the gzip decompression.");
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = 0;
+    size_t remainingInput = input.size();
+
+    std::string block;
+    int result = Z_OK;
+    while (true) {
+        block.resize(blockSize);
+        stream.next_out = reinterpret_cast<Bytef*>(&block[0]);
+        stream.avail_out = static_cast<uInt>(blockSize);
+
+        while (stream.avail_out > 0) {
+            if (stream.avail_in == 0 && remainingInput > 0) {
+                stream.avail_in = static_cast<uInt>(std::min<size_t>(remainingInput, 1u << 30));
+                remainingInput -= stream.avail_in;
+            }
+
+            result = inflate(&stream, Z_NO_FLUSH);
+            if (result == Z_STREAM_END) {
+                if (stream.avail_in == 0 && remainingInput == 0) {
+                    break;
+                }
+                inflateReset(&stream); // next gzip member
+            } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                inflateEnd(&stream);
+                throw std::runtime_error("Corrupt gzip compressed dump.");
+            } else if (result == Z_BUF_ERROR && stream.avail_in == 0 && remainingInput == 0) {
+                inflateEnd(&stream);
+                throw std::runtime_error("Unexpected end of the gzip compressed dump.");
+            }
+        }
+
+        block.resize(blockSize - stream.avail_out);
+        if (!block.empty() && !pushBlock(block)) {
+            break;
+        }
+        if (result == Z_STREAM_END && stream.avail_in == 0 && remainingInput == 0) {
+            break;
+        }
+    }
+
+    inflateEnd(&stream);
+#endif
+}
+
+/*
+Description:
+    Decompresses zstd input, concatenated frames are handled by the streaming API.
+*/
+void DecompressingStream::decompressZstd() {
+#ifdef WITH_ZSTD
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    if (!stream) {
+        throw std::runtime_error("Could not initialize the zstd decompression.");
+    }
+
+    ZSTD_inBuffer inBuffer = {input.data(), input.size(), 0};
+    size_t lastResult = 0;
+    std::string block;
+    while (inBuffer.pos < inBuffer.size) {
+        block.resize(blockSize);
+        ZSTD_outBuffer outBuffer = {&block[0], blockSize, 0};
+
+        while (outBuffer.pos < outBuffer.size && inBuffer.pos < inBuffer.size) {
+            lastResult = ZSTD_decompressStream(stream, &outBuffer, &inBuffer);
+            if (ZSTD_isError(lastResult)) {
+                ZSTD_freeDStream(stream);
+                throw std::runtime_error(std::string("Corrupt zstd compressed dump: ") + ZSTD_getErrorName(lastResult));
+            }
+        }
+
+        block.resize(outBuffer.pos);
+        if (!block.empty() && !pushBlock(block)) {
+            ZSTD_freeDStream(stream);
+            return;
+        }
+    }
+
+    // flush the data the decoder still holds for the last frame
+    while (lastResult != 0) {
+        block.resize(blockSize);
+        ZSTD_outBuffer outBuffer = {&block[0], blockSize, 0};
+        lastResult = ZSTD_decompressStream(stream, &outBuffer, &inBuffer);
+        if (ZSTD_isError(lastResult) || outBuffer.pos == 0) {
+            ZSTD_freeDStream(stream);
+            throw std::runtime_error("Unexpected end of the zstd compressed dump.");
+        }
+
+        block.resize(outBuffer.pos);
+        if (!pushBlock(block)) {
+            break;
+        }
+    }
+
+    ZSTD_freeDStream(stream);
+#endif
+}
+
+/*
+Description:
+    Hands the block over to the parser, waits while too many blocks are queued. Returns false if the stream was cancelled.
+*/
+bool DecompressingStream::pushBlock(std::string& block) {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this]() { return blocks.size() < maxQueuedBlocks || isCancelled; });
+    if (isCancelled) {
+        return false;
+    }
+
+    blocks.emplace_back();
+    blocks.back().swap(block);
+    condition.notify_all();
+    return true;
+}
@@ -0,0 +1,85 @@
+#include "../include/difference_buffer.h"
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+/*
+Description:
+    Starts a new step of the traversal, the following differences belong to it. A previous step without differences is reused.
+*/
+void DifferenceBuffer::beginStep(uint64_t order) {
+    if (!steps.empty() && steps.back().firstEntry == entries.size()) {
+        steps.back().order = order;
+        return;
+    }
+    steps.push_back({order, entries.size()});
+}
+
+/*
+Description:
+    Records a node of the current step.
+*/
+void DifferenceBuffer::addNodeToBatch(const Node& node, bool isHighLevel, const std::string& differenceType, const std::string& astOrigin) {
+    entries.push_back({&node, nullptr, getLabel(differenceType), getLabel(astOrigin), isHighLevel});
+}
+
+/*
+Description:
+    Records a relationship of the current step.
+*/
+void DifferenceBuffer::addRelationshipToBatch(const Node& parent, const Node& child) {
+    entries.push_back({&parent, &child, 0, 0, false});
+}
+
+/*
+Description:
+    Returns the number of recorded nodes and relationships.
+*/
+size_t DifferenceBuffer::size() const {
+    return entries.size();
+}
+
+/*
+Description:
+    Writes the recorded differences of all buffers to the wrapper, ordered by the position of their steps in the sequential
+    traversal. Every step was processed by exactly one buffer, its differences are written in the order they were recorded.
+*/
+void DifferenceBuffer::replay(const std::vector<DifferenceBuffer>& buffers, IDatabaseWrapper& dbWrapper) {
+    std::vector<std::tuple<uint64_t, size_t, size_t>> steps; // order, buffer, step
+    for (size_t bufferIndex = 0; bufferIndex < buffers.size(); ++bufferIndex) {
+        for (size_t stepIndex = 0; stepIndex < buffers[bufferIndex].steps.size(); ++stepIndex) {
+            steps.emplace_back(buffers[bufferIndex].steps[stepIndex].order, bufferIndex, stepIndex);
+        }
+    }
+    std::sort(steps.begin(), steps.end());
+
+    for (const auto& [order, bufferIndex, stepIndex] : steps) {
+        const DifferenceBuffer& buffer = buffers[bufferIndex];
+        size_t lastEntry = stepIndex + 1 < buffer.steps.size() ? buffer.steps[stepIndex + 1].firstEntry : buffer.entries.size();
+        for (size_t entryIndex = buffer.steps[stepIndex].firstEntry; entryIndex < lastEntry; ++entryIndex) {
+            const Entry& entry = buffer.entries[entryIndex];
+            if (entry.child) {
+                dbWrapper.addRelationshipToBatch(*entry.node, *entry.child);
+            } else {
+                dbWrapper.addNodeToBatch(*entry.node, entry.isHighLevel, buffer.labels[entry.differenceType], buffer.labels[entry.astOrigin]);
+            }
+        }
+    }
+}
+
+/*
+Description:
+    Returns the index of the label, adds it on first use.
+*/
+uint8_t DifferenceBuffer::getLabel(const std::string& label) {
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (labels[i] == label) {
+            return static_cast<uint8_t>(i);
+        }
+    }
+    if (labels.size() > UINT8_MAX) {
+        throw std::runtime_error("Too many distinct labels in the difference buffer.");
+    }
+    labels.push_back(label);
+    return static_cast<uint8_t>(labels.size() - 1);
+}
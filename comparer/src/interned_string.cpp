@@ -0,0 +1,187 @@
+#include "../include/interned_string.h"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    const size_t poolShardCount = 64;      // independent locks for the parser threads
+    const size_t threadCacheSize = 4096;   // recently used entries of a thread, most lookups are kinds and paths
+
+    // part of the pool, interned entries are stored in a deque so the views used as keys stay valid, acquired entries are
+    // allocated one by one so they can be freed, their ids are handed to the next new entries of the shard
+    struct PoolShard {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, InternedString::Entry*> entries;
+        std::deque<InternedString::Entry> storage;
+        std::vector<uint32_t> freeIds;
+    };
+
+    std::array<PoolShard, poolShardCount>& poolShards() {
+        static std::array<PoolShard, poolShardCount> shards;
+        return shards;
+    }
+
+    PoolShard& shardOf(size_t hash) {
+        return poolShards()[(hash ^ (hash >> 16)) % poolShardCount];
+    }
+
+    std::atomic<uint64_t> nextEntryId{1};
+    std::atomic<size_t> entryCount{0};      // entries in the pool, without the empty string
+
+    const InternedString::Entry* emptyEntry() {
+        static const InternedString::Entry entry{std::string(), std::hash<std::string_view>{}(std::string_view()), 0};
+        return &entry;
+    }
+
+    // id of a new entry of the shard, the caller holds the lock of the shard. Ids of freed entries are reused, so the ids stay
+    // below the number of live entries and the largest id, the free slot of FlatIndex, is never handed out
+    uint32_t takeEntryId(PoolShard& shard) {
+        if (!shard.freeIds.empty()) {
+            uint32_t id = shard.freeIds.back();
+            shard.freeIds.pop_back();
+            return id;
+        }
+        uint64_t id = nextEntryId++;
+        if (id >= std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("The string pool ran out of identifiers.");
+        }
+        return static_cast<uint32_t>(id);
+    }
+}
+
+InternedString::InternedString() : entry(emptyEntry()) {}
+
+InternedString::InternedString(std::string_view value) : entry(intern(value)) {}
+
+InternedString::InternedString(const std::string& value) : entry(intern(value)) {}
+
+InternedString::InternedString(const char* value) : entry(intern(value ? std::string_view(value) : std::string_view())) {}
+
+/*
+Description:
+    Returns the number of distinct strings in the pool, the empty string and freed acquired entries are not counted.
+*/
+size_t InternedString::poolSize() {
+    return entryCount.load();
+}
+
+/*
+Description:
+    Prepares the pool for the given number of additional strings, so bulk interning does not rehash the shards repeatedly.
+*/
+void InternedString::reservePool(size_t count) {
+    for (PoolShard& shard : poolShards()) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.reserve(shard.entries.size() + count / poolShardCount + 1);
+    }
+}
+
+/*
+Description:
+    Returns the entry of the value, adds it to the pool when it is not interned yet. Lookups go through a small cache of
+    the calling thread first, the shard of the pool is only locked on a cache miss.
+*/
+const InternedString::Entry* InternedString::intern(std::string_view value) {
+    if (value.empty()) {
+        return emptyEntry();
+    }
+
+    size_t hash = std::hash<std::string_view>{}(value);
+
+    thread_local std::array<const Entry*, threadCacheSize> threadCache{};
+    const Entry*& cached = threadCache[hash % threadCacheSize];
+    if (cached && cached->hash == hash && cached->value == value) {
+        return cached;
+    }
+
+    PoolShard& shard = shardOf(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.entries.find(value);
+    if (it == shard.entries.end()) {
+        shard.storage.push_back({std::string(value), hash, takeEntryId(shard)});
+        ++entryCount;
+        Entry& newEntry = shard.storage.back();
+        it = shard.entries.emplace(newEntry.value, &newEntry).first;
+    }
+
+    // an acquired entry interned by the constructor is kept for good, only permanent entries are cached
+    it->second->isPermanent = true;
+    cached = it->second;
+    return cached;
+}
+
+/*
+Description:
+    Returns the handle of a value that is already in the pool without adding it, the empty string if it is not there. The handle
+    of an acquired entry is only valid as long as the entry is referenced.
+*/
+InternedString InternedString::find(std::string_view value) {
+    if (value.empty()) {
+        return InternedString();
+    }
+
+    size_t hash = std::hash<std::string_view>{}(value);
+    PoolShard& shard = shardOf(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.entries.find(value);
+    return it == shard.entries.end() ? InternedString() : InternedString(it->second);
+}
+
+/*
+Description:
+    Returns a handle of the value that stays valid until it is released, the entry is shared with interned and other acquired 
+    handles of the same value, so handles still compare by pointer.
+*/
+InternedString InternedString::acquire(std::string_view value) {
+    if (value.empty()) {
+        return InternedString();
+    }
+
+    size_t hash = std::hash<std::string_view>{}(value);
+    PoolShard& shard = shardOf(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.entries.find(value);
+    if (it == shard.entries.end()) {
+        Entry* newEntry = new Entry{std::string(value), hash, takeEntryId(shard)};
+        newEntry->isPermanent = false;
+        ++entryCount;
+        it = shard.entries.emplace(newEntry->value, newEntry).first;
+    }
+
+    ++it->second->references;
+    return InternedString(it->second);
+}
+
+/*
+Description:
+    Releases a handle taken with acquire(), the entry is freed when no acquired handle is left and it was never interned. The id
+    of the freed entry is given to a later entry of the same shard.
+*/
+void InternedString::release(const InternedString& string) {
+    if (string.entry == emptyEntry()) {
+        return;
+    }
+
+    PoolShard& shard = shardOf(string.entry->hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // the entry is alive while it is referenced, the map is only searched to free it
+    Entry* entry = const_cast<Entry*>(string.entry);
+    if (entry->references == 0) {
+        return;
+    }
+    if (--entry->references == 0 && !entry->isPermanent) {
+        shard.entries.erase(entry->value);
+        shard.freeIds.push_back(entry->id);
+        delete entry;
+        --entryCount;
+    }
+}
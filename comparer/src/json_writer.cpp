@@ -0,0 +1,106 @@
+#include "../include/json_writer.h"
+#include <charconv>
+
+/*
+Description:
+    Returns the length of the UTF-8 sequence at the position, 0 if the bytes are not a well-formed sequence. The range of the
+    second byte depends on the lead byte (Unicode Table 3-7), which rules out overlong encodings, surrogates and code points
+    above U+10FFFF, the other bytes are continuation bytes.
+*/
+static size_t getSequenceLength(std::string_view value, size_t position) {
+    unsigned char lead = static_cast<unsigned char>(value[position]);
+    size_t length = 0;
+    unsigned char secondMin = 0x80;
+    unsigned char secondMax = 0xbf;
+    if (lead >= 0xc2 && lead <= 0xdf) {
+        length = 2;
+    } else if (lead >= 0xe0 && lead <= 0xef) {
+        length = 3;
+        secondMin = lead == 0xe0 ? 0xa0 : 0x80;
+        secondMax = lead == 0xed ? 0x9f : 0xbf;
+    } else if (lead >= 0xf0 && lead <= 0xf4) {
+        length = 4;
+        secondMin = lead == 0xf0 ? 0x90 : 0x80;
+        secondMax = lead == 0xf4 ? 0x8f : 0xbf;
+    }
+    if (length == 0 || position + length > value.size()) {
+        return 0;
+    }
+
+    unsigned char second = static_cast<unsigned char>(value[position + 1]);
+    if (second < secondMin || second > secondMax) {
+        return 0;
+    }
+    for (size_t i = 2; i < length; ++i) {
+        if ((static_cast<unsigned char>(value[position + i]) & 0xc0) != 0x80) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+/*
+Description:
+    Appends the value as a quoted JSON string. Quotes, backslashes and control characters are escaped, bytes that are not
+    valid UTF-8 are replaced with U+FFFD. Runs of characters that need no escaping are appended at once.
+*/
+void JsonWriter::appendString(std::string& out, std::string_view value) {
+    static const char hexDigits[] = "0123456789abcdef";
+    out += '"';
+    size_t runStart = 0;
+    size_t position = 0;
+    while (position < value.size()) {
+        unsigned char character = static_cast<unsigned char>(value[position]);
+        if (character >= 0x20 && character != '"' && character != '\\' && character < 0x80) {
+            ++position;
+            continue;
+        }
+        if (character >= 0x80) {
+            size_t length = getSequenceLength(value, position);
+            if (length != 0) {
+                position += length;
+                continue;
+            }
+        }
+
+        out.append(value.data() + runStart, position - runStart);
+        switch (character) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (character < 0x20) {
+                    out += "\\u00";
+                    out += hexDigits[character >> 4];
+                    out += hexDigits[character & 0xf];
+                } else {
+                    out += "\\ufffd";
+                }
+        }
+        runStart = ++position;
+    }
+    out.append(value.data() + runStart, position - runStart);
+    out += '"';
+}
+
+/*
+Description:
+    Appends the integer.
+*/
+void JsonWriter::appendNumber(std::string& out, long long value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr - digits);
+}
+
+/*
+Description:
+    Appends true or false.
+*/
+void JsonWriter::appendBool(std::string& out, bool value) {
+    out += value ? "true" : "false";
+}
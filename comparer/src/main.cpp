@@ -1,8 +1,23 @@
 #include "../include/tree_comparer.h"
 #include "../include/tree.h"
+#include "../include/comparer_daemon.h"
+#include "../include/batch_comparer.h"
+#include "../include/counting_database_wrapper.h"
+#include "../include/csv_import_writer.h"
+#include "../include/null_database_wrapper.h"
+#include "../include/utils.h"
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
 
-bool initializeDb(Neo4jDatabaseWrapper& dbWrapper) {
+bool initializeDb(IDatabaseWrapper& dbWrapper) {
     try {
         dbWrapper.clearDatabase();
         dbWrapper.createIndices();
@@ -13,34 +28,234 @@ bool initializeDb(Neo4jDatabaseWrapper& dbWrapper) {
     }
 }
 
+// settings of the outputs of the differences
+struct SinkSettings {
+    const char* neo4jPassword = nullptr;
+    size_t connectionCount = 4;          // connections of the Neo4j writers
+    std::string importDirectory;         // directory of the CSV import files
+    size_t importPartBytes = 0;          // maximum size of a CSV part file
+};
+
+/*
+Description:
+    Creates the output of the differences: the Neo4j database, the CSV files of an offline import, the null sink that drops
+    them, or the count sink that only counts them by type and AST. The null and count sinks measure the comparison without
+    a database.
+*/
+std::unique_ptr<IDatabaseWrapper> createSink(const std::string& sinkName, const SinkSettings& settings) {
+    if (sinkName == "neo4j") {
+        return std::make_unique<Neo4jDatabaseWrapper>("http://localhost:7474", "neo4j", settings.neo4jPassword, settings.connectionCount);
+    }
+    if (sinkName == "csv") {
+        return std::make_unique<CsvImportWriter>(settings.importDirectory, settings.importPartBytes);
+    }
+    if (sinkName == "null") {
+        return std::make_unique<NullDatabaseWrapper>();
+    }
+    if (sinkName == "count") {
+        return std::make_unique<CountingDatabaseWrapper>();
+    }
+    throw std::invalid_argument("Unknown sink: " + sinkName + ", expected neo4j, csv, null or count");
+}
+
+/*
+Description:
+    Prints the totals of the count sink, other sinks print nothing.
+*/
+void printSinkSummary(IDatabaseWrapper& dbWrapper) {
+    if (auto* counter = dynamic_cast<CountingDatabaseWrapper*>(&dbWrapper)) {
+        counter->printSummary(std::cout);
+    }
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <first_ast_file> <second_ast_file>" << std::endl;
+    // the --sink option selects the output of the differences, the remaining arguments select the mode
+    std::vector<std::string> arguments;
+    std::string sinkName = "neo4j";
+    for (int i = 0; i < argc; ++i) {
+        if (std::string(argv[i]) == "--sink" && i + 1 < argc) {
+            sinkName = argv[++i];
+        } else {
+            arguments.push_back(argv[i]);
+        }
+    }
+    const size_t argumentCount = arguments.size();
+
+    // daemon mode keeps the given baselines and the database connection resident and serves comparisons on a Unix socket
+    const bool isDaemon = argumentCount >= 3 && arguments[1] == "--daemon";
+    // batch mode compares the pairs of dumps listed in a manifest in one process
+    const bool isBatch = argumentCount == 3 && arguments[1] == "--batch";
+    if (argumentCount != 3 && !isDaemon) {
+        std::cerr << "Usage: " << arguments[0] << " [--sink neo4j|csv|null|count] <first_ast_file> <second_ast_file>" << std::endl;
+        std::cerr << "       " << arguments[0] << " [--sink neo4j|csv|null|count] --daemon <socket_path> [baseline_ast_file ...]" << std::endl;
+        std::cerr << "       " << arguments[0] << " [--sink neo4j|csv|null|count] --batch <manifest_file>" << std::endl;
         return EXIT_FAILURE;
     }
+    const bool isProfiling = sinkName == "null" || sinkName == "count";
 
-    const std::string firstFilePath = argv[1];
-    const std::string secondFilePath = argv[2];
+    const std::string firstFilePath = arguments[1];
+    const std::string secondFilePath = arguments[2];
     const char* neo4jPassword = std::getenv("NEO4J_PASSWORD");
-    if (!neo4jPassword) {
+    if (!neo4jPassword && sinkName == "neo4j") {
         std::cerr << "NEO4J_PASSWORD environment variable not set, using default value" << std::endl;
         neo4jPassword = "default_password";
     }
 
-    try {
-        Tree firstStandardAST(firstFilePath);
-        Tree secondStandardAST(secondFilePath);
+    // optional cache of built trees, a baseline compared against many candidates is parsed only once
+    const char* snapshotDirectoryVariable = std::getenv("AST_SNAPSHOT_DIR");
+    const std::string snapshotDirectory = snapshotDirectoryVariable ? snapshotDirectoryVariable : "";
 
+    // optional memory limit, dumps larger than the memory are compared out-of-core with the nodes paged to the spill directory
+    const char* memoryLimitVariable = std::getenv("AST_MEMORY_LIMIT_MB");
+    const char* spillDirectoryVariable = std::getenv("AST_SPILL_DIR");
+    const bool isOutOfCore = memoryLimitVariable != nullptr;
+    TreeSpill::Options spillOptions;
+    if (isOutOfCore) {
+        int memoryLimit = 0;
+        if (!Utils::parseInt(memoryLimitVariable, memoryLimit) || memoryLimit <= 0) {
+            std::cerr << "AST_MEMORY_LIMIT_MB has to be a positive number of megabytes" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (!snapshotDirectory.empty()) {
+            std::cerr << "AST_SNAPSHOT_DIR is ignored for out-of-core comparisons" << std::endl;
+        }
+        spillOptions.directory = spillDirectoryVariable ? spillDirectoryVariable : "";
+        spillOptions.memoryLimit = static_cast<size_t>(memoryLimit) * 1024 * 1024 / 2; // shared by the two trees
+    }
+    // optional number of comparison threads, all hardware threads by default, 1 compares sequentially
+    const char* compareThreadsVariable = std::getenv("AST_COMPARE_THREADS");
+    int compareThreads = 0;
+    if (compareThreadsVariable && (!Utils::parseInt(compareThreadsVariable, compareThreads) || compareThreads < 0)) {
+        std::cerr << "AST_COMPARE_THREADS has to be a non-negative number of threads" << std::endl;
+        return EXIT_FAILURE;
+    }
+    // optional number of Neo4j connections, node batches are sent concurrently on all of them
+    const char* connectionsVariable = std::getenv("AST_NEO4J_CONNECTIONS");
+    int connectionCount = 4;
+    if (connectionsVariable && (!Utils::parseInt(connectionsVariable, connectionCount) || connectionCount <= 0)) {
+        std::cerr << "AST_NEO4J_CONNECTIONS has to be a positive number of connections" << std::endl;
+        return EXIT_FAILURE;
+    }
+    // output of the csv sink, the part files of the offline import are at most AST_IMPORT_PART_MB large
+    const char* importDirectoryVariable = std::getenv("AST_IMPORT_DIR");
+    const char* importPartVariable = std::getenv("AST_IMPORT_PART_MB");
+    int importPartSize = 1024;
+    if (importPartVariable && (!Utils::parseInt(importPartVariable, importPartSize) || importPartSize <= 0)) {
+        std::cerr << "AST_IMPORT_PART_MB has to be a positive number of megabytes" << std::endl;
+        return EXIT_FAILURE;
+    }
+    SinkSettings sinkSettings;
+    sinkSettings.neo4jPassword = neo4jPassword;
+    sinkSettings.connectionCount = static_cast<size_t>(connectionCount);
+    sinkSettings.importDirectory = importDirectoryVariable ? importDirectoryVariable : "neo4j-import";
+    sinkSettings.importPartBytes = static_cast<size_t>(importPartSize) * 1024 * 1024;
+
+    auto loadTree = [&snapshotDirectory, &spillOptions, isOutOfCore](const std::string& filePath) {
+        return isOutOfCore ? std::make_unique<Tree>(filePath, spillOptions) : std::make_unique<Tree>(filePath, 0, snapshotDirectory);
+    };
+
+    if (isBatch) {
+        // optional memory budget of the running pairs, half of the physical memory by default
+        const char* batchMemoryVariable = std::getenv("AST_BATCH_MEMORY_MB");
+        BatchComparer::Options batchOptions;
+        batchOptions.threadCount = static_cast<unsigned int>(compareThreads);
+        if (batchMemoryVariable) {
+            int batchMemory = 0;
+            if (!Utils::parseInt(batchMemoryVariable, batchMemory) || batchMemory <= 0) {
+                std::cerr << "AST_BATCH_MEMORY_MB has to be a positive number of megabytes" << std::endl;
+                return EXIT_FAILURE;
+            }
+            batchOptions.memoryLimit = static_cast<size_t>(batchMemory) * 1024 * 1024;
+        } else {
+            long pages = sysconf(_SC_PHYS_PAGES);
+            long pageSize = sysconf(_SC_PAGE_SIZE);
+            batchOptions.memoryLimit = pages > 0 && pageSize > 0 ? static_cast<size_t>(pages) * static_cast<size_t>(pageSize) / 2 : 0;
+        }
+        if (isOutOfCore) {
+            // an out-of-core tree keeps its nodes within its share of the memory limit
+            batchOptions.estimateMemory = [&spillOptions](const std::string&) { return spillOptions.memoryLimit; };
+        }
+
+        // the pairs run in parallel, a tree is built by a single thread
+        auto loadBatchTree = [&snapshotDirectory, &spillOptions, isOutOfCore](const std::string& filePath) {
+            return isOutOfCore ? std::make_unique<Tree>(filePath, spillOptions) : std::make_unique<Tree>(filePath, 1, snapshotDirectory);
+        };
+
+        try {
+            std::vector<BatchComparer::Pair> pairs = BatchComparer::readManifest(secondFilePath);
+            std::unique_ptr<IDatabaseWrapper> dbWrapper = createSink(sinkName, sinkSettings);
+            if (!initializeDb(*dbWrapper)) {
+                std::cerr << "Failed to connect to Neo4j database. Terminating program." << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            BatchComparer batch(*dbWrapper, loadBatchTree, batchOptions);
+            BatchComparer::Report report = batch.run(pairs);
+            std::cout << "Compared " << report.pairs << " pairs (" << report.failed << " failed) in " << report.seconds << " s, "
+                      << report.getPairsPerMinute() << " pairs/minute, " << report.differences << " differences" << std::endl;
+            printSinkSummary(*dbWrapper);
+            return report.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (isDaemon) {
+        try {
+            std::unique_ptr<IDatabaseWrapper> dbWrapper = createSink(sinkName, sinkSettings);
+            if (!initializeDb(*dbWrapper)) {
+                std::cerr << "Failed to connect to Neo4j database. Terminating program." << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            ComparerDaemon daemon(secondFilePath, *dbWrapper, loadTree, static_cast<unsigned int>(compareThreads));
+            for (size_t i = 3; i < argumentCount; ++i) {
+                daemon.loadBaseline(arguments[i]);
+            }
+            daemon.run();
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    try {
         // db wrapper
-        Neo4jDatabaseWrapper dbWrapper("http://localhost:7474", "neo4j", neo4jPassword);
-        if (!initializeDb(dbWrapper)) {
+        std::unique_ptr<IDatabaseWrapper> dbWrapper = createSink(sinkName, sinkSettings);
+        auto start = std::chrono::steady_clock::now();
+
+        // both trees are built concurrently while the database is initialized on the main thread,
+        // exceptions of the loaders are rethrown by get(), pending loaders are joined by the future destructors
+        // each loader builds its tree with half of the hardware threads, so the two builds do not compete for the cores
+        unsigned int loaderThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+        auto loadPairTree = [&snapshotDirectory, &spillOptions, isOutOfCore, loaderThreads](const std::string& filePath) {
+            return isOutOfCore ? std::make_unique<Tree>(filePath, spillOptions) : std::make_unique<Tree>(filePath, loaderThreads, snapshotDirectory);
+        };
+        auto firstASTLoader = std::async(std::launch::async, [&firstFilePath, &loadPairTree]() { return loadPairTree(firstFilePath); });
+        auto secondASTLoader = std::async(std::launch::async, [&secondFilePath, &loadPairTree]() { return loadPairTree(secondFilePath); });
+
+        bool isDbInitialized = initializeDb(*dbWrapper);
+        std::unique_ptr<Tree> firstStandardAST = firstASTLoader.get();
+        std::unique_ptr<Tree> secondStandardAST = secondASTLoader.get();
+
+        if (!isDbInitialized) {
             std::cerr << "Failed to connect to Neo4j database. Terminating program." << std::endl; 
             return EXIT_FAILURE;
         }
 
-        TreeComparer comparer(firstStandardAST, secondStandardAST, dbWrapper);
+        auto loaded = std::chrono::steady_clock::now();
+        TreeComparer comparer(*firstStandardAST, *secondStandardAST, *dbWrapper, static_cast<unsigned int>(compareThreads));
         comparer.printDifferences();
-        
+
+        if (isProfiling) {
+            auto compared = std::chrono::steady_clock::now();
+            std::cout << "Loaded in " << std::chrono::duration_cast<std::chrono::milliseconds>(loaded - start).count() << " ms, compared in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(compared - loaded).count() << " ms" << std::endl;
+            printSinkSummary(*dbWrapper);
+        }
+
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return EXIT_FAILURE;
@@ -0,0 +1,94 @@
+#include "../include/mapped_file.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+Description:
+    Maps the given file read-only into memory, the contents can be tokenized in place without copying them into
+    std::string objects line by line. An empty file results in an empty view.
+*/
+MappedFile::MappedFile(const std::string& fileName) {
+#ifdef _WIN32
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + fileName);
+    }
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    fallbackBuffer = contents.str();
+    mappedData = fallbackBuffer.data();
+    mappedSize = fallbackBuffer.size();
+#else
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file: " + fileName);
+    }
+
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not read the size of file: " + fileName);
+    }
+
+    mappedSize = static_cast<size_t>(fileStat.st_size);
+    if (mappedSize > 0) {
+        void* mapping = ::mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Could not map file into memory: " + fileName);
+        }
+
+        // the file is parsed front to back exactly once
+        ::madvise(mapping, mappedSize, MADV_SEQUENTIAL);
+        mappedData = static_cast<const char*>(mapping);
+    }
+
+    ::close(fd); // the mapping stays valid after closing the descriptor
+#endif
+}
+
+/*
+Description:
+    Unmaps the file.
+*/
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mappedData) {
+        ::munmap(const_cast<char*>(mappedData), mappedSize);
+    }
+#endif
+}
+
+/*
+Description:
+    Returns the pointer to the first byte of the file.
+*/
+const char* MappedFile::data() const {
+    return mappedData;
+}
+
+/*
+Description:
+    Returns the size of the file in bytes.
+*/
+size_t MappedFile::size() const {
+    return mappedSize;
+}
+
+/*
+Description:
+    Returns the whole content of the file as a view.
+*/
+std::string_view MappedFile::view() const {
+    return mappedData ? std::string_view(mappedData, mappedSize) : std::string_view();
+}
@@ -1,15 +1,18 @@
 #include "../include/neo4j_database_wrapper.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <nlohmann/json.hpp>
+#include "../include/json_writer.h"
 #include "../include/utils.h"
 #include <curl/curl.h>
 #include <iomanip>
 
 using json = nlohmann::json;
 
-Neo4jDatabaseWrapper::Neo4jDatabaseWrapper(const std::string& uri, const std::string& username, const std::string& password)
-    : dbUri(uri + "/db/neo4j/tx/commit") {
+Neo4jDatabaseWrapper::Neo4jDatabaseWrapper(const std::string& uri, const std::string& username, const std::string& password, size_t connectionCount)
+    : dbUri(uri + "/db/neo4j/tx/commit"), scheduler(2 * std::max<size_t>(connectionCount, 1)) {
     // initialize curl
     curl_global_init(CURL_GLOBAL_DEFAULT);
     curl = curl_easy_init();
@@ -18,9 +21,20 @@ Neo4jDatabaseWrapper::Neo4jDatabaseWrapper(const std::string& uri, const std::st
     std::string credentials = username + ":" + password;
     std::string encoded_credentials = Utils::base64Encode(credentials);
     authHeader = "Authorization: Basic " + encoded_credentials;
+
+    // batches are sent by the writer threads while the comparison fills the next one
+    for (size_t i = 0; i < std::max<size_t>(connectionCount, 1); ++i) {
+        writers.emplace_back(&Neo4jDatabaseWrapper::writerLoop, this);
+    }
 }
 
 Neo4jDatabaseWrapper::~Neo4jDatabaseWrapper() {
+    // the writers send the queued batches before they stop
+    scheduler.stop();
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+
     if (curl) {
         curl_easy_cleanup(curl);
     }
@@ -30,99 +44,148 @@ Neo4jDatabaseWrapper::~Neo4jDatabaseWrapper() {
 /*
 Description:
     Adds a node to the batch for later execution in the Neo4j database, with the specified difference type and AST origin.
+    The node is serialized straight into the buffer of the batch.
 */
 void Neo4jDatabaseWrapper::addNodeToBatch(const Node& node, bool isHighLevel, const std::string& differenceType, const std::string& astOrigin) {
-    // create a JSON object for the node
-    json nodeJson = {
-        {"enhancedKey", node.enhancedKey},
-        {"topologicalOrder", node.topologicalOrder},
-        {"type", node.type},
-        {"kind", node.kind},
-        {"usr", node.usr},
-        {"path", node.path},
-        {"lineNumber", node.lineNumber},
-        {"columnNumber", node.columnNumber},
-        {"isHighLevel", isHighLevel},
-        {"differenceType", differenceType},
-        {"astOrigin", astOrigin}
-    };
-
-    // add node JSON to the batch
-    nodeBatch.push_back(nodeJson);
+    uint64_t id = 0;
+    if (!nodeIds.addNode(node, differenceType, astOrigin, id)) {
+        return; // written before, its properties are the same
+    }
 
-    // if the batch size exceeds 1000, execute the batch
-    if (nodeBatch.size() >= 3000 && !executeBatch()) {
-        std::cerr << "Execution failed for node batch." << std::endl;
+    std::string& out = nodeBatch;
+    out += nodeBatchSize == 0 ? "{\"id\":" : ",{\"id\":";
+    JsonWriter::appendNumber(out, static_cast<long long>(id));
+    out += ",\"enhancedKey\":";
+    JsonWriter::appendString(out, node.enhancedKey.str());
+    out += ",\"topologicalOrder\":";
+    JsonWriter::appendNumber(out, node.topologicalOrder);
+    out += ",\"type\":";
+    JsonWriter::appendNumber(out, node.type);
+    out += ",\"kind\":";
+    JsonWriter::appendString(out, node.kind.str());
+    out += ",\"usr\":";
+    JsonWriter::appendString(out, node.usr.str());
+    out += ",\"path\":";
+    JsonWriter::appendString(out, node.path.str());
+    out += ",\"lineNumber\":";
+    JsonWriter::appendNumber(out, node.lineNumber);
+    out += ",\"columnNumber\":";
+    JsonWriter::appendNumber(out, node.columnNumber);
+    out += ",\"isHighLevel\":";
+    JsonWriter::appendBool(out, isHighLevel);
+    out += ",\"differenceType\":";
+    JsonWriter::appendString(out, differenceType);
+    out += ",\"astOrigin\":";
+    JsonWriter::appendString(out, astOrigin);
+    out += ",\"comparison\":";
+    JsonWriter::appendString(out, comparison);
+    out += '}';
+
+    // a full batch is handed to the writer
+    if (++nodeBatchSize >= batchSize) {
+        submitBatch();
     }
 }
 
 /*
 Description:
-    Adds a relationship to the batch for later execution in the Neo4j database.
+    Adds a relationship to the batch for later execution in the Neo4j database, serialized straight into the buffer of the batch.
+    A relationship without both of its nodes written, or written before, is skipped.
 */
 void Neo4jDatabaseWrapper::addRelationshipToBatch(const Node& parent, const Node& child) {
-    // create a JSON object for the relationship
-    json relationshipJson = {
-        {"parentKey", parent.enhancedKey},
-        {"parentOrder", parent.topologicalOrder},
-        {"childKey", child.enhancedKey},
-        {"childOrder", child.topologicalOrder}
-    };
+    uint64_t parentId = 0;
+    uint64_t childId = 0;
+    if (!nodeIds.getRelationshipIds(parent, child, parentId, childId)) {
+        return;
+    }
 
-    // add relationship JSON to the batch
-    relationshipBatch.push_back(relationshipJson);
+    std::string& out = relationshipBatch;
+    out += relationshipBatchSize == 0 ? "{\"parentId\":" : ",{\"parentId\":";
+    JsonWriter::appendNumber(out, static_cast<long long>(parentId));
+    out += ",\"childId\":";
+    JsonWriter::appendNumber(out, static_cast<long long>(childId));
+    out += '}';
 
-    // if the batch size exceeds 1000, execute the batch
-    if (relationshipBatch.size() >= 3000 && !executeBatch()) {
-        std::cerr << "Execution failed for relationship batch." << std::endl;
+    // a full batch is handed to the writer
+    if (++relationshipBatchSize >= batchSize) {
+        submitBatch();
     }
 }
 
 /*
 Description:
-    Executes the current batch of nodes and relationships in the Neo4j database.
+    Hands the current batches to the writers, the nodes first, the relationships wait for them. If the queue is full, waits
+    until a writer takes the next batch. Batches are dropped while the circuit breaker is active.
 */
-bool Neo4jDatabaseWrapper::executeBatch() {
+void Neo4jDatabaseWrapper::submitBatch() {
     if (isCircuitBreakerActive) {
-        return false;
+        nodeBatch.clear();
+        relationshipBatch.clear();
+        nodeBatchSize = 0;
+        relationshipBatchSize = 0;
+        return;
     }
 
-    if (nodeBatch.empty() && relationshipBatch.empty()) {
-        return true; // nothing to execute
+    if (nodeBatchSize != 0) {
+        nodeBatch = scheduler.submitNodes(std::move(nodeBatch));
+        nodeBatchSize = 0;
     }
+    if (relationshipBatchSize != 0) {
+        relationshipBatch = scheduler.submitRelationships(std::move(relationshipBatch));
+        relationshipBatchSize = 0;
+    }
+}
 
-    json requestBody = {
-        {"statements", json::array()}
-    };
-
-    if (!nodeBatch.empty()) {
-        json nodeStatement = {
-            {"statement", "UNWIND $nodes AS node "
-                          "CREATE (n:Node {enhancedKey: node.enhancedKey, type: node.type, kind: node.kind, usr: node.usr, "
-                          "path: node.path, lineNumber: node.lineNumber, columnNumber: node.columnNumber, "
-                          "topologicalOrder: node.topologicalOrder, isHighLevel: node.isHighLevel, diffType: node.differenceType, ast: node.astOrigin})"},
-            {"parameters", {{"nodes", nodeBatch}}}
-        };
-        requestBody["statements"].push_back(nodeStatement);
+/*
+Description:
+    Sends the queued batches on its own connection until the wrapper is destroyed.
+*/
+void Neo4jDatabaseWrapper::writerLoop() {
+    CURL* connection = curl_easy_init();
+    std::string request;                 // request body, reused for every batch of the writer
+    BatchScheduler::Batch batch;
+    while (scheduler.take(batch)) {
+        if (!executeBatch(connection, batch, request)) {
+            std::cerr << "Execution failed for " << (batch.nodes.empty() ? "relationship" : "node") << " batch." << std::endl;
+        }
+        scheduler.finish(batch);
+    }
+    if (connection) {
+        curl_easy_cleanup(connection);
     }
+}
 
-    if (!relationshipBatch.empty()) {
-        json relationshipStatement = {
-            {"statement", "UNWIND $relationships AS rel "
-                          "MATCH (a:Node {enhancedKey: rel.parentKey, topologicalOrder: rel.parentOrder}) "
-                          "WITH a, rel "
-                          "MATCH (b:Node {enhancedKey: rel.childKey, topologicalOrder: rel.childOrder}) "
-                          "CREATE (a)-[:HAS_CHILD]->(b)"},
-            {"parameters", {{"relationships", relationshipBatch}}}
-        };
-        requestBody["statements"].push_back(relationshipStatement);
+/*
+Description:
+    Executes a batch of nodes or relationships in the Neo4j database. The request is assembled in the buffer around the
+    serialized batch.
+*/
+bool Neo4jDatabaseWrapper::executeBatch(CURL* connection, const BatchScheduler::Batch& batch, std::string& request) {
+    if (isCircuitBreakerActive) {
+        return false;
     }
 
-    // serialize requestBody to a string
-    std::string queryJson = requestBody.dump();
+    request.clear();
+    if (!batch.nodes.empty()) {
+        request += "{\"statements\":[{\"statement\":\"UNWIND $nodes AS node "
+                   "MERGE (n:Node {id: node.id}) "
+                   "ON CREATE SET n.enhancedKey = node.enhancedKey, n.type = node.type, n.kind = node.kind, n.usr = node.usr, "
+                   "n.path = node.path, n.lineNumber = node.lineNumber, n.columnNumber = node.columnNumber, "
+                   "n.topologicalOrder = node.topologicalOrder, n.isHighLevel = node.isHighLevel, n.diffType = node.differenceType, "
+                   "n.ast = node.astOrigin, n.comparison = node.comparison\",\"parameters\":{\"nodes\":[";
+        request += batch.nodes;
+    } else {
+        request += "{\"statements\":[{\"statement\":\"UNWIND $relationships AS rel "
+                   "MATCH (a:Node {id: rel.parentId}) "
+                   "MATCH (b:Node {id: rel.childId}) "
+                   "CREATE (a)-[:HAS_CHILD]->(b)\",\"parameters\":{\"relationships\":[";
+        request += batch.relationships;
+    }
+    request += "]}}]}";
 
+    const std::string& queryJson = request;
     // send request
-    if (!sendRequest(queryJson)) {
+    if (!sendRequest(connection, queryJson)) {
         consecutiveFailures++;
         std::cerr << "Failed to execute batch. Consecutive failures: " << consecutiveFailures << std::endl;
 
@@ -130,30 +193,25 @@ bool Neo4jDatabaseWrapper::executeBatch() {
             isCircuitBreakerActive = true;
             std::cerr << "Circuit breaker activated after " << failureThreshold << " failures." << std::endl;
         }
-
-        nodeBatch.clear();
-        relationshipBatch.clear();
         return false;
     }
 
     // reset state on success
     consecutiveFailures = 0;
-    nodeBatch.clear();
-    relationshipBatch.clear();
     return true;
 }
 
 /*
 Description:
-    Sends a request to the Neo4j database with the specified query JSON.
+    Sends a request to the Neo4j database with the specified query JSON on the connection.
 */
-bool Neo4jDatabaseWrapper::sendRequest(const std::string& queryJson) {
+bool Neo4jDatabaseWrapper::sendRequest(CURL* connection, const std::string& queryJson) {
     if (isCircuitBreakerActive) {
         std::cerr << "Circuit breaker active. Skipping request." << std::endl;
         return false;
     }
 
-    if (!curl) {
+    if (!connection) {
         std::cerr << "CURL initialization failed" << std::endl;
         return false;
     }
@@ -162,19 +220,21 @@ bool Neo4jDatabaseWrapper::sendRequest(const std::string& queryJson) {
     headers = curl_slist_append(headers, "Content-Type: application/json");
     headers = curl_slist_append(headers, authHeader.c_str());
 
-    curl_easy_setopt(curl, CURLOPT_URL, dbUri.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, queryJson.c_str());
+    curl_easy_setopt(connection, CURLOPT_URL, dbUri.c_str());
+    curl_easy_setopt(connection, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(connection, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(queryJson.size()));
+    curl_easy_setopt(connection, CURLOPT_POSTFIELDS, queryJson.c_str());
 
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
+    curl_easy_setopt(connection, CURLOPT_CONNECTTIMEOUT, 5L);
+    curl_easy_setopt(connection, CURLOPT_TIMEOUT, 5L);
+    curl_easy_setopt(connection, CURLOPT_NOSIGNAL, 1L); // several connections send from different threads
 
     // retry mechanism
     int retryCount = 0;
     const int maxRetries = 3;
     CURLcode res;
     do {
-        res = curl_easy_perform(curl);
+        res = curl_easy_perform(connection);
         if (res != CURLE_OK) {
             std::cerr << "CURL request failed: " << curl_easy_strerror(res)
                       << " - Retrying (" << retryCount + 1 << "/" << maxRetries << ")" << std::endl;
@@ -200,13 +260,15 @@ Description:
     Clears the Neo4j database by deleting all nodes and relationships.
 */
 void Neo4jDatabaseWrapper::clearDatabase() {
+    scheduler.drain();
+    nodeIds.clearWrittenNodes();
     json query = {
         {"statements", {{
             {"statement", "MATCH (n) DETACH DELETE n"}
         }}}
     };
 
-    if (sendRequest(query.dump())) {
+    if (sendRequest(curl, query.dump())) {
         std::cout << "=== INSIDE IF\n";
         std::cout << "Database cleared successfully." << std::endl;
     } else {
@@ -219,19 +281,15 @@ Description:
     Creates the required indices in the Neo4j database.
 */
 void Neo4jDatabaseWrapper::createIndices() {
-    std::vector<std::string> indexStatements = {
-        "CREATE INDEX IF NOT EXISTS FOR (n:Node) ON (n.enhancedKey)",
-        "CREATE INDEX IF NOT EXISTS FOR (n:Node) ON (n.differenceType)",
-        "CREATE INDEX IF NOT EXISTS FOR (n:Node) ON (n.astOrigin)"
-    };
-
-    for (const auto& statement : indexStatements) {
+    scheduler.drain();
+    // the ids are looked up by every relationship, the other properties by the queries of the results
+    for (const auto& statement : Neo4jNodeIds::getSchemaStatements()) {
         json query = {
             {"statements", {{
                 {"statement", statement}
             }}}
         };
-        if (!sendRequest(query.dump())) {
+        if (!sendRequest(curl, query.dump())) {
             throw std::runtime_error("Failed to create indices in the Neo4j database.");
         }
     }
@@ -241,13 +299,19 @@ void Neo4jDatabaseWrapper::createIndices() {
 
 /*
 Description:
-    Finalizes the database wrapper by executing any remaining batches.
+    Names the comparison of the following differences, the name is stored with the nodes. The nodes of every comparison get
+    ids of their own, so the relationships of different comparisons in one database stay apart.
+*/
+void Neo4jDatabaseWrapper::beginComparison(const std::string& name) {
+    comparison = name;
+    nodeIds.beginComparison();
+}
+
+/*
+Description:
+    Finalizes the database wrapper by executing any remaining batches, returns when all batches are written.
 */
 void Neo4jDatabaseWrapper::finalize() {
-    // execute any remaining batches
-    if ((!nodeBatch.empty() || !relationshipBatch.empty()) && !executeBatch()) {
-        std::cerr << "Failed to execute remaining batch." << std::endl;
-        nodeBatch.clear();
-        relationshipBatch.clear();
-    }
+    submitBatch();
+    scheduler.drain();
 }
\ No newline at end of file
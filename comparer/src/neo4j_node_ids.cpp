@@ -0,0 +1,116 @@
+#include "../include/neo4j_node_ids.h"
+#include <stdexcept>
+
+/*
+Description:
+    Sets the id of a node reported with the difference type and AST, the node becomes the child of a following relationship.
+    Returns false if the node was already written with them, it must not be written again.
+*/
+bool Neo4jNodeIds::addNode(const Node& node, const std::string& differenceType, const std::string& astOrigin, uint64_t& id) {
+    lastNode = &node;
+    lastLabel = getLabel(differenceType, astOrigin);
+    id = getId(lastLabel, node.topologicalOrder);
+    return testAndSet(writtenNodes[lastLabel], node.topologicalOrder);
+}
+
+/*
+Description:
+    Sets the ids of both ends of a relationship. Returns false if the relationship has to be skipped: its child is not the
+    node added last, its parent was not written with the same difference type and AST, or the relationship of the child
+    was already written.
+*/
+bool Neo4jNodeIds::getRelationshipIds(const Node& parent, const Node& child, uint64_t& parentId, uint64_t& childId) {
+    if (&child != lastNode || !isSet(writtenNodes[lastLabel], parent.topologicalOrder) ||
+        !testAndSet(linkedNodes[lastLabel], child.topologicalOrder)) {
+        return false;
+    }
+    parentId = getId(lastLabel, parent.topologicalOrder);
+    childId = getId(lastLabel, child.topologicalOrder);
+    return true;
+}
+
+/*
+Description:
+    Starts the ids of the next comparison, the nodes of different comparisons in one database never share an id.
+*/
+void Neo4jNodeIds::beginComparison() {
+    ++comparisonNumber;
+    clearWrittenNodes();
+}
+
+/*
+Description:
+    Forgets the written nodes, called when the written differences are removed, so the nodes are written again.
+*/
+void Neo4jNodeIds::clearWrittenNodes() {
+    lastNode = nullptr;
+    for (size_t label = 0; label < labels.size(); ++label) {
+        writtenNodes[label].clear();
+        linkedNodes[label].clear();
+    }
+}
+
+/*
+Description:
+    Returns the statements creating the uniqueness constraint of the ids and the indices of the queried properties.
+*/
+const std::vector<std::string>& Neo4jNodeIds::getSchemaStatements() {
+    static const std::vector<std::string> statements = {
+        "CREATE CONSTRAINT node_id IF NOT EXISTS FOR (n:Node) REQUIRE n.id IS UNIQUE",
+        "CREATE INDEX IF NOT EXISTS FOR (n:Node) ON (n.enhancedKey)",
+        "CREATE INDEX IF NOT EXISTS FOR (n:Node) ON (n.diffType)",
+        "CREATE INDEX IF NOT EXISTS FOR (n:Node) ON (n.ast)"
+    };
+    return statements;
+}
+
+/*
+Description:
+    Returns the index of the difference type and AST, adds them on first use.
+*/
+uint64_t Neo4jNodeIds::getLabel(const std::string& differenceType, const std::string& astOrigin) {
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (labels[i].first == differenceType && labels[i].second == astOrigin) {
+            return i;
+        }
+    }
+    if (labels.size() >= 16) {
+        throw std::runtime_error("Too many difference types for the node ids: " + differenceType + " " + astOrigin);
+    }
+    labels.emplace_back(differenceType, astOrigin);
+    writtenNodes.emplace_back();
+    linkedNodes.emplace_back();
+    return labels.size() - 1;
+}
+
+/*
+Description:
+    Returns the id of a node: the number of the comparison, the index of its difference type and AST and its topological order.
+*/
+uint64_t Neo4jNodeIds::getId(uint64_t label, int topologicalOrder) const {
+    return (comparisonNumber << 36) | (label << 32) | static_cast<uint32_t>(topologicalOrder);
+}
+
+/*
+Description:
+    Sets the bit of the topological order, the bits grow with the tree. Returns false if the bit was already set.
+*/
+bool Neo4jNodeIds::testAndSet(std::vector<uint64_t>& bits, int topologicalOrder) {
+    size_t index = static_cast<uint32_t>(topologicalOrder);
+    if (index / 64 >= bits.size()) {
+        bits.resize(index / 64 + 1);
+    }
+    uint64_t mask = uint64_t(1) << (index % 64);
+    bool isNew = (bits[index / 64] & mask) == 0;
+    bits[index / 64] |= mask;
+    return isNew;
+}
+
+/*
+Description:
+    Returns true if the bit of the topological order is set.
+*/
+bool Neo4jNodeIds::isSet(const std::vector<uint64_t>& bits, int topologicalOrder) {
+    size_t index = static_cast<uint32_t>(topologicalOrder);
+    return index / 64 < bits.size() && (bits[index / 64] >> (index % 64)) & 1;
+}
@@ -0,0 +1,101 @@
+#include "../include/node_arena.h"
+#include <new>
+#include <type_traits>
+
+/*
+Description:
+    Destroys the nodes block by block and frees the blocks, the tree is not traversed.
+*/
+NodeArena::~NodeArena() {
+    release();
+}
+
+NodeArena::NodeArena(NodeArena&& other) noexcept
+    : nodeBlocks(std::move(other.nodeBlocks)),
+      nodeCount(other.nodeCount) {
+    other.nodeBlocks.clear();
+    other.nodeCount = 0;
+}
+
+NodeArena& NodeArena::operator=(NodeArena&& other) noexcept {
+    if (this != &other) {
+        release();
+        nodeBlocks = std::move(other.nodeBlocks);
+        nodeCount = other.nodeCount;
+        other.nodeBlocks.clear();
+        other.nodeCount = 0;
+    }
+    return *this;
+}
+
+/*
+Description:
+    Constructs a new node in the current block, a new block is allocated when the current one is full.
+*/
+Node* NodeArena::createNode() {
+    if (nodeBlocks.empty() || nodeBlocks.back().count == nodesPerBlock) {
+        Node* storage = static_cast<Node*>(::operator new(sizeof(Node) * nodesPerBlock));
+        nodeBlocks.push_back({storage, 0});
+    }
+
+    NodeBlock& block = nodeBlocks.back();
+    Node* node = new (&block.nodes[block.count]) Node();
+    ++block.count;
+    ++nodeCount;
+
+    return node;
+}
+
+/*
+Description:
+    Reserves the block list for the given number of nodes, the blocks themselves are allocated on demand.
+*/
+void NodeArena::reserve(size_t count) {
+    nodeBlocks.reserve(nodeBlocks.size() + (count + nodesPerBlock - 1) / nodesPerBlock);
+}
+
+/*
+Description:
+    Takes over the blocks of the other arena, its nodes are placed after the nodes of this arena in creation order.
+*/
+void NodeArena::absorb(NodeArena& other) {
+    nodeBlocks.insert(nodeBlocks.end(), other.nodeBlocks.begin(), other.nodeBlocks.end());
+    nodeCount += other.nodeCount;
+
+    other.nodeBlocks.clear();
+    other.nodeCount = 0;
+}
+
+/*
+Description:
+    Returns the number of nodes created in the arena.
+*/
+size_t NodeArena::size() const {
+    return nodeCount;
+}
+
+/*
+Description:
+    Returns the number of node blocks allocated by the arena.
+*/
+size_t NodeArena::blockCount() const {
+    return nodeBlocks.size();
+}
+
+/*
+Description:
+    Destroys the nodes and frees every block.
+*/
+void NodeArena::release() {
+    for (NodeBlock& block : nodeBlocks) {
+        if (!std::is_trivially_destructible<Node>::value) {
+            for (size_t i = 0; i < block.count; ++i) {
+                block.nodes[i].~Node();
+            }
+        }
+        ::operator delete(block.nodes);
+    }
+
+    nodeBlocks.clear();
+    nodeCount = 0;
+}
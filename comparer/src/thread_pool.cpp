@@ -0,0 +1,72 @@
+#include "../include/thread_pool.h"
+
+/*
+Description:
+    Starts the worker threads, by default one per hardware thread.
+*/
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = defaultThreadCount();
+    }
+
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+/*
+Description:
+    Finishes the already scheduled tasks and joins the worker threads.
+*/
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    condition.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/*
+Description:
+    Returns the number of worker threads.
+*/
+size_t ThreadPool::size() const {
+    return workers.size();
+}
+
+/*
+Description:
+    Returns the number of hardware threads, at least one.
+*/
+size_t ThreadPool::defaultThreadCount() {
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 0 ? hardwareThreads : 1;
+}
+
+/*
+Description:
+    Main loop of a worker thread, runs tasks until the pool is stopped and the queue is drained.
+*/
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return isStopping || !tasks.empty(); });
+
+            if (tasks.empty()) {
+                return; // stopping and nothing left to do
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+    }
+}
@@ -1,38 +1,67 @@
 #include <iostream>
 #include <algorithm>
-#include <fstream>
-#include <sstream>
 #include <queue>
 #include <stack>
 #include "../include/tree.h"
 #include "../include/utils.h"
+#include "../include/mapped_file.h"
+#include "../include/thread_pool.h"
+
+// below this size the dump is parsed on the calling thread when no thread count is given
+static const size_t parallelParseThreshold = 16 * 1024 * 1024;
+
+// number of chunks per thread, more chunks than threads balance uneven top-level declarations
+static const size_t chunksPerThread = 4;
+
+// recently acquired strings of a chunk, most strings of the nodes are kinds and paths repeated from nodes nearby
+static const size_t stringCacheSize = 4096;
 
 /*
 Description:
-    Constructs a tree from the given file.
+    Constructs a tree from the given text or binary dump, the file is memory-mapped and parsed in place. With a thread count of 0 
+    large text files are parsed on all hardware threads, 1 forces the sequential parser, any other value the parallel one with 
+    that many threads. Gzip and zstd compressed dumps are decompressed on a separate thread while they are parsed. When a 
+    snapshot directory is given, the tree is loaded from the snapshot of the dump's contents if there is one, otherwise the 
+    snapshot is written after the tree is built.
 */
-Tree::Tree(const std::string& fileName) {
-    std::ifstream file(fileName);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file: " + fileName);
+Tree::Tree(const std::string& fileName, unsigned int threadCount, const std::string& snapshotDirectory) {
+    MappedFile file(fileName);
+
+    if (snapshotDirectory.empty()) {
+        root = buildTreeFromFile(fileName, file.view(), threadCount);
+        return;
     }
-    
-    root = buildTree(file);
-    if (!root) {
-        throw std::runtime_error("Failed to build tree from file: " + fileName);
+
+    uint64_t contentHash = TreeSnapshot::hashContents(file.view());
+    std::string snapshotPath = TreeSnapshot::getPath(snapshotDirectory, contentHash);
+    if (TreeSnapshot::load(*this, snapshotPath, contentHash, file.size())) {
+        return;
     }
 
-    file.close(); // explicitly close the file
+    root = buildTreeFromFile(fileName, file.view(), threadCount);
+    TreeSnapshot::save(*this, snapshotPath, contentHash, file.size());
 }
 
 /*
 Description:
-    Deletes the tree.
+    Constructs an out-of-core tree from the given dump, the nodes are written to pages in the spill directory while the dump is
+    parsed, and only the pages needed by the comparison are kept in memory, within the memory limit of the options. The dump
+    is parsed sequentially, it has to have a single root node.
+*/
+Tree::Tree(const std::string& fileName, const TreeSpill::Options& options) : spill(std::make_unique<TreeSpill>(options)) {
+    MappedFile file(fileName);
+    root = buildTreeFromFile(fileName, file.view(), 1);
+}
+
+/*
+Description:
+    Deletes the tree, the nodes are released together with the blocks of the arena and their strings are released in the
+    pool, so the strings of trees loaded one after another in a long running process do not accumulate.
 */
 Tree::~Tree() {
-    if (root) {
-        deleteTree(root);
-        root = nullptr;
+    root = nullptr;
+    for (const InternedString& string : ownedStrings) {
+        InternedString::release(string);
     }
 }
 
@@ -44,41 +73,101 @@ Node* Tree::getRoot() const {
     return root;
 }
 
+/*
+Description:
+    Returns the preorder arrays of the tree.
+*/
+const TreeLayout& Tree::getLayout() const {
+    return layout;
+}
+
 /*
 Description:
     Returns the declaration nodes based on the key.
 */
-const std::pair<std::unordered_multimap<std::string, Node*>::const_iterator,
-                std::unordered_multimap<std::string, Node*>::const_iterator>
-Tree::getDeclNodes(const std::string& nodeKey) const {
+const std::pair<DeclNodeIndex::const_iterator, DeclNodeIndex::const_iterator> Tree::getDeclNodes(const InternedString& nodeKey) const {
+    if (spill) {
+        // the nodes are looked up in the pages, the range stays valid until the next lookup
+        std::vector<Node*> nodes;
+        spill->findDeclNodes(nodeKey, nodes);
+        declNodeLookup.build(nodes.size(), [&nodes](auto&& addValue) {
+            for (Node* node : nodes) {
+                addValue(node->enhancedKey.id(), {node->enhancedKey, node});
+            }
+        });
+        return declNodeLookup.equal_range(nodeKey);
+    }
+
     return declNodeMultiMap.equal_range(nodeKey);
 }
 
 /*
 Description:
-    Returns the statement nodes based on the key of the declaration.
+    Returns the statement nodes based on the key of the declaration, the key ends with the topological order of the declaration,
+    so the group is looked up by that number after the rest of the key is verified.
 */
 const std::pair<std::vector<Node*>::const_iterator, std::vector<Node*>::const_iterator> Tree::getStmtNodes(const std::string& nodeKey) const {
-    auto it = stmtNodeMultiMap.find(nodeKey);
-    if (it != stmtNodeMultiMap.end()) {
-        return {it->second.cbegin(), it->second.cend()};
+    uint32_t declarationIndex = findStmtGroupDeclaration(nodeKey);
+    if (declarationIndex == TreeLayout::noIndex) {
+        return {std::vector<Node*>::const_iterator{}, std::vector<Node*>::const_iterator{}}; // empty range if the key is not found
     }
 
-    return {std::vector<Node*>::const_iterator{}, std::vector<Node*>::const_iterator{}}; // empty range is key is not found
+    return getStmtNodes(getNode(declarationIndex));
+}
+
+/*
+Description:
+    Returns the statement nodes of a declaration, the group is looked up by the topological order of the declaration and only
+    returned when the key of the declaration matches, so the lookup needs no string keys. For an out-of-core tree the range 
+    stays valid until the next lookup.
+*/
+const std::pair<std::vector<Node*>::const_iterator, std::vector<Node*>::const_iterator> Tree::getStmtNodes(const Node* declaration) const {
+    if (!declaration || declaration->topologicalOrder < 0) {
+        return {std::vector<Node*>::const_iterator{}, std::vector<Node*>::const_iterator{}};
+    }
+
+    uint32_t declarationIndex = static_cast<uint32_t>(declaration->topologicalOrder);
+    const Node* groupDeclaration = declarationIndex < getNodeCount() ? getNode(declarationIndex) : nullptr;
+    if (!groupDeclaration || groupDeclaration->enhancedKey != declaration->enhancedKey) {
+        return {std::vector<Node*>::const_iterator{}, std::vector<Node*>::const_iterator{}};
+    }
+
+    if (spill) {
+        spill->findStmtNodes(declarationIndex, stmtNodeLookup);
+        return {stmtNodeLookup.cbegin(), stmtNodeLookup.cend()};
+    }
+
+    return stmtNodeGroups.equal_range(declarationIndex);
 }
 
 /*
 Description:
     Returns the declaration node of the multiple nodes in the tree.
 */
-const std::unordered_multimap<std::string, Node*>& Tree::getDeclNodeMultiMap() const {
+const DeclNodeIndex& Tree::getDeclNodeMultiMap() const {
+    if (spill) {
+        throw std::runtime_error("The declaration map is not available for out-of-core trees.");
+    }
     return declNodeMultiMap;
 }
 
 /*
-    Returns the statement node map of the tree.
+Description:
+    Returns the statement node map of the tree, keyed by the string key of the declaration. The tree stores the groups by the
+    topological order of the declaration, the map is built once, on the first request.
 */
 const std::unordered_map<std::string, std::vector<Node*>>& Tree::getStmtNodeMultiMap() const {
+    if (spill) {
+        throw std::runtime_error("The statement map is not available for out-of-core trees.");
+    }
+
+    std::call_once(stmtNodeMultiMapFlag, [this]() {
+        stmtNodeMultiMap.reserve(stmtNodeGroups.keyCount());
+        stmtNodeGroups.forEachRun([this](uint32_t declarationIndex, auto first, auto last) {
+            stmtNodeMultiMap.emplace(layout.getNode(declarationIndex)->enhancedKey + "|" + std::to_string(declarationIndex),
+                                     std::vector<Node*>(first, last));
+        });
+    });
     return stmtNodeMultiMap;
 }
 
@@ -86,20 +175,40 @@ const std::unordered_map<std::string, std::vector<Node*>>& Tree::getStmtNodeMult
 Description:
     Checks if the node is in the tree.  
 */
-bool Tree::isDeclNodeInAST(const std::string& nodeKey) const {
+bool Tree::isDeclNodeInAST(const InternedString& nodeKey) const {
+    if (spill) {
+        return spill->containsDeclKey(nodeKey);
+    }
     return (declNodeMultiMap.count(nodeKey) > 0);
 }
 
 /*
 Description:
     Processes a sutree of a given node using DFS traversal, uses the callback fuction to process the node, therefore it can be used
-    both for Statements and Declarations.
+    both for Statements and Declarations. Nodes of this tree are visited in preorder by walking the range of the subtree in the 
+    layout, other nodes fall back to a stack based traversal of their children. The subtrees of an out-of-core tree are walked
+    in its pages.
 */
 void Tree::processSubTree(Node* node, std::function<void(Node*, int)> processNode) {
     if (!node) {
         return;
     }
 
+    if (spill && node->topologicalOrder >= 0 && getNode(static_cast<uint32_t>(node->topologicalOrder)) == node) {
+        spill->processSubTree(static_cast<uint32_t>(node->topologicalOrder), processNode);
+        return;
+    }
+
+    // the subtree of a node of this tree is a contiguous preorder range
+    uint32_t index = layout.indexOf(node);
+    if (index != TreeLayout::noIndex) {
+        uint32_t baseDepth = layout.getDepth(index);
+        for (uint32_t current = index; current < layout.getSubtreeEnd(index); ++current) {
+            processNode(layout.getNode(current), static_cast<int>(layout.getDepth(current) - baseDepth));
+        }
+        return;
+    }
+
     // stack for DFS traversal; store both the node and its depth in the tree
     std::stack<std::pair<Node*, int>> stack;
     stack.push({node, 0});
@@ -121,17 +230,336 @@ void Tree::processSubTree(Node* node, std::function<void(Node*, int)> processNod
 
 /*
 Description:
-    Builds a tree from the given file, creates nodes, performs various checks, and returns the root node.
+    Returns true if the nodes of the tree are paged out to disk.
+*/
+bool Tree::isOutOfCore() const {
+    return spill != nullptr;
+}
+
+/*
+Description:
+    Returns the number of nodes in the tree.
+*/
+uint32_t Tree::getNodeCount() const {
+    return spill ? spill->size() : static_cast<uint32_t>(layout.size());
+}
+
+/*
+Description:
+    Returns the node of the given preorder index, or null for an invalid index. The node of an out-of-core tree stays valid
+    until the next call of releaseNodes().
+*/
+Node* Tree::getNode(uint32_t index) const {
+    if (spill) {
+        return spill->getNode(index);
+    }
+    return index < layout.size() ? layout.getNode(index) : nullptr;
+}
+
+/*
+Description:
+    Returns the type of the node of the given preorder index, the node is not materialized.
+*/
+NodeType Tree::getNodeType(uint32_t index) const {
+    return spill ? spill->getType(index) : layout.getType(index);
+}
+
+/*
+Description:
+    Returns the preorder indices of the children of the node, for an out-of-core tree the range stays valid until the next call
+    of releaseNodes().
+*/
+std::pair<const uint32_t*, const uint32_t*> Tree::getChildIndices(uint32_t index) const {
+    if (spill) {
+        return spill->getChildIndices(index);
+    }
+    return {layout.childrenBegin(index), layout.childrenEnd(index)};
+}
+
+/*
+Description:
+    Evicts pages of an out-of-core tree until it fits into its memory limit again, nodes returned earlier must not be used
+    afterwards. Does nothing for in-memory trees.
+*/
+void Tree::releaseNodes() {
+    if (spill) {
+        spill->releaseNodes();
+    }
+}
+
+/*
+Description:
+    Starts a traversal by a comparison. The lookups of an out-of-core tree go through its page cache and lookup buffers, which
+    are not synchronized, so a second traversal of such a tree while one is running throws. In-memory trees are only read and
+    allow any number of traversals.
+*/
+void Tree::beginTraversal() {
+    if (spill && isTraversed.exchange(true)) {
+        throw std::runtime_error("An out-of-core tree can only be compared by one comparison at a time.");
+    }
+}
+
+/*
+Description:
+    Ends the traversal started by beginTraversal().
+*/
+void Tree::endTraversal() {
+    if (spill) {
+        isTraversed = false;
+    }
+}
+
+/*
+Description:
+    Builds the tree from the contents of a dump file with the parser that fits its format and size, and returns the root node.
+*/
+Node* Tree::buildTreeFromFile(const std::string& fileName, std::string_view contents, unsigned int threadCount) {
+    Node* treeRoot = nullptr;
+
+    DecompressingStream::Codec codec = DecompressingStream::detectCodec(contents);
+    if (codec != DecompressingStream::NONE) {
+        DecompressingStream stream(contents, codec);
+        treeRoot = buildTreeFromStream(stream);
+    } else {
+        if (threadCount == 0 && contents.size() >= parallelParseThreshold && !spill) {
+            threadCount = static_cast<unsigned int>(ThreadPool::defaultThreadCount());
+        }
+
+        // binary dumps are read sequentially, their records are not split at line boundaries
+        bool isBinaryDump = BinaryDump::isBinaryDump(contents);
+        treeRoot = threadCount > 1 && !isBinaryDump && !spill ? buildTreeInParallel(contents, threadCount) : buildTree(contents);
+    }
+
+    if (!treeRoot) {
+        throw std::runtime_error("Failed to build tree from file: " + fileName);
+    }
+    return treeRoot;
+}
+
+/*
+Description:
+    Builds a tree from the contents of the dump file on the calling thread, and returns the root node. Text and binary dumps are
+    told apart by the header of the binary format.
+*/
+Node* Tree::buildTree(std::string_view contents) {
+    std::vector<ParseChunk> chunks(1);
+    chunks[0].contents = contents;
+    chunks[0].spill = spill.get();
+
+    if (BinaryDump::isBinaryDump(contents)) {
+        parseBinaryChunk(chunks[0]);
+    } else {
+        parseChunk(chunks[0], nullptr);
+    }
+
+    return finishTree(chunks);
+}
+
+/*
+Description:
+    Builds a tree from the contents of the dump file using multiple threads. The first line is the root, the rest of the file is 
+    split at depth 1 lines (children of the TranslationUnit), so every chunk holds complete top-level subtrees. Chunks are parsed
+    in parallel, renumbered to their global topological order, and merged under the root in file order. The result is identical
+    to the sequential construction, files that cannot be split this way are parsed sequentially.
+*/
+Node* Tree::buildTreeInParallel(std::string_view contents, unsigned int threadCount) {
+    size_t firstLineEnd = contents.find('\n');
+    if (firstLineEnd == std::string_view::npos || contents.empty() || contents.front() == ' ') {
+        return buildTree(contents); // single line or the root is not the first line
+    }
+
+    std::vector<ParseChunk> chunks(1);
+    chunks[0].contents = contents.substr(0, firstLineEnd + 1);
+    for (std::string_view part : splitAtTopLevelNodes(contents.substr(firstLineEnd + 1), threadCount * chunksPerThread)) {
+        chunks.emplace_back();
+        chunks.back().contents = part;
+    }
+
+    // the root has to exist before the other chunks can attach to it
+    parseChunk(chunks[0], nullptr);
+
+    Node* sharedRoot = chunks[0].root;
+    if (!sharedRoot || chunks[0].arena.size() != 1) {
+        return buildTree(contents);
+    }
+
+    std::exception_ptr error;
+    {
+        ThreadPool pool(threadCount);
+        std::vector<std::future<void>> results;
+
+        // parse the chunks
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            results.push_back(pool.submit([this, &chunks, i, sharedRoot]() { parseChunk(chunks[i], sharedRoot); }));
+        }
+        for (std::future<void>& result : results) {
+            try {
+                result.get();
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+
+        bool canMerge = !error && std::none_of(chunks.begin(), chunks.end(), [](const ParseChunk& chunk) { return chunk.reachedRootLevel; });
+        if (canMerge) {
+            // topological order continues where the previous chunk ended
+            results.clear();
+            int orderOffset = 0;
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                results.push_back(pool.submit([this, &chunks, i, orderOffset]() { groupStmtNodes(chunks[i], orderOffset); }));
+                orderOffset += static_cast<int>(chunks[i].arena.size());
+            }
+            for (std::future<void>& result : results) {
+                result.get();
+            }
+        } else if (!error) {
+            // multiple depth 0 lines, keep the behaviour of the sequential parser
+            return buildTree(contents);
+        }
+    }
+
+    // nodes of a failed construction are released with the arenas of the chunks
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    mergeChunks(chunks);
+    return sharedRoot;
+}
+
+/*
+Description:
+    Builds a tree from a compressed dump while it is being decompressed. Only complete lines or records of a block are parsed,
+    the incomplete end of a block is carried over to the start of the next one.
+*/
+Node* Tree::buildTreeFromStream(DecompressingStream& stream) {
+    std::vector<ParseChunk> chunks(1);
+    ParseChunk& chunk = chunks[0];
+    chunk.spill = spill.get();
+    BinaryDump::Reader reader;
+    bool isFormatKnown = false;
+    bool isBinaryDump = false;
+
+    std::string buffer;
+    std::string block;
+    bool isLastPart = false;
+    while (!isLastPart) {
+        isLastPart = !stream.next(block);
+        if (buffer.empty()) {
+            buffer.swap(block);
+        } else {
+            buffer.append(block);
+        }
+        block.clear();
+
+        if (!isFormatKnown) {
+            if (buffer.size() < sizeof(BinaryDump::magic) && !isLastPart) {
+                continue;
+            }
+            isBinaryDump = BinaryDump::isBinaryDump(buffer);
+            isFormatKnown = true;
+        }
+
+        size_t parsedSize = 0;
+        if (isBinaryDump) {
+            reader.setContents(buffer, isLastPart);
+            parseBinaryRecords(chunk, reader);
+            parsedSize = reader.getPosition();
+        } else {
+            size_t lastLineEnd = buffer.rfind('\n');
+            parsedSize = isLastPart ? buffer.size() : (lastLineEnd == std::string::npos ? 0 : lastLineEnd + 1);
+            chunk.contents = std::string_view(buffer).substr(0, parsedSize);
+            parseChunk(chunk, nullptr);
+        }
+        buffer.erase(0, parsedSize);
+    }
+
+    return finishTree(chunks);
+}
+
+/*
+Description:
+    Completes the sequential construction of the tree from its only chunk and returns the root node. The chunk is merged into the
+    tree, or for an out-of-core tree its last page is written and only the root is kept in the arena of the tree.
+*/
+Node* Tree::finishTree(std::vector<ParseChunk>& chunks) {
+    ParseChunk& chunk = chunks[0];
+
+    if (chunk.spill) {
+        flushPage(chunk, true);
+        chunk.spill->finish();
+        nodeArena = std::move(chunk.rootArena);
+        layout.build(nodeArena);
+        return chunk.root;
+    }
+
+    groupStmtNodes(chunk, 0);
+
+    Node* chunkRoot = chunk.root;
+    mergeChunks(chunks);
+    return chunkRoot;
+}
+
+/*
+Description:
+    Splits the contents into at most the given number of parts of similar size, every part starts at a line with depth 1 
+    (exactly one leading space), so that top-level subtrees are never divided.
+*/
+std::vector<std::string_view> Tree::splitAtTopLevelNodes(std::string_view contents, size_t partCount) const {
+    std::vector<std::string_view> parts;
+    size_t partSize = std::max<size_t>(contents.size() / std::max<size_t>(partCount, 1), 1);
+    size_t partStart = 0;
+
+    while (partStart < contents.size()) {
+        size_t boundary = partStart + partSize;
+        while (boundary < contents.size()) {
+            boundary = contents.find('\n', boundary);
+            if (boundary == std::string_view::npos) {
+                boundary = contents.size();
+                break;
+            }
+
+            ++boundary; // first character of the next line
+            if (boundary + 1 < contents.size() && contents[boundary] == ' ' && contents[boundary + 1] != ' ') {
+                break;
+            }
+        }
+
+        boundary = std::min(boundary, contents.size());
+        parts.push_back(contents.substr(partStart, boundary - partStart));
+        partStart = boundary;
+    }
+
+    return parts;
+}
+
+/*
+Description:
+    Parses the lines of a chunk, creates nodes, performs various checks and links the nodes to their parents. Lines and tokens 
+    are string views into the contents, tokenizing does not allocate. When a shared root is given, the chunk contains top-level 
+    subtrees of that root, they are collected instead of being attached, so chunks can be parsed concurrently.
 */
-Node* Tree::buildTree(std::ifstream& file) {
-    std::vector<Node*> nodeStack;
-    std::string line;
-    int currentIndex = 0;
+void Tree::parseChunk(ParseChunk& chunk, Node* sharedRoot) const {
+    std::string_view contents = chunk.contents;
+    std::string_view tokens[6];
+
+    if (sharedRoot) {
+        chunk.nodeStack.push_back(sharedRoot);
+    }
+
+    size_t lineStart = 0;
+    while (lineStart < contents.size()) {
+        size_t lineEnd = contents.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) {
+            lineEnd = contents.size();
+        }
+
+        std::string_view line = contents.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
 
-    while (std::getline(file, line)) {
         // normalize line endings (remove trailing \r if present, typical in Windows)
         if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+            line.remove_suffix(1);
         }
 
         if (line.empty()) {
@@ -139,102 +567,339 @@ Node* Tree::buildTree(std::ifstream& file) {
         }
 
         // depth of the current node
-        int depth = 0;
-        while (depth < line.size() && line[depth] == ' ') {
-            ++depth;
+        size_t depth = line.find_first_not_of(' ');
+        if (depth == std::string_view::npos) {
+            depth = line.size();
         }
 
-        std::vector<std::string> tokens = Utils::splitString(line);
-        if (tokens.size() < 6) {
+        if (Utils::splitLine(line, tokens, 6) < 6) {
             std::cerr << "Warning: Invalid line in the file (expected at least 6 tokens): " << line << '\n';
             continue;
         }
 
+        if (sharedRoot && depth == 0) {
+            chunk.reachedRootLevel = true;
+            return;
+        }
+
+        // pages of an out-of-core tree end before a top-level node
+        if (chunk.spill && depth <= 1 && chunk.arena.size() > 0) {
+            if (depth == 0) {
+                throw std::runtime_error("Out-of-core trees need a dump with a single root node.");
+            }
+            flushPage(chunk, false);
+        }
+
         // trimming
-        Utils::ltrim(tokens[0]);
+        tokens[0].remove_prefix(std::min(depth, tokens[0].size()));
 
         int lineNumber = 0;
         int columnNumber = 0;
-        try {
-            lineNumber = std::stoi(tokens[4]);
-            columnNumber = std::stoi(tokens[5]);
-        } catch (const std::exception& e) {
-            std::cerr << "ERROR: Failed to parse line or column number from line: " << line << " - " << e.what() << '\n';
+        if (!Utils::parseInt(tokens[4], lineNumber) || !Utils::parseInt(tokens[5], columnNumber)) {
+            std::cerr << "ERROR: Failed to parse line or column number from line: " << line << '\n';
             throw std::runtime_error("Failed to parse line or column number.");
         }
 
-        // new node
-        Node* node = new Node;
-        node->type = Utils::stringToNodeType(tokens[0]);
-        node->kind = tokens[1];
-        node->usr = tokens[2];
-        node->path = tokens[3];
-        node->lineNumber = lineNumber;
-        node->columnNumber = columnNumber;
-        node->topologicalOrder = currentIndex++;
+        addParsedNode(chunk, depth, Utils::stringToNodeType(tokens[0]), chunk.makeString(tokens[1]), chunk.makeString(tokens[2]),
+                      chunk.makeString(tokens[3]), lineNumber, columnNumber);
+    }
+
+    chunk.root = chunk.nodeStack.empty() ? nullptr : chunk.nodeStack.front();
+}
+
+/*
+Description:
+    Parses a chunk holding a complete binary dump.
+*/
+void Tree::parseBinaryChunk(ParseChunk& chunk) const {
+    BinaryDump::Reader reader(chunk.contents);
+    chunk.arena.reserve(static_cast<size_t>(reader.getNodeCount()));
+    parseBinaryRecords(chunk, reader);
+}
 
-        // adjust the stack's size
-        if (nodeStack.size() > depth) {
-            nodeStack.resize(depth);
+/*
+Description:
+    Parses the complete records of the reader's current contents, the records are already tokenized and every string of the 
+    dump is acquired once, when it is defined. The strings of an out-of-core tree are acquired per node instead, so they can be
+    released with their page.
+*/
+void Tree::parseBinaryRecords(ParseChunk& chunk, BinaryDump::Reader& reader) const {
+    BinaryDump::Record record;
+    while (reader.readNode(record)) {
+        NodeType type = record.type == BinaryDump::declarationType ? DECLARATION
+                      : record.type == BinaryDump::statementType ? STATEMENT : UNKNOWN;
+
+        if (chunk.spill) {
+            if (record.depth <= 1 && chunk.arena.size() > 0) {
+                if (record.depth == 0) {
+                    throw std::runtime_error("Out-of-core trees need a dump with a single root node.");
+                }
+                flushPage(chunk, false);
+            }
+            addParsedNode(chunk, record.depth, type, chunk.makeString(reader.getString(record.kind)),
+                          chunk.makeString(reader.getString(record.usr)), chunk.makeString(reader.getString(record.path)),
+                          static_cast<int>(record.lineNumber), static_cast<int>(record.columnNumber));
+            continue;
         }
 
-        // parent of the current node
-        node->parent = nodeStack.empty() ? nullptr : nodeStack.back();
-        if (node->parent) {
-            node->parent->children.push_back(node);
+        while (chunk.dumpStrings.size() < reader.getStringCount()) {
+            chunk.dumpStrings.push_back(chunk.makeString(reader.getString(static_cast<uint32_t>(chunk.dumpStrings.size()))));
         }
-        nodeStack.push_back(node);
+        addParsedNode(chunk, record.depth, type, chunk.dumpStrings[record.kind], chunk.dumpStrings[record.usr],
+                      chunk.dumpStrings[record.path], static_cast<int>(record.lineNumber), static_cast<int>(record.columnNumber));
+    }
+
+    chunk.root = chunk.nodeStack.empty() ? nullptr : chunk.nodeStack.front();
+}
+
+/*
+Description:
+    Creates the node of a parsed line or record, attaches it to the parent on the stack and generates its key. The fingerprint
+    covers the subtree, so it is computed after the tree is built. Statement nodes are collected with their declaration parent for grouping.
+*/
+void Tree::addParsedNode(ParseChunk& chunk, size_t depth, NodeType type, const InternedString& kind, const InternedString& usr,
+                         const InternedString& path, int lineNumber, int columnNumber) const {
+    std::vector<Node*>& nodeStack = chunk.nodeStack;
 
-        // fingerprint generation + unique key
-        node->fingerprint = Utils::getFingerPrint(node);
-        if (node->type == DECLARATION) {
-            node->enhancedKey = Utils::getEnhancedDeclKey(node);
-            addDeclNodeToNodeMap(node);
+    // new node
+    Node* node = chunk.arena.createNode();
+    node->type = type;
+    node->kind = kind;
+    node->usr = usr;
+    node->path = path;
+    node->lineNumber = lineNumber;
+    node->columnNumber = columnNumber;
+    node->topologicalOrder = chunk.nextTopologicalOrder++;
+
+    // adjust the stack's size
+    if (nodeStack.size() > depth) {
+        nodeStack.resize(depth);
+    }
+
+    // parent of the current node, children are linked when the chunks are merged
+    node->parent = nodeStack.empty() ? nullptr : nodeStack.back();
+    nodeStack.push_back(node);
+
+    // unique key
+    if (node->type == DECLARATION) {
+        node->enhancedKey = chunk.makeString(Utils::getEnhancedDeclKey(node));
+    } else {
+        const Node* lastDeclarationNode = Utils::findDeclarationParent(node);
+        if (lastDeclarationNode) {
+            node->enhancedKey = chunk.makeString(Utils::getStmtKey(node, lastDeclarationNode->enhancedKey));
+            chunk.stmtNodes.emplace_back(lastDeclarationNode, node);
         } else {
-            const Node* lastDeclarationNode = Utils::findDeclarationParent(node);
-            if (lastDeclarationNode) {
-                node->enhancedKey = Utils::getStmtKey(node, lastDeclarationNode->enhancedKey);
-                addStmtNodeToNodeMap(node, lastDeclarationNode);
-            } else {
-                // if no declaration parent found, delete the node to prevent a memory leak
-                std::cerr << "Warning: Could not find declaration parent for statement node: " << node->kind
-                          << " at path: " << node->path << " (line: " << node->lineNumber
-                          << ", column: " << node->columnNumber << ")\n";
-                continue;
-            }
+            // the node stays in the tree, but it cannot be looked up by a declaration
+            std::cerr << "Warning: Could not find declaration parent for statement node: " << node->kind
+                      << " at path: " << node->path << " (line: " << node->lineNumber
+                      << ", column: " << node->columnNumber << ")\n";
         }
     }
+}
+
+/*
+Description:
+    Returns the topological order of the declaration of a statement key ("<declaration key>|<order>"), or TreeLayout::noIndex
+    when there is no declaration with that order and key.
+*/
+uint32_t Tree::findStmtGroupDeclaration(const std::string& nodeKey) const {
+    size_t separator = nodeKey.rfind('|');
+    int declarationOrder = -1;
+    if (separator == std::string::npos || !Utils::parseInt(std::string_view(nodeKey).substr(separator + 1), declarationOrder) ||
+        declarationOrder < 0 || static_cast<uint32_t>(declarationOrder) >= getNodeCount()) {
+        return TreeLayout::noIndex;
+    }
+
+    const Node* declaration = getNode(static_cast<uint32_t>(declarationOrder));
+    if (!declaration || nodeKey.compare(0, separator, declaration->enhancedKey.str()) != 0) {
+        return TreeLayout::noIndex;
+    }
+    return static_cast<uint32_t>(declarationOrder);
+}
+
+/*
+Description:
+    Returns the handle of a parsed string, the string is acquired in the pool. The strings of an out-of-core tree are released
+    when the page of the node is written, the strings of other trees are handed to the tree and released with it. A string
+    found in the cache of the chunk is already held by the chunk and is not acquired again.
+*/
+InternedString Tree::ParseChunk::makeString(std::string_view value) {
+    if (value.empty()) {
+        return InternedString();
+    }
 
+    InternedString* cached = nullptr;
+    if (!spill) {
+        if (stringCache.empty()) {
+            stringCache.resize(stringCacheSize);
+        }
+        cached = &stringCache[std::hash<std::string_view>{}(value) % stringCacheSize];
+        if (cached->str() == value) {
+            return *cached;
+        }
+    }
 
-    return nodeStack.empty() ? nullptr : nodeStack.front();
+    InternedString string = InternedString::acquire(value);
+    acquiredStrings.push_back(string);
+    if (cached) {
+        *cached = string;
+    }
+    return string;
 }
 
 /*
 Description:
-    Adds the statement node with its key to the stmtNodeMultiMap.
+    Releases the strings still held by the chunk, the ones of a chunk whose nodes were not handed to a tree.
 */
-void Tree::addStmtNodeToNodeMap(Node* node, const Node* declarationParent) {
-    std::string key = declarationParent->enhancedKey + "|" + std::to_string(declarationParent->topologicalOrder);
-    stmtNodeMultiMap[key].emplace_back(node);
+Tree::ParseChunk::~ParseChunk() {
+    for (const InternedString& string : acquiredStrings) {
+        InternedString::release(string);
+    }
 }
 
 /*
 Description:
-    Adds the declaration node to the declNodeMultiMap.
+    Writes the parsed nodes of an out-of-core tree as a page once the page is large enough, or when it is the last one, and
+    starts the next page below the root. The first page holds only the root, it stays in memory with permanently interned
+    strings.
 */
-void Tree::addDeclNodeToNodeMap(Node* node) {
-    declNodeMultiMap.emplace(node->enhancedKey, node);
+void Tree::flushPage(ParseChunk& chunk, bool isLastPage) const {
+    if (chunk.rootArena.size() == 0) {
+        if (chunk.arena.size() == 0) {
+            return; // empty dump
+        }
+        if (chunk.arena.size() != 1) {
+            throw std::runtime_error("Out-of-core trees need a dump whose top-level nodes are at depth 1.");
+        }
+
+        Node* chunkRoot = chunk.nodeStack.front();
+        chunkRoot->kind = InternedString(chunkRoot->kind.str());
+        chunkRoot->usr = InternedString(chunkRoot->usr.str());
+        chunkRoot->path = InternedString(chunkRoot->path.str());
+        chunkRoot->enhancedKey = InternedString(chunkRoot->enhancedKey.str());
+        chunk.rootArena = std::move(chunk.arena);
+        chunk.arena = NodeArena();
+        chunk.spill->setRoot(chunkRoot);
+        chunk.root = chunkRoot;
+    } else if (!isLastPage && chunk.arena.size() < chunk.spill->getPageNodeLimit()) {
+        return;
+    } else {
+        chunk.spill->writePage(chunk.arena, chunk.stmtNodes);
+        chunk.arena = NodeArena();
+    }
+
+    chunk.stmtNodes.clear();
+    chunk.nodeStack.resize(std::min<size_t>(chunk.nodeStack.size(), 1));
+    for (const InternedString& string : chunk.acquiredStrings) {
+        InternedString::release(string);
+    }
+    chunk.acquiredStrings.clear();
 }
 
 /*
 Description:
-    Recursively deletes the tree starting from the given node.
+    Shifts the topological order of the chunk's nodes by the number of nodes before the chunk, then groups the statement nodes 
+    by the order of their declaration parent, so the merge needs one map lookup per declaration instead of one per statement.
 */
-void Tree::deleteTree(Node* node) {
-    if (node) {
-        for (Node* child : node->children) {
-            deleteTree(child);
+void Tree::groupStmtNodes(ParseChunk& chunk, int orderOffset) const {
+    if (orderOffset != 0) {
+        chunk.arena.forEachNode([orderOffset](Node* node) { node->topologicalOrder += orderOffset; });
+    }
+
+    std::unordered_map<const Node*, size_t> groupIndices;
+    for (const auto& [declarationParent, node] : chunk.stmtNodes) {
+        auto [it, isNewGroup] = groupIndices.emplace(declarationParent, chunk.stmtGroups.size());
+        if (isNewGroup) {
+            chunk.stmtGroups.emplace_back(static_cast<uint32_t>(declarationParent->topologicalOrder), std::vector<Node*>());
         }
-        delete node;
+        chunk.stmtGroups[it->second].second.push_back(node);
     }
-}
\ No newline at end of file
+
+    chunk.stmtNodes.clear();
+    chunk.stmtNodes.shrink_to_fit();
+}
+
+/*
+Description:
+    Merges the parsed chunks in file order: moves their nodes into the arena of the tree, builds the preorder layout and fills the 
+    declaration and statement maps, nodes with identical keys keep their topological order.
+*/
+void Tree::mergeChunks(std::vector<ParseChunk>& chunks) {
+    for (ParseChunk& chunk : chunks) {
+        nodeArena.absorb(chunk.arena);
+        ownedStrings.insert(ownedStrings.end(), chunk.acquiredStrings.begin(), chunk.acquiredStrings.end());
+        chunk.acquiredStrings.clear();
+    }
+    layout.build(nodeArena);
+    buildDeclNodeIndex();
+    computeSubtreeFingerPrints();
+
+    // groups of the root can be spread over the chunks, their parts are joined in chunk order
+    size_t stmtGroupCount = 0;
+    for (const ParseChunk& chunk : chunks) {
+        stmtGroupCount += chunk.stmtGroups.size();
+    }
+    stmtNodeGroups.build(stmtGroupCount, [&chunks](auto&& addValue) {
+        for (const ParseChunk& chunk : chunks) {
+            for (const auto& [declarationIndex, nodes] : chunk.stmtGroups) {
+                for (Node* node : nodes) {
+                    addValue(declarationIndex, node);
+                }
+            }
+        }
+    });
+    for (ParseChunk& chunk : chunks) {
+        chunk.stmtGroups.clear();
+    }
+}
+
+/*
+Description:
+    Computes the Merkle fingerprints of all nodes in one pass in reverse preorder, every child is finished before its parent.
+    The same pass marks the subtrees whose declarations all have unique keys, the comparer only skips equal subtrees when 
+    their declarations cannot be paired with nodes outside of them. Needs the declaration index.
+*/
+void Tree::computeSubtreeFingerPrints() {
+    uint32_t nodeCount = static_cast<uint32_t>(layout.size());
+    std::vector<size_t> childrenHashes(nodeCount, 0);
+    std::vector<uint8_t> uniqueDeclKeys(nodeCount, 1);
+    declNodeMultiMap.forEachRun([&uniqueDeclKeys](uint32_t, auto first, auto last) {
+        if (last - first > 1) {
+            for (auto it = first; it != last; ++it) {
+                uniqueDeclKeys[static_cast<uint32_t>(it->second->topologicalOrder)] = 0;
+            }
+        }
+    });
+
+    for (uint32_t index = nodeCount; index-- > 0;) {
+        Node* node = layout.getNode(index);
+        node->fingerprint = Utils::getFingerPrint(node, childrenHashes[index]);
+        node->hasUniqueDeclKeys = uniqueDeclKeys[index] != 0;
+
+        uint32_t parent = layout.getParent(index);
+        if (parent != TreeLayout::noIndex) {
+            childrenHashes[parent] = Utils::addChildFingerPrint(childrenHashes[parent], node->fingerprint, index - parent);
+            uniqueDeclKeys[parent] &= uniqueDeclKeys[index];
+        }
+    }
+}
+
+/*
+Description:
+    Builds the declaration index from the layout, declarations with identical keys keep their topological order.
+*/
+void Tree::buildDeclNodeIndex() {
+    size_t declarationCount = 0;
+    for (uint32_t index = 0; index < layout.size(); ++index) {
+        declarationCount += (layout.getType(index) == DECLARATION);
+    }
+
+    declNodeMultiMap.build(declarationCount, [this](auto&& addValue) {
+        for (uint32_t index = 0; index < layout.size(); ++index) {
+            if (layout.getType(index) == DECLARATION) {
+                Node* node = layout.getNode(index);
+                addValue(node->enhancedKey.id(), {node->enhancedKey, node});
+            }
+        }
+    });
+}
@@ -1,49 +1,303 @@
 #include <iostream>
 #include <stack>
 #include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <typeinfo>
+#include <utility>
 #include "../include/tree_comparer.h"
 #include "../include/utils.h"
+#include "../include/thread_pool.h"
 
-TreeComparer::TreeComparer(Tree& firstTree, Tree& secondTree, IDatabaseWrapper& db) 
+/*
+Description:
+    Creates the comparer of two trees. With a thread count other than 1 the subtrees of in-memory trees are compared in
+    parallel, 0 uses all hardware threads. The workers are plain comparers, so a subclass that overrides the comparison
+    steps is always compared sequentially.
+*/
+TreeComparer::TreeComparer(Tree& firstTree, Tree& secondTree, IDatabaseWrapper& db, unsigned int threadCount) 
     : firstASTTree(firstTree), 
       secondASTTree(secondTree), 
       dbWrapper(db),
-      topologicalComparer([](const Node* a, const Node* b) { return a->topologicalOrder < b->topologicalOrder; }) {
+      topologicalComparer([](const Node* a, const Node* b) { return a->topologicalOrder < b->topologicalOrder; }),
+      threadCount(threadCount) {
     if (!firstTree.getRoot() || !secondTree.getRoot()) {
         throw std::invalid_argument("Invalid Tree object passed to TreeComparer: Root node is null.");
     }   
+    processedNodes = std::make_shared<ProcessedNodes>(firstTree.getNodeCount(), secondTree.getNodeCount());
 } 
 
+/*
+Description:
+    Creates a worker of a parallel comparison, which buffers its differences and shares the processed flags and the
+    declaration join of the comparison that started it.
+*/
+TreeComparer::TreeComparer(Tree& firstTree, Tree& secondTree, DifferenceBuffer& buffer, std::shared_ptr<ProcessedNodes> processedNodes,
+                           std::shared_ptr<const DeclJoin> declJoin)
+    : firstASTTree(firstTree),
+      secondASTTree(secondTree),
+      dbWrapper(buffer),
+      topologicalComparer([](const Node* a, const Node* b) { return a->topologicalOrder < b->topologicalOrder; }),
+      threadCount(1),
+      processedNodes(std::move(processedNodes)),
+      declJoin(std::move(declJoin)) {
+}
+
+/*
+Description:
+    Returns the processed flags of the comparison.
+*/
+const ProcessedNodes& TreeComparer::getProcessedNodes() const {
+    return *processedNodes;
+}
+
+/*
+Description:
+    Returns true if the node of the given AST was processed by this comparison, nodes that do not belong to the tree are
+    never processed.
+*/
+bool TreeComparer::isProcessed(const ASTId ast, const Node* node) const {
+    return node->topologicalOrder >= 0 && processedNodes->isProcessed(ast, static_cast<uint32_t>(node->topologicalOrder));
+}
+
+/*
+Description:
+    Marks the node of the given AST as processed by this comparison.
+*/
+void TreeComparer::markProcessed(const ASTId ast, const Node* node) {
+    if (node->topologicalOrder >= 0) {
+        processedNodes->markProcessed(ast, static_cast<uint32_t>(node->topologicalOrder));
+    }
+}
+
 /*
 Description:
     Public method that starts the comparison process by using BFS approach for comparing the nodes, ensuring that parents are processed before children,
     prints the necessary information about the differences to the console. 
 */
 void TreeComparer::printDifferences() {
-    std::queue<Node*> queue;
+    // an out-of-core tree is compared by one comparison at a time, the traversals end with the comparison, also when it fails
+    struct TraversalGuard {
+        Tree& tree;
+        ~TraversalGuard() { tree.endTraversal(); }
+    };
+    firstASTTree.beginTraversal();
+    TraversalGuard firstTraversal{firstASTTree};
+    secondASTTree.beginTraversal();
+    TraversalGuard secondTraversal{secondASTTree};
+
+    // nodes are queued by tree and preorder index, so the pages of out-of-core trees can be evicted between the steps
+    std::queue<std::pair<Tree*, uint32_t>> queue;
+
+    // declarations of in-memory trees are matched by key once, the traversal then reads the matches instead of hashing keys
+    if (!firstASTTree.isOutOfCore() && !secondASTTree.isOutOfCore()) {
+        declJoin = std::make_shared<const DeclJoin>(firstASTTree, secondASTTree, threadCount);
+    }
 
     // start with the root nodes of both ASTs
-    if (firstASTTree.getRoot()) queue.push(firstASTTree.getRoot());
-    if (secondASTTree.getRoot()) queue.push(secondASTTree.getRoot());
+    if (firstASTTree.getRoot()) queue.push({&firstASTTree, 0});
+    if (secondASTTree.getRoot()) queue.push({&secondASTTree, 0});
+
+    // the roots are always compared first, their keys can pair nodes of any subtree
+    for (size_t rootCount = queue.size(); rootCount > 0; --rootCount) {
+        processStep(queue);
+    }
+
+    // the workers would not run the overrides of a subclass
+    bool isParallel = threadCount != 1 && typeid(*this) == typeid(TreeComparer) && !firstASTTree.isOutOfCore() &&
+                      !secondASTTree.isOutOfCore();
+    if (isParallel) {
+        compareInParallel(queue);
+    }
+    while (!queue.empty()) {
+        processStep(queue);
+    }
 
+    // send the remaining nodes from the batch
+    dbWrapper.finalize();
+}
+
+/*
+Description:
+    One step of the traversal: processes the node at the front of the queue and adds its children to the queue.
+*/
+void TreeComparer::processStep(std::queue<std::pair<Tree*, uint32_t>>& queue) {
+    auto [tree, index] = queue.front();
+    queue.pop();
+
+    Node* current = tree->getNode(index);
+    if (!current) {
+        std::cerr << "Error: Encountered null node during traversal in printDifferences().\n";
+        return;
+    }
+
+    // process the node
+    processDeclNodes(current);
+
+    // add children to the queue for further processing
+    enqueueChildren(*tree, index, queue);
+
+    // no node of this step is used anymore
+    firstASTTree.releaseNodes();
+    secondASTTree.releaseNodes();
+}
+
+/*
+Description:
+    Returns the position of a step in the sequential traversal. The queue holds both trees level by level, the first tree 
+    before the second, and the nodes of a level in preorder, so the depth, the tree and the preorder index order the steps.
+*/
+uint64_t TreeComparer::getStepOrder(const std::pair<Tree*, uint32_t>& step) const {
+    uint64_t depth = step.first->getLayout().getDepth(step.second);
+    uint64_t treeIndex = step.first == &firstASTTree ? 0 : 1;
+    return (depth << 33) | (treeIndex << 32) | step.second;
+}
+
+/*
+Description:
+    Splits the queued steps into groups that can be compared independently. Every top-level subtree of both trees is a unit,
+    units holding declarations with the same key are joined, because the key pairs their nodes. A step only changes nodes of
+    its own group, so each group can be traversed separately and sees the same processed flags as the sequential traversal.
+    The groups are returned with the largest first.
+*/
+std::vector<std::vector<std::pair<Tree*, uint32_t>>> TreeComparer::partitionSteps(std::queue<std::pair<Tree*, uint32_t>>& queue) const {
+    const uint32_t noUnit = TreeLayout::noIndex;
+    const TreeLayout& firstLayout = firstASTTree.getLayout();
+    const TreeLayout& secondLayout = secondASTTree.getLayout();
+
+    // unit of every node: its top-level subtree, numbered over both trees
+    std::vector<uint32_t> unitSizes;
+    auto assignUnits = [&unitSizes, noUnit](const TreeLayout& layout) {
+        std::vector<uint32_t> units(layout.size(), noUnit);
+        for (uint32_t index = 1; index < layout.size(); ++index) {
+            uint32_t parent = layout.getParent(index);
+            if (parent == 0) {
+                units[index] = static_cast<uint32_t>(unitSizes.size());
+                unitSizes.push_back(layout.getSubtreeEnd(index) - index);
+            } else if (parent != TreeLayout::noIndex) {
+                units[index] = units[parent];
+            }
+        }
+        return units;
+    };
+    std::vector<uint32_t> firstUnits = assignUnits(firstLayout);
+    std::vector<uint32_t> secondUnits = assignUnits(secondLayout);
+
+    // union-find over the units
+    std::vector<uint32_t> groupOf(unitSizes.size());
+    std::iota(groupOf.begin(), groupOf.end(), 0);
+    auto findGroup = [&groupOf](uint32_t unit) {
+        while (groupOf[unit] != unit) {
+            groupOf[unit] = groupOf[groupOf[unit]];
+            unit = groupOf[unit];
+        }
+        return unit;
+    };
+    auto joinUnits = [&groupOf, &findGroup, noUnit](uint32_t first, uint32_t second) {
+        if (first != noUnit && second != noUnit) {
+            groupOf[findGroup(first)] = findGroup(second);
+        }
+    };
+    auto joinKeyUnits = [&joinUnits, noUnit](const std::vector<uint32_t>& units, auto first, auto last, uint32_t unit) {
+        for (auto it = first; it != last; ++it) {
+            uint32_t nodeUnit = units[static_cast<uint32_t>(it->second->topologicalOrder)];
+            joinUnits(nodeUnit, unit);
+            unit = unit == noUnit ? nodeUnit : unit;
+        }
+        return unit;
+    };
+
+    firstASTTree.getDeclNodeMultiMap().forEachRun([&](uint32_t, auto first, auto last) {
+        joinKeyUnits(firstUnits, first, last, noUnit);
+    });
+    uint32_t secondRun = 0;
+    secondASTTree.getDeclNodeMultiMap().forEachRun([&](uint32_t, auto first, auto last) {
+        uint32_t firstRun = declJoin->getPartnerRun(SECOND_AST, secondRun++);
+        uint32_t unit = noUnit;
+        if (firstRun != DeclJoin::noRun) {
+            auto [firstTreeBegin, firstTreeEnd] = firstASTTree.getDeclNodeMultiMap().getRun(firstRun);
+            unit = joinKeyUnits(firstUnits, firstTreeBegin, firstTreeEnd, noUnit);
+        }
+        joinKeyUnits(secondUnits, first, last, unit);
+    });
+
+    // steps by group, in queue order
+    std::vector<uint32_t> groupIndices(unitSizes.size(), noUnit);
+    std::vector<std::vector<std::pair<Tree*, uint32_t>>> groups;
+    std::vector<size_t> groupSizes;
     while (!queue.empty()) {
-        Node* current = queue.front();
+        std::pair<Tree*, uint32_t> step = queue.front();
         queue.pop();
 
-        if (!current) {
-            std::cerr << "Error: Encountered null node during traversal in printDifferences().\n";
-            continue;
+        uint32_t unit = (step.first == &firstASTTree ? firstUnits : secondUnits)[step.second];
+        uint32_t group = findGroup(unit);
+        if (groupIndices[group] == noUnit) {
+            groupIndices[group] = static_cast<uint32_t>(groups.size());
+            groups.emplace_back();
+            groupSizes.push_back(0);
         }
+        groups[groupIndices[group]].push_back(step);
+        groupSizes[groupIndices[group]] += unitSizes[unit];
+    }
 
-        // process the node
-        processDeclNodes(current);
+    std::vector<size_t> order(groups.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&groupSizes](size_t lhs, size_t rhs) { return groupSizes[lhs] > groupSizes[rhs]; });
 
-        // add children to the queue for further processing
-        enqueueChildren(current, queue);
+    std::vector<std::vector<std::pair<Tree*, uint32_t>>> sortedGroups;
+    sortedGroups.reserve(groups.size());
+    for (size_t index : order) {
+        sortedGroups.push_back(std::move(groups[index]));
     }
+    return sortedGroups;
+}
 
-    // send the remaining nodes from the batch
-    dbWrapper.finalize();
+/*
+Description:
+    Compares the queued steps on a thread pool. The steps are split into independent groups, the workers take the next group
+    from a shared counter, largest first, and traverse it with their own comparer and difference buffer. The buffers are replayed
+    afterwards in the order of the sequential traversal, so the database receives exactly the calls of a sequential comparison.
+    Only the base comparison is run on the workers, overridden methods are not called.
+*/
+void TreeComparer::compareInParallel(std::queue<std::pair<Tree*, uint32_t>>& queue) {
+    std::vector<std::vector<std::pair<Tree*, uint32_t>>> groups = partitionSteps(queue);
+    if (groups.size() < 2) {
+        // nothing to split, the steps go back to the queue for the sequential traversal
+        for (const std::vector<std::pair<Tree*, uint32_t>>& group : groups) {
+            for (const auto& step : group) {
+                queue.push(step);
+            }
+        }
+        return;
+    }
+
+    size_t workerCount = std::min(threadCount == 0 ? ThreadPool::defaultThreadCount() : static_cast<size_t>(threadCount), groups.size());
+    std::vector<DifferenceBuffer> buffers(workerCount);
+    std::atomic<size_t> nextGroup{0};
+    {
+        ThreadPool pool(workerCount);
+        std::vector<std::future<void>> results;
+        for (size_t worker = 0; worker < workerCount; ++worker) {
+            results.push_back(pool.submit([this, &groups, &buffers, &nextGroup, worker]() {
+                TreeComparer comparer(firstASTTree, secondASTTree, buffers[worker], processedNodes, declJoin);
+                for (size_t group = nextGroup++; group < groups.size(); group = nextGroup++) {
+                    std::queue<std::pair<Tree*, uint32_t>> groupQueue;
+                    for (const auto& step : groups[group]) {
+                        groupQueue.push(step);
+                    }
+                    while (!groupQueue.empty()) {
+                        buffers[worker].beginStep(getStepOrder(groupQueue.front()));
+                        comparer.processStep(groupQueue);
+                    }
+                }
+            }));
+        }
+        for (std::future<void>& result : results) {
+            result.get();
+        }
+    }
+
+    DifferenceBuffer::replay(buffers, dbWrapper);
 }
 
 /*
@@ -52,10 +306,17 @@ Descpirion:
     compares them, otherwise processes the node that exists only in one of the ASTs.
 */
 void TreeComparer::processDeclNodes(Node* current) {
-    std::string nodeKey = current->enhancedKey;
+    const InternedString& nodeKey = current->enhancedKey;
 
-    bool existsInFirstAST = firstASTTree.isDeclNodeInAST(nodeKey);
-    bool existsInSecondAST = secondASTTree.isDeclNodeInAST(nodeKey);
+    bool existsInFirstAST;
+    bool existsInSecondAST;
+    if (findJoinedRuns(current)) {
+        existsInFirstAST = joinedFirstRun != DeclJoin::noRun;
+        existsInSecondAST = joinedSecondRun != DeclJoin::noRun;
+    } else {
+        existsInFirstAST = firstASTTree.isDeclNodeInAST(nodeKey);
+        existsInSecondAST = secondASTTree.isDeclNodeInAST(nodeKey);
+    }
 
     if (existsInFirstAST && existsInSecondAST) {
         processDeclNodesInBothASTs(nodeKey);
@@ -69,6 +330,52 @@ void TreeComparer::processDeclNodes(Node* current) {
     }
 }
 
+/*
+Description:
+    Reads the runs of the key of a declaration of either tree from the join, so processDeclNodesInBothASTs can take the
+    declarations of the key without looking it up. Returns false if there is no join or the node is not a declaration of
+    the trees, the key has to be looked up then.
+*/
+bool TreeComparer::findJoinedRuns(const Node* current) {
+    joinedKey = nullptr;
+    if (!declJoin || current->topologicalOrder < 0) {
+        return false;
+    }
+
+    uint32_t index = static_cast<uint32_t>(current->topologicalOrder);
+    ASTId ast;
+    if (index < firstASTTree.getNodeCount() && firstASTTree.getNode(index) == current) {
+        ast = FIRST_AST;
+    } else if (index < secondASTTree.getNodeCount() && secondASTTree.getNode(index) == current) {
+        ast = SECOND_AST;
+    } else {
+        return false;
+    }
+
+    uint32_t run = declJoin->getRun(ast, index);
+    if (run == DeclJoin::noRun) {
+        return false;
+    }
+    uint32_t partnerRun = declJoin->getPartnerRun(ast, run);
+
+    joinedKey = &current->enhancedKey.str();
+    joinedFirstRun = ast == FIRST_AST ? run : partnerRun;
+    joinedSecondRun = ast == FIRST_AST ? partnerRun : run;
+    return true;
+}
+
+/*
+Description:
+    Returns true if the key of a node of the given AST is declared in the other AST, read from the join when there is one.
+*/
+bool TreeComparer::isInCorrespondingAST(const Node* node, const ASTId ast) const {
+    if (declJoin && node->topologicalOrder >= 0) {
+        return declJoin->getPartnerRun(ast, declJoin->getRun(ast, static_cast<uint32_t>(node->topologicalOrder))) != DeclJoin::noRun;
+    }
+    const Tree& correspondingASTTree = (ast == FIRST_AST) ? secondASTTree : firstASTTree;
+    return correspondingASTTree.isDeclNodeInAST(node->enhancedKey);
+}
+
 /*
 Description:
     Comparison logic of two source locations
@@ -114,6 +421,13 @@ void TreeComparer::compareSimilarDeclNodes(Node* firstNode, Node* secondNode) {
     // checking for parents
     compareParents(firstNode, secondNode);
 
+    // identical subtrees have no differences below their roots
+    if (isUnchangedSubTree(firstNode, secondNode)) {
+        skipUnchangedSubTree(firstNode, firstASTTree, FIRST_AST);
+        skipUnchangedSubTree(secondNode, secondASTTree, SECOND_AST);
+        return;
+    }
+
     // comparing the source locations of the nodes
     compareSourceLocations(firstNode, secondNode);
 
@@ -121,49 +435,71 @@ void TreeComparer::compareSimilarDeclNodes(Node* firstNode, Node* secondNode) {
     compareStmtNodes(firstNode, secondNode);
 
     // mark nodes as processed
-    firstNode->isProcessed = true;
-    secondNode->isProcessed = true;
+    markProcessed(FIRST_AST, firstNode);
+    markProcessed(SECOND_AST, secondNode);
 }
 
 /*
 Description:
-    Compares the statement nodes of two declaration nodes, creates a set of nodes for each AST using unique hash and equal functions,
-    then compares the nodes in the first AST with the nodes in the second AST, printing the differences.
+    Returns true if the subtrees of the two declarations are identical by their Merkle fingerprints, including the source
+    locations and all statements. Subtrees with a declaration key that occurs more than once in a tree are never skipped,
+    their declarations could be paired with nodes outside of the subtree.
+*/
+bool TreeComparer::isUnchangedSubTree(const Node* firstNode, const Node* secondNode) const {
+    return firstNode->fingerprint == secondNode->fingerprint &&
+           firstNode->hasUniqueDeclKeys && secondNode->hasUniqueDeclKeys;
+}
+
+/*
+Description:
+    Marks every node of an unchanged subtree as processed without comparing it, so the traversal does not enter it. The subtree
+    of an in-memory tree is a contiguous range of preorder indices and is marked at once.
+*/
+void TreeComparer::skipUnchangedSubTree(Node* node, Tree& tree, const ASTId ast) {
+    if (!tree.isOutOfCore() && node->topologicalOrder >= 0) {
+        uint32_t index = static_cast<uint32_t>(node->topologicalOrder);
+        processedNodes->markRange(ast, index, tree.getLayout().getSubtreeEnd(index));
+        return;
+    }
+    tree.processSubTree(node, [this, ast](Node* current, int) { markProcessed(ast, current); });
+}
+
+/*
+Description:
+    Compares the statement nodes of two declaration nodes, every statement of the first AST is matched with the first unprocessed
+    statement of the second AST with the same key, in the order of the statements. The statements of the second AST are grouped
+    by their key once per call, so the matching is linear in the number of statements. Unmatched nodes are printed as differences.
 */
 void TreeComparer::compareStmtNodes(const Node* firstNode, const Node* secondNode) {
-    std::string firstNodeStmtKey = firstNode->enhancedKey + "|" + std::to_string(firstNode->topologicalOrder);
-    std::string secondNodeStmtKey = secondNode->enhancedKey + "|" + std::to_string(secondNode->topologicalOrder);
-    auto firstASTStmtRange = firstASTTree.getStmtNodes(firstNodeStmtKey);
-    auto secondASTStmtRange = secondASTTree.getStmtNodes(secondNodeStmtKey);
+    auto firstASTStmtRange = firstASTTree.getStmtNodes(firstNode);
+    auto secondASTStmtRange = secondASTTree.getStmtNodes(secondNode);
+    std::vector<Node*>::const_iterator secondASTStmtNodes = secondASTStmtRange.first;
+    uint32_t secondASTStmtCount = static_cast<uint32_t>(std::distance(secondASTStmtRange.first, secondASTStmtRange.second));
+
+    // positions of the statements of the second AST, grouped by key in their order
+    stmtBuckets.build(secondASTStmtCount, [secondASTStmtNodes, secondASTStmtCount](auto&& addValue) {
+        for (uint32_t position = 0; position < secondASTStmtCount; ++position) {
+            addValue(secondASTStmtNodes[position]->enhancedKey.id(), position);
+        }
+    });
+    stmtBucketCursors.assign(secondASTStmtCount, 0);
 
     // first pass: identifying matches and marking them 
     for (auto it1 = firstASTStmtRange.first; it1 != firstASTStmtRange.second; ++it1) {
         Node* stmtNodeFirst = *it1;
 
-        if (stmtNodeFirst->isProcessed) {
+        if (isProcessed(FIRST_AST, stmtNodeFirst)) {
             continue; // skip if already processed
         }
 
-        bool foundMatch = false;
-        for (auto it2 = secondASTStmtRange.first; it2 != secondASTStmtRange.second; ++it2) {
-            Node* stmtNodeSecond = *it2;
-
-            if (stmtNodeSecond->isProcessed) {
-                continue; // skip from second if already processed
-            }
-
-            if (stmtNodeFirst->enhancedKey == stmtNodeSecond->enhancedKey) {
-                compareParents(stmtNodeFirst, stmtNodeSecond);
-                compareSourceLocations(stmtNodeFirst, stmtNodeSecond);
+        Node* stmtNodeSecond = findStmtMatch(stmtNodeFirst, secondASTStmtNodes);
+        if (stmtNodeSecond) {
+            compareParents(stmtNodeFirst, stmtNodeSecond);
+            compareSourceLocations(stmtNodeFirst, stmtNodeSecond);
 
-                stmtNodeFirst->isProcessed = true;
-                stmtNodeSecond->isProcessed = true;
-                foundMatch = true;
-                break; // exit inner loop if found
-            }
-        }
-
-        if (!foundMatch) {
+            markProcessed(FIRST_AST, stmtNodeFirst);
+            markProcessed(SECOND_AST, stmtNodeSecond);
+        } else {
             processNodesInSingleAST(stmtNodeFirst, firstASTTree, FIRST_AST, false);
         }
     }
@@ -171,28 +507,60 @@ void TreeComparer::compareStmtNodes(const Node* firstNode, const Node* secondNod
     // second pass: unmatched nodes in second AST
     for (auto it = secondASTStmtRange.first; it != secondASTStmtRange.second; ++it) {
         Node* stmtNode = *it;
-        if (!stmtNode->isProcessed) {
+        if (!isProcessed(SECOND_AST, stmtNode)) {
             processNodesInSingleAST(stmtNode, secondASTTree, SECOND_AST, false);
         }
     }
 }
 
+/*
+Description:
+    Returns the first unprocessed statement of the second AST with the key of the given statement, or nullptr if there is none.
+    Processed flags are never cleared, so every group keeps a cursor behind which all of its statements are processed, and
+    each statement of the second AST is skipped at most once.
+*/
+Node* TreeComparer::findStmtMatch(const Node* stmtNode, std::vector<Node*>::const_iterator secondASTStmtNodes) {
+    auto [first, last] = stmtBuckets.equal_range(stmtNode->enhancedKey.id());
+    if (first == last) {
+        return nullptr;
+    }
+
+    uint32_t& cursor = stmtBucketCursors[static_cast<size_t>(first - stmtBuckets.begin())];
+    for (auto it = first + cursor; it != last; ++it, ++cursor) {
+        Node* candidate = secondASTStmtNodes[*it];
+        if (!isProcessed(SECOND_AST, candidate)) {
+            return candidate;
+        }
+    }
+    return nullptr;
+}
+
 /*
 Description:
     Processes the declaration nodes that exist in both ASTs, by comparing them and marking them as processed, uses the iterator ranges 
     that are returned by the getDeclNodes method of the Tree class, sorts the nodes based on their topological order for proper comparison.
 */
 void TreeComparer::processDeclNodesInBothASTs(const std::string& nodeKey) {
-    auto firstASTRange = firstASTTree.getDeclNodes(nodeKey);
-    auto secondASTRange = secondASTTree.getDeclNodes(nodeKey);
+    std::pair<DeclNodeIndex::const_iterator, DeclNodeIndex::const_iterator> firstASTRange;
+    std::pair<DeclNodeIndex::const_iterator, DeclNodeIndex::const_iterator> secondASTRange;
+    if (&nodeKey == joinedKey) {
+        // the key of the current declaration, its runs were read from the join
+        firstASTRange = firstASTTree.getDeclNodeMultiMap().getRun(joinedFirstRun);
+        secondASTRange = secondASTTree.getDeclNodeMultiMap().getRun(joinedSecondRun);
+    } else {
+        // the key is only looked up in the pool, interning it would keep the strings of out-of-core trees alive
+        InternedString key = InternedString::find(nodeKey);
+        firstASTRange = firstASTTree.getDeclNodes(key);
+        secondASTRange = secondASTTree.getDeclNodes(key);
+    }
 
     // Check the number of nodes in both ranges
     bool isFirstSingleNode = std::distance(firstASTRange.first, firstASTRange.second) == 1;
     bool isSecondSingleNode = std::distance(secondASTRange.first, secondASTRange.second) == 1;
 
     if (isFirstSingleNode && isSecondSingleNode) {
-        bool isFirstNodeProcessed = firstASTRange.first->second->isProcessed;
-        bool isSecondNodeProcessed = secondASTRange.first->second->isProcessed;
+        bool isFirstNodeProcessed = isProcessed(FIRST_AST, firstASTRange.first->second);
+        bool isSecondNodeProcessed = isProcessed(SECOND_AST, secondASTRange.first->second);
         
         if (isFirstNodeProcessed || isSecondNodeProcessed) {
             return;  // skip already processed nodes
@@ -215,10 +583,8 @@ Description:
     Processes the declaration nodes that exist in both ASTs multiple times with the same key, by comparing them and marking them as processed, uses the iterator ranges 
     that are returned by the getDeclNodes method of the Tree class, sorts the nodes based on their topological order for proper comparison.
 */
-void TreeComparer::processMultiDeclNodes(const std::pair<std::unordered_multimap<std::string, Node*>::const_iterator,
-                                                std::unordered_multimap<std::string, Node*>::const_iterator>& firstASTRange,
-                                         const std::pair<std::unordered_multimap<std::string, Node*>::const_iterator,
-                                                std::unordered_multimap<std::string, Node*>::const_iterator>& secondASTRange) {
+void TreeComparer::processMultiDeclNodes(const std::pair<DeclNodeIndex::const_iterator, DeclNodeIndex::const_iterator>& firstASTRange,
+                                         const std::pair<DeclNodeIndex::const_iterator, DeclNodeIndex::const_iterator>& secondASTRange) {
     std::vector<Node*> firstASTDeclNodes;
     std::vector<Node*> secondASTDeclNodes;
 
@@ -240,7 +606,7 @@ void TreeComparer::processMultiDeclNodes(const std::pair<std::unordered_multimap
         Node* firstNode = firstASTDeclNodes[i];
         Node* secondNode = secondASTDeclNodes[i];
             
-        if (firstNode->isProcessed || secondNode->isProcessed) {
+        if (isProcessed(FIRST_AST, firstNode) || isProcessed(SECOND_AST, secondNode)) {
             continue;  // Skip already processed nodes
         }
 
@@ -257,25 +623,21 @@ Description:
     Processes a node that exists only in one of the ASTs, prints the details of the node and marks the subtree as processed, handles both DECLARATIONS and STATEMENTS
 */
 void TreeComparer::processNodesInSingleAST(Node* current, Tree& tree, const ASTId ast, bool isDeclaration) {
-    if (current->isProcessed) {
+    if (isProcessed(ast, current)) {
         return;  // skip
     }
 
-    // curresponsing AST for node checking in the lambda
-    Tree& correspondingASTTree = (ast == FIRST_AST) ? secondASTTree : firstASTTree;
-
     // Lambda for processing the node
-    auto processNode = [this, ast, &correspondingASTTree](Node* currentNode, int depth) {
-        std::string currentNodeKey = currentNode->enhancedKey;
-        bool existsInCorrespondingAST = correspondingASTTree.isDeclNodeInAST(currentNodeKey);
+    auto processNode = [this, ast](Node* currentNode, int depth) {
+        bool existsInCorrespondingAST = isInCorrespondingAST(currentNode, ast);
 
         // don't mark and print nodes in the subtree that exists in both AST, leave them for further comparison
-        if (existsInCorrespondingAST && currentNode->isProcessed) {
+        if (existsInCorrespondingAST && isProcessed(ast, currentNode)) {
             return;  // skip
         } 
 
         // if the node does not exist in the other AST, log it and mark it as processed as part of the subtree
-        currentNode->isProcessed = true;
+        markProcessed(ast, currentNode);
         const DifferenceType diffType = (ast == FIRST_AST) ? ONLY_IN_FIRST_AST : ONLY_IN_SECOND_AST;
 
         // logger->logNode(currentNode, diffType, ast, depth); // log the node
@@ -300,7 +662,7 @@ void TreeComparer::processRemainingNodes(std::vector<Node*>::const_iterator begi
                                          Tree& tree, const ASTId ast) {
     for (auto it = begin; it != end; ++it) {
         Node* node = *it;
-        if (!node->isProcessed) {
+        if (!isProcessed(ast, node)) {
             processNodesInSingleAST(node, tree, ast, node->type == DECLARATION);
         }
     }
@@ -308,12 +670,15 @@ void TreeComparer::processRemainingNodes(std::vector<Node*>::const_iterator begi
 
 /*
 Description:
-    Enqueues the children of a given node to the queue, only storing the Declaration types for processing
+    Enqueues the children of a given node to the queue, only storing the Declaration types for processing, the children are not
+    materialized.
 */
-void TreeComparer::enqueueChildren(Node* current, std::queue<Node*>& queue) {
-    for (Node* child : current->children) {
-        if (child && !child->isProcessed && child->type == DECLARATION) {
-            queue.push(child);
+void TreeComparer::enqueueChildren(Tree& tree, uint32_t index, std::queue<std::pair<Tree*, uint32_t>>& queue) {
+    const ASTId ast = (&tree == &firstASTTree) ? FIRST_AST : SECOND_AST;
+    auto [begin, end] = tree.getChildIndices(index);
+    for (const uint32_t* child = begin; child != end; ++child) {
+        if (!processedNodes->isProcessed(ast, *child) && tree.getNodeType(*child) == DECLARATION) {
+            queue.push({&tree, *child});
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,84 @@
+#include "../include/tree_layout.h"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+Description:
+    Fills the arrays from the nodes of the arena, which are stored in preorder, and points the children of every node into
+    the CSR arrays. Parents always precede their children, so the depths and child counts are computed in one forward pass
+    and the subtree ends in one backward pass.
+*/
+void TreeLayout::build(const NodeArena& arena) {
+    size_t nodeCount = arena.size();
+    if (nodeCount >= noIndex) {
+        throw std::runtime_error("Too many nodes for the tree layout: " + std::to_string(nodeCount));
+    }
+
+    nodes.clear();
+    nodes.reserve(nodeCount);
+    types.resize(nodeCount);
+    parents.resize(nodeCount);
+    depths.resize(nodeCount);
+    subtreeEnds.resize(nodeCount);
+    childOffsets.assign(nodeCount + 1, 0);
+
+    arena.forEachNode([this](Node* node) {
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(node);
+        types[index] = static_cast<uint8_t>(node->type);
+        subtreeEnds[index] = index + 1;
+
+        uint32_t parent = node->parent ? static_cast<uint32_t>(node->parent->topologicalOrder) : noIndex;
+        parents[index] = parent;
+        depths[index] = parent == noIndex ? 0 : depths[parent] + 1;
+        if (parent != noIndex) {
+            ++childOffsets[parent + 1];
+        }
+    });
+
+    for (size_t i = 1; i <= nodeCount; ++i) {
+        childOffsets[i] += childOffsets[i - 1];
+    }
+
+    childIndices.resize(childOffsets[nodeCount]);
+    std::vector<uint32_t> nextChild(childOffsets.begin(), childOffsets.end() - 1);
+    for (uint32_t index = 0; index < nodeCount; ++index) {
+        if (parents[index] != noIndex) {
+            childIndices[nextChild[parents[index]]++] = index;
+        }
+    }
+
+    for (uint32_t index = static_cast<uint32_t>(nodeCount); index-- > 0;) {
+        if (parents[index] != noIndex) {
+            subtreeEnds[parents[index]] = std::max(subtreeEnds[parents[index]], subtreeEnds[index]);
+        }
+    }
+
+    for (uint32_t index = 0; index < nodeCount; ++index) {
+        NodeChildren& children = nodes[index]->children;
+        children.indices = childrenBegin(index);
+        children.nodes = nodes.data();
+        children.count = childOffsets[index + 1] - childOffsets[index];
+    }
+}
+
+/*
+Description:
+    Returns the number of nodes in the layout.
+*/
+size_t TreeLayout::size() const {
+    return nodes.size();
+}
+
+/*
+Description:
+    Returns the index of the node, or noIndex when the node is not part of this layout.
+*/
+uint32_t TreeLayout::indexOf(const Node* node) const {
+    if (!node || node->topologicalOrder < 0 || static_cast<size_t>(node->topologicalOrder) >= nodes.size()) {
+        return noIndex;
+    }
+
+    uint32_t index = static_cast<uint32_t>(node->topologicalOrder);
+    return nodes[index] == node ? index : noIndex;
+}
@@ -0,0 +1,305 @@
+#include "../include/tree_snapshot.h"
+#include "../include/tree.h"
+#include "../include/mapped_file.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+static const char snapshotMagic[4] = {'A', 'S', 'T', 'S'};
+
+static uint64_t rotateLeft(uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+static uint64_t mixHash(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+static size_t alignTo8(size_t size) {
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+/*
+Description:
+    Hashes the contents of a dump, 32 bytes are consumed per step in four independent lanes, so hashing is much faster than
+    parsing and the cache can be checked before the dump is read.
+*/
+uint64_t TreeSnapshot::hashContents(std::string_view contents) {
+    const uint64_t prime1 = 0x9e3779b185ebca87ULL;
+    const uint64_t prime2 = 0xc2b2ae3d27d4eb4fULL;
+    uint64_t lanes[4] = {prime1 + prime2, prime2, 0, 0 - prime1};
+
+    const char* data = contents.data();
+    size_t size = contents.size();
+    size_t position = 0;
+    for (; position + 32 <= size; position += 32) {
+        for (int lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, data + position + lane * 8, 8);
+            lanes[lane] = rotateLeft(lanes[lane] + word * prime2, 31) * prime1;
+        }
+    }
+
+    uint64_t hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+    hash ^= static_cast<uint64_t>(size) * prime1;
+    for (; position < size; ++position) {
+        hash = rotateLeft(hash ^ (static_cast<uint8_t>(data[position]) * prime2), 11) * prime1;
+    }
+    return mixHash(hash);
+}
+
+/*
+Description:
+    Returns the path of the snapshot of a dump with the given content hash in the cache directory.
+*/
+std::string TreeSnapshot::getPath(const std::string& directory, uint64_t sourceHash) {
+    static const char digits[] = "0123456789abcdef";
+    std::string fileName(16, '0');
+    for (int i = 15; i >= 0; --i, sourceHash >>= 4) {
+        fileName[i] = digits[sourceHash & 0xf];
+    }
+    return (std::filesystem::path(directory) / (fileName + ".snapshot")).string();
+}
+
+/*
+Description:
+    Loads the tree from its snapshot, returns false if there is no snapshot or it does not belong to the given dump. A damaged
+    snapshot is reported and ignored, the tree is left empty in that case, so it can be built from the dump.
+*/
+bool TreeSnapshot::load(Tree& tree, const std::string& fileName, uint64_t sourceHash, uint64_t sourceSize) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(fileName, error)) {
+        return false;
+    }
+
+    try {
+        MappedFile file(fileName);
+        if (read(tree, file.view(), sourceHash, sourceSize)) {
+            return true;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Could not load the snapshot " << fileName << ": " << e.what() << '\n';
+    }
+    return false;
+}
+
+/*
+Description:
+    Validates the snapshot and fills the tree from it. Every index is checked before the tree is touched, then the nodes are
+    created directly from the records, only the strings of the table are acquired, and the layout and the declaration map are
+    rebuilt from the parent indices.
+*/
+bool TreeSnapshot::read(Tree& tree, std::string_view contents, uint64_t sourceHash, uint64_t sourceSize) {
+    Header header;
+    if (contents.size() < sizeof(Header)) {
+        return false;
+    }
+    std::memcpy(&header, contents.data(), sizeof(Header));
+    if (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0 || header.version != version ||
+        header.sourceHash != sourceHash || header.sourceSize != sourceSize) {
+        return false;
+    }
+
+    // section sizes, the counts are bounded first so the products cannot overflow
+    const uint64_t maxCount = TreeLayout::noIndex;
+    if (header.nodeCount == 0 || header.nodeCount >= maxCount || header.stringCount >= maxCount ||
+        header.stmtGroupCount >= maxCount || header.stmtNodeCount >= maxCount || header.stringBytes > contents.size()) {
+        throw std::runtime_error("Invalid snapshot header.");
+    }
+
+    size_t offsetsStart = sizeof(Header);
+    size_t stringsStart = offsetsStart + (header.stringCount + 1) * sizeof(uint64_t);
+    size_t nodesStart = stringsStart + alignTo8(header.stringBytes);
+    size_t groupsStart = nodesStart + header.nodeCount * sizeof(NodeRecord);
+    size_t stmtNodesStart = groupsStart + header.stmtGroupCount * sizeof(StmtGroupRecord);
+    size_t end = stmtNodesStart + header.stmtNodeCount * sizeof(uint32_t);
+    if (end != contents.size()) {
+        throw std::runtime_error("Unexpected size of the snapshot.");
+    }
+
+    const uint64_t* stringOffsets = reinterpret_cast<const uint64_t*>(contents.data() + offsetsStart);
+    const char* stringData = contents.data() + stringsStart;
+    const NodeRecord* nodeRecords = reinterpret_cast<const NodeRecord*>(contents.data() + nodesStart);
+    const StmtGroupRecord* groupRecords = reinterpret_cast<const StmtGroupRecord*>(contents.data() + groupsStart);
+    const uint32_t* stmtNodeIndices = reinterpret_cast<const uint32_t*>(contents.data() + stmtNodesStart);
+
+    // validation
+    for (uint64_t i = 0; i < header.stringCount; ++i) {
+        if (stringOffsets[i] > stringOffsets[i + 1] || stringOffsets[i + 1] > header.stringBytes) {
+            throw std::runtime_error("Invalid string table in the snapshot.");
+        }
+    }
+    for (uint64_t i = 0; i < header.nodeCount; ++i) {
+        const NodeRecord& record = nodeRecords[i];
+        bool isParentValid = record.parent == TreeLayout::noIndex || record.parent < i;
+        if (!isParentValid || record.kind >= header.stringCount || record.usr >= header.stringCount ||
+            record.path >= header.stringCount || record.enhancedKey >= header.stringCount || record.type > UNKNOWN) {
+            throw std::runtime_error("Invalid node record in the snapshot.");
+        }
+    }
+    for (uint64_t i = 0; i < header.stmtGroupCount; ++i) {
+        const StmtGroupRecord& group = groupRecords[i];
+        if (group.declaration >= header.nodeCount || group.firstNode > header.stmtNodeCount ||
+            group.nodeCount > header.stmtNodeCount - group.firstNode) {
+            throw std::runtime_error("Invalid statement group in the snapshot.");
+        }
+    }
+    for (uint64_t i = 0; i < header.stmtNodeCount; ++i) {
+        if (stmtNodeIndices[i] >= header.nodeCount) {
+            throw std::runtime_error("Invalid statement node in the snapshot.");
+        }
+    }
+
+    // the strings are held by the tree and released with it
+    InternedString::reservePool(header.stringCount);
+    std::vector<InternedString>& strings = tree.ownedStrings;
+    strings.reserve(header.stringCount);
+    for (uint64_t i = 0; i < header.stringCount; ++i) {
+        strings.push_back(InternedString::acquire(std::string_view(stringData + stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i])));
+    }
+
+    // nodes in preorder, the parent always precedes the node
+    std::vector<Node*> nodes(header.nodeCount);
+    tree.nodeArena.reserve(header.nodeCount);
+    for (uint64_t i = 0; i < header.nodeCount; ++i) {
+        const NodeRecord& record = nodeRecords[i];
+        Node* node = tree.nodeArena.createNode();
+        node->type = static_cast<NodeType>(record.type);
+        node->kind = strings[record.kind];
+        node->usr = strings[record.usr];
+        node->path = strings[record.path];
+        node->lineNumber = record.lineNumber;
+        node->columnNumber = record.columnNumber;
+        node->topologicalOrder = static_cast<int>(i);
+        node->parent = record.parent == TreeLayout::noIndex ? nullptr : nodes[record.parent];
+        node->enhancedKey = strings[record.enhancedKey];
+        node->fingerprint = static_cast<size_t>(record.fingerprint);
+        nodes[i] = node;
+    }
+    tree.layout.build(tree.nodeArena);
+
+    tree.buildDeclNodeIndex();
+    tree.computeSubtreeFingerPrints();
+    tree.stmtNodeGroups.build(header.stmtGroupCount, [&](auto&& addValue) {
+        for (uint64_t i = 0; i < header.stmtGroupCount; ++i) {
+            const StmtGroupRecord& group = groupRecords[i];
+            for (uint32_t j = 0; j < group.nodeCount; ++j) {
+                addValue(group.declaration, nodes[stmtNodeIndices[group.firstNode + j]]);
+            }
+        }
+    });
+
+    tree.root = nodes[0];
+    return true;
+}
+
+/*
+Description:
+    Writes the snapshot of the tree. The file is written under a temporary name and renamed when it is complete, so concurrent
+    runs never read a partial snapshot. Failures are reported but do not affect the tree.
+*/
+void TreeSnapshot::save(const Tree& tree, const std::string& fileName, uint64_t sourceHash, uint64_t sourceSize) {
+    const TreeLayout& layout = tree.getLayout();
+
+    // string table, interned strings are deduplicated by their id
+    std::vector<std::string_view> strings;
+    std::unordered_map<uint32_t, uint32_t> stringIndices;
+    auto addString = [&strings, &stringIndices](const InternedString& value) {
+        auto [it, isNew] = stringIndices.emplace(value.id(), static_cast<uint32_t>(strings.size()));
+        if (isNew) {
+            strings.push_back(value.str());
+        }
+        return it->second;
+    };
+
+    std::vector<NodeRecord> nodeRecords(layout.size());
+    for (uint32_t index = 0; index < layout.size(); ++index) {
+        const Node* node = layout.getNode(index);
+        NodeRecord& record = nodeRecords[index];
+        record.parent = layout.getParent(index);
+        record.kind = addString(node->kind);
+        record.usr = addString(node->usr);
+        record.path = addString(node->path);
+        record.enhancedKey = addString(node->enhancedKey);
+        record.lineNumber = node->lineNumber;
+        record.columnNumber = node->columnNumber;
+        record.type = static_cast<uint32_t>(node->type);
+        record.fingerprint = static_cast<uint64_t>(node->fingerprint);
+    }
+
+    std::vector<StmtGroupRecord> groupRecords;
+    std::vector<uint32_t> stmtNodeIndices;
+    groupRecords.reserve(tree.stmtNodeGroups.keyCount());
+    tree.stmtNodeGroups.forEachRun([&](uint32_t declarationIndex, auto first, auto last) {
+        StmtGroupRecord group{};
+        group.declaration = declarationIndex;
+        group.firstNode = static_cast<uint32_t>(stmtNodeIndices.size());
+        group.nodeCount = static_cast<uint32_t>(last - first);
+        for (auto it = first; it != last; ++it) {
+            stmtNodeIndices.push_back(layout.indexOf(*it));
+        }
+        groupRecords.push_back(group);
+    });
+
+    std::vector<uint64_t> stringOffsets(1, 0);
+    stringOffsets.reserve(strings.size() + 1);
+    for (std::string_view value : strings) {
+        stringOffsets.push_back(stringOffsets.back() + value.size());
+    }
+
+    Header header{};
+    std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = version;
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    header.nodeCount = nodeRecords.size();
+    header.stringCount = strings.size();
+    header.stringBytes = stringOffsets.back();
+    header.stmtGroupCount = groupRecords.size();
+    header.stmtNodeCount = stmtNodeIndices.size();
+
+    std::error_code error;
+    std::filesystem::path path(fileName);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    std::string temporaryName = fileName + ".tmp" +
+        std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                       static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    {
+        std::ofstream output(temporaryName, std::ios::out | std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        output.write(reinterpret_cast<const char*>(stringOffsets.data()), stringOffsets.size() * sizeof(uint64_t));
+        for (std::string_view value : strings) {
+            output.write(value.data(), value.size());
+        }
+        static const char padding[8] = {};
+        output.write(padding, alignTo8(header.stringBytes) - header.stringBytes);
+        output.write(reinterpret_cast<const char*>(nodeRecords.data()), nodeRecords.size() * sizeof(NodeRecord));
+        output.write(reinterpret_cast<const char*>(groupRecords.data()), groupRecords.size() * sizeof(StmtGroupRecord));
+        output.write(reinterpret_cast<const char*>(stmtNodeIndices.data()), stmtNodeIndices.size() * sizeof(uint32_t));
+        output.close();
+
+        if (!output) {
+            std::cerr << "Warning: Could not write the snapshot " << fileName << '\n';
+            std::filesystem::remove(temporaryName, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryName, fileName, error);
+    if (error) {
+        std::cerr << "Warning: Could not write the snapshot " << fileName << ": " << error.message() << '\n';
+        std::filesystem::remove(temporaryName, error);
+    }
+}
@@ -0,0 +1,616 @@
+#include "../include/tree_spill.h"
+#include "../include/tree_layout.h"
+#include "../include/utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+static size_t alignTo8(size_t size) {
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+template<typename Record>
+static Record readRecord(const char* data) {
+    Record record;
+    std::memcpy(&record, data, sizeof(Record));
+    return record;
+}
+
+/*
+Description:
+    Creates the spill files of a tree in the given directory, or the temporary directory of the system when it is empty. The
+    names are unique in the process, so the trees of a comparison can share the directory.
+*/
+TreeSpill::TreeSpill(const Options& options) : options(options) {
+    static std::atomic<uint64_t> spillCount{0};
+
+    std::string baseName = "ast-tree-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "-"
+                         + std::to_string(spillCount++);
+    std::filesystem::path directory = options.directory.empty() ? std::filesystem::temp_directory_path()
+                                                                : std::filesystem::path(options.directory);
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    pagesFileName = (directory / (baseName + ".pages")).string();
+    keysFileName = (directory / (baseName + ".keys")).string();
+    indexFileName = (directory / (baseName + ".index")).string();
+
+    pagesOutput.open(pagesFileName, std::ios::binary | std::ios::trunc);
+    keysOutput.open(keysFileName, std::ios::binary | std::ios::trunc);
+    if (!pagesOutput.is_open() || !keysOutput.is_open()) {
+        throw std::runtime_error("Could not create spill files in directory: " + directory.string());
+    }
+    types.push_back(0);
+}
+
+/*
+Description:
+    Releases the strings of the materialized pages and removes the spill files.
+*/
+TreeSpill::~TreeSpill() {
+    while (!leastRecentlyUsed.empty()) {
+        evictPage(leastRecentlyUsed.back());
+    }
+    index.reset();
+    pagesOutput.close();
+    keysOutput.close();
+    pagesInput.close();
+    keysInput.close();
+
+    std::error_code error;
+    std::filesystem::remove(pagesFileName, error);
+    std::filesystem::remove(keysFileName, error);
+    std::filesystem::remove(indexFileName, error);
+}
+
+/*
+Description:
+    Returns the number of nodes after which the parser starts a new page, the limit is chosen so that a few pages fit into the
+    memory limit. A top-level subtree is never divided, so a page can hold more nodes.
+*/
+size_t TreeSpill::getPageNodeLimit() const {
+    return std::max<size_t>(options.memoryLimit / (residentPageTarget * estimatedNodeBytes), 1);
+}
+
+/*
+Description:
+    Sets the root of the tree, it stays in memory for the lifetime of the tree and is not part of any page, only its key is
+    added to the index.
+*/
+void TreeSpill::setRoot(Node* node) {
+    root = node;
+    types[0] = static_cast<uint8_t>(node->type);
+
+    if (node->type == DECLARATION) {
+        keyEntries.push_back({static_cast<uint64_t>(node->enhancedKey.hash()), 0, static_cast<uint32_t>(node->enhancedKey.size()), keysSize});
+        keysOutput.write(node->enhancedKey.c_str(), static_cast<std::streamsize>(node->enhancedKey.size()));
+        keysSize += node->enhancedKey.size();
+    }
+}
+
+/*
+Description:
+    Writes the nodes of the arena as the next page, the arena has to hold complete top-level subtrees in preorder, numbered
+    with their global topological order. The statement nodes are stored in groups of their declaration parent, the keys of
+    the declarations are appended to the index.
+*/
+void TreeSpill::writePage(const NodeArena& arena, const std::vector<std::pair<const Node*, Node*>>& stmtNodes) {
+    if (arena.size() == 0) {
+        return;
+    }
+    if (!root) {
+        throw std::runtime_error("The root of the tree has to be set before its pages are written.");
+    }
+
+    PageEntry page{nodeCount, static_cast<uint32_t>(arena.size()), pagesSize, 0};
+
+    // local string table of the page
+    std::unordered_map<uint32_t, uint32_t> stringIndices;
+    std::vector<const std::string*> strings;
+    auto addString = [&stringIndices, &strings](const InternedString& string) {
+        auto [it, isNew] = stringIndices.emplace(string.id(), static_cast<uint32_t>(strings.size()));
+        if (isNew) {
+            strings.push_back(&string.str());
+        }
+        return it->second;
+    };
+
+    std::vector<NodeRecord> records;
+    std::vector<const Node*> pageNodes;
+    records.reserve(arena.size());
+    pageNodes.reserve(arena.size());
+    bool isValid = true;
+    arena.forEachNode([&](const Node* node) {
+        uint32_t nodeIndex = static_cast<uint32_t>(node->topologicalOrder);
+        uint32_t parentIndex = node->parent ? static_cast<uint32_t>(node->parent->topologicalOrder) : 0;
+        if (nodeIndex != page.firstNode + records.size() || (node->parent != root && (parentIndex < page.firstNode || parentIndex >= nodeIndex))) {
+            isValid = false;
+            return;
+        }
+
+        records.push_back({parentIndex, addString(node->kind), addString(node->usr), addString(node->path), addString(node->enhancedKey),
+                           node->lineNumber, node->columnNumber, static_cast<uint32_t>(node->type), 0});
+        pageNodes.push_back(node);
+        types.push_back(static_cast<uint8_t>(node->type));
+        if (node->parent == root) {
+            topLevelNodes.push_back(nodeIndex);
+        }
+
+        if (node->type == DECLARATION) {
+            keyEntries.push_back({static_cast<uint64_t>(node->enhancedKey.hash()), nodeIndex, static_cast<uint32_t>(node->enhancedKey.size()), keysSize});
+            keysOutput.write(node->enhancedKey.c_str(), static_cast<std::streamsize>(node->enhancedKey.size()));
+            keysSize += node->enhancedKey.size();
+        }
+    });
+    if (!isValid) {
+        throw std::runtime_error("A page of the tree has to hold complete top-level subtrees in preorder.");
+    }
+
+    // Merkle fingerprints, the subtrees of the page are complete, the top-level nodes are added to the root's children
+    std::vector<size_t> childrenHashes(records.size(), 0);
+    for (size_t position = records.size(); position-- > 0;) {
+        size_t fingerprint = Utils::getFingerPrint(pageNodes[position], childrenHashes[position]);
+        records[position].fingerprint = static_cast<uint64_t>(fingerprint);
+
+        uint32_t nodeIndex = page.firstNode + static_cast<uint32_t>(position);
+        uint32_t parentIndex = records[position].parent;
+        size_t& parentHash = pageNodes[position]->parent == root ? rootChildrenHash : childrenHashes[parentIndex - page.firstNode];
+        parentHash = Utils::addChildFingerPrint(parentHash, fingerprint, nodeIndex - parentIndex);
+    }
+
+    // statements grouped by their declaration parent in file order
+    std::vector<StmtGroupRecord> groups;
+    std::vector<uint32_t> groupNodes;
+    std::unordered_map<const Node*, std::vector<uint32_t>> nodesByDeclaration;
+    std::vector<const Node*> declarations;
+    for (const auto& [declarationParent, node] : stmtNodes) {
+        uint32_t nodeIndex = static_cast<uint32_t>(node->topologicalOrder);
+        if (declarationParent == root) {
+            rootStmtNodes.push_back(nodeIndex);
+            continue;
+        }
+
+        std::vector<uint32_t>& nodes = nodesByDeclaration[declarationParent];
+        if (nodes.empty()) {
+            declarations.push_back(declarationParent);
+        }
+        nodes.push_back(nodeIndex);
+    }
+    for (const Node* declaration : declarations) {
+        std::vector<uint32_t>& nodes = nodesByDeclaration[declaration];
+        groups.push_back({static_cast<uint32_t>(declaration->topologicalOrder), static_cast<uint32_t>(groupNodes.size()),
+                          static_cast<uint32_t>(nodes.size()), 0});
+        groupNodes.insert(groupNodes.end(), nodes.begin(), nodes.end());
+    }
+
+    // page blob
+    PageHeader header{page.nodeCount, static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(groups.size()),
+                      static_cast<uint32_t>(groupNodes.size()), 0};
+    std::vector<uint32_t> stringOffsets;
+    stringOffsets.reserve(strings.size() + 1);
+    stringOffsets.push_back(0);
+    for (const std::string* string : strings) {
+        header.stringBytes += string->size();
+        stringOffsets.push_back(static_cast<uint32_t>(header.stringBytes));
+    }
+
+    std::string blob;
+    size_t offsetsSize = alignTo8(stringOffsets.size() * sizeof(uint32_t));
+    size_t stringsSize = alignTo8(static_cast<size_t>(header.stringBytes));
+    blob.reserve(sizeof(PageHeader) + offsetsSize + stringsSize + records.size() * sizeof(NodeRecord)
+                 + groups.size() * sizeof(StmtGroupRecord) + groupNodes.size() * sizeof(uint32_t));
+    blob.append(reinterpret_cast<const char*>(&header), sizeof(PageHeader));
+    blob.append(reinterpret_cast<const char*>(stringOffsets.data()), stringOffsets.size() * sizeof(uint32_t));
+    blob.resize(sizeof(PageHeader) + offsetsSize, '\0');
+    for (const std::string* string : strings) {
+        blob.append(*string);
+    }
+    blob.resize(sizeof(PageHeader) + offsetsSize + stringsSize, '\0');
+    blob.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(NodeRecord));
+    blob.append(reinterpret_cast<const char*>(groups.data()), groups.size() * sizeof(StmtGroupRecord));
+    blob.append(reinterpret_cast<const char*>(groupNodes.data()), groupNodes.size() * sizeof(uint32_t));
+
+    pagesOutput.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+    if (!pagesOutput || !keysOutput) {
+        throw std::runtime_error("Could not write spill file: " + pagesFileName);
+    }
+
+    page.size = blob.size();
+    pagesSize += blob.size();
+    nodeCount += page.nodeCount;
+    pages.push_back(page);
+}
+
+/*
+Description:
+    Ends the construction: finishes the fingerprint of the root, writes the sorted key index and opens the spill files for reading.
+*/
+void TreeSpill::finish() {
+    if (root) {
+        root->fingerprint = Utils::getFingerPrint(root, rootChildrenHash);
+    }
+
+    pagesOutput.close();
+    keysOutput.close();
+
+    std::sort(keyEntries.begin(), keyEntries.end(), [](const KeyEntry& lhs, const KeyEntry& rhs) {
+        return lhs.hash != rhs.hash ? lhs.hash < rhs.hash : lhs.node < rhs.node;
+    });
+    {
+        std::ofstream indexOutput(indexFileName, std::ios::binary | std::ios::trunc);
+        indexOutput.write(reinterpret_cast<const char*>(keyEntries.data()), static_cast<std::streamsize>(keyEntries.size() * sizeof(KeyEntry)));
+        if (!indexOutput) {
+            throw std::runtime_error("Could not write spill file: " + indexFileName);
+        }
+    }
+    keyEntries.clear();
+    keyEntries.shrink_to_fit();
+    index = std::make_unique<MappedFile>(indexFileName);
+
+    pagesInput.open(pagesFileName, std::ios::binary);
+    keysInput.open(keysFileName, std::ios::binary);
+    if (!pagesInput.is_open() || !keysInput.is_open()) {
+        throw std::runtime_error("Could not open spill file: " + pagesFileName);
+    }
+
+    residentPages.resize(pages.size());
+}
+
+/*
+Description:
+    Returns the number of nodes of the tree, including the root.
+*/
+uint32_t TreeSpill::size() const {
+    return nodeCount;
+}
+
+/*
+Description:
+    Returns the node of the given preorder index, its page is materialized when it is not in memory. The node stays valid until
+    the next call of releaseNodes().
+*/
+Node* TreeSpill::getNode(uint32_t nodeIndex) {
+    if (nodeIndex == 0 || nodeIndex >= nodeCount) {
+        return nodeIndex == 0 ? root : nullptr;
+    }
+
+    uint32_t pageIndex = pageOf(nodeIndex);
+    return loadPage(pageIndex).nodes[nodeIndex - pages[pageIndex].firstNode];
+}
+
+/*
+Description:
+    Returns the type of the node, it is kept in memory for every node.
+*/
+NodeType TreeSpill::getType(uint32_t nodeIndex) const {
+    return static_cast<NodeType>(types[nodeIndex]);
+}
+
+/*
+Description:
+    Returns the preorder indices of the children of the node, the range stays valid until the next call of releaseNodes().
+*/
+std::pair<const uint32_t*, const uint32_t*> TreeSpill::getChildIndices(uint32_t nodeIndex) {
+    if (nodeIndex == 0) {
+        return {topLevelNodes.data(), topLevelNodes.data() + topLevelNodes.size()};
+    }
+
+    uint32_t pageIndex = pageOf(nodeIndex);
+    ResidentPage& page = loadPage(pageIndex);
+    uint32_t position = nodeIndex - pages[pageIndex].firstNode;
+    return {page.globalChildren.data() + page.childOffsets[position], page.globalChildren.data() + page.childOffsets[position + 1]};
+}
+
+/*
+Description:
+    Checks if there is a declaration with the given key, the key is looked up in the index and verified against the stored key
+    text, so no page is materialized.
+*/
+bool TreeSpill::containsDeclKey(const InternedString& key) const {
+    auto [first, last] = findKeyEntries(key);
+    std::string storedKey;
+    for (const KeyEntry* entry = first; entry != last; ++entry) {
+        if (entry->keyLength != key.size()) {
+            continue;
+        }
+
+        storedKey.resize(entry->keyLength);
+        keysInput.clear();
+        keysInput.seekg(static_cast<std::streamoff>(entry->keyOffset));
+        keysInput.read(&storedKey[0], static_cast<std::streamsize>(storedKey.size()));
+        if (keysInput && storedKey == key.str()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+Description:
+    Collects the declarations with the given key in topological order, their pages are materialized.
+*/
+void TreeSpill::findDeclNodes(const InternedString& key, std::vector<Node*>& nodes) {
+    nodes.clear();
+    auto [first, last] = findKeyEntries(key);
+    for (const KeyEntry* entry = first; entry != last; ++entry) {
+        if (entry->keyLength != key.size()) {
+            continue;
+        }
+
+        Node* node = getNode(entry->node);
+        if (node && node->enhancedKey == key) {
+            nodes.push_back(node);
+        }
+    }
+}
+
+/*
+Description:
+    Collects the statements whose declaration parent is the given node in topological order.
+*/
+void TreeSpill::findStmtNodes(uint32_t declarationIndex, std::vector<Node*>& nodes) {
+    nodes.clear();
+    if (declarationIndex == 0) {
+        for (uint32_t nodeIndex : rootStmtNodes) {
+            nodes.push_back(getNode(nodeIndex));
+        }
+        return;
+    }
+    if (declarationIndex >= nodeCount) {
+        return;
+    }
+
+    ResidentPage& page = loadPage(pageOf(declarationIndex));
+    auto it = page.stmtGroups.find(declarationIndex);
+    if (it == page.stmtGroups.end()) {
+        return;
+    }
+    for (uint32_t i = it->second.first; i < it->second.second; ++i) {
+        nodes.push_back(page.nodes[page.stmtNodes[i]]);
+    }
+}
+
+/*
+Description:
+    Calls the function for the nodes of the subtree in preorder with their depth below the given node. A walk over the whole
+    tree evicts the pages it materialized itself as soon as they are done, so it works within the memory limit.
+*/
+void TreeSpill::processSubTree(uint32_t nodeIndex, const std::function<void(Node*, int)>& processNode) {
+    if (nodeIndex == 0) {
+        processNode(root, 0);
+        for (uint32_t pageIndex = 0; pageIndex < pages.size(); ++pageIndex) {
+            bool wasResident = residentPages[pageIndex] != nullptr;
+            ResidentPage& page = loadPage(pageIndex);
+            for (size_t position = 0; position < page.nodes.size(); ++position) {
+                processNode(page.nodes[position], static_cast<int>(page.depths[position]));
+            }
+            if (!wasResident) {
+                evictPage(pageIndex);
+            }
+        }
+        return;
+    }
+    if (nodeIndex >= nodeCount) {
+        return;
+    }
+
+    uint32_t pageIndex = pageOf(nodeIndex);
+    ResidentPage& page = loadPage(pageIndex);
+    uint32_t first = nodeIndex - pages[pageIndex].firstNode;
+    uint32_t last = page.subtreeEnds[first] - pages[pageIndex].firstNode;
+    uint32_t baseDepth = page.depths[first];
+    for (uint32_t position = first; position < last; ++position) {
+        processNode(page.nodes[position], static_cast<int>(page.depths[position] - baseDepth));
+    }
+}
+
+/*
+Description:
+    Evicts the least recently used pages until the materialized pages fit into the memory limit. Nodes and child ranges returned
+    earlier may be invalid afterwards, so it is only called between the steps of a comparison.
+*/
+void TreeSpill::releaseNodes() {
+    while (residentBytes > options.memoryLimit && !leastRecentlyUsed.empty()) {
+        evictPage(leastRecentlyUsed.back());
+    }
+}
+
+/*
+Description:
+    Returns the number of pages of the tree.
+*/
+size_t TreeSpill::getPageCount() const {
+    return pages.size();
+}
+
+/*
+Description:
+    Returns the number of materialized pages.
+*/
+size_t TreeSpill::getResidentPageCount() const {
+    return leastRecentlyUsed.size();
+}
+
+/*
+Description:
+    Returns the estimated memory of the materialized pages in bytes.
+*/
+size_t TreeSpill::getResidentBytes() const {
+    return residentBytes;
+}
+
+/*
+Description:
+    Returns the page holding the node, the pages are ordered by their first node.
+*/
+uint32_t TreeSpill::pageOf(uint32_t nodeIndex) const {
+    auto it = std::upper_bound(pages.begin(), pages.end(), nodeIndex,
+                               [](uint32_t value, const PageEntry& page) { return value < page.firstNode; });
+    return static_cast<uint32_t>(it - pages.begin()) - 1;
+}
+
+/*
+Description:
+    Returns the materialized page, reads it from the pages file when it is not in memory. The strings of the page are acquired
+    from the pool and the children of its nodes are linked.
+*/
+TreeSpill::ResidentPage& TreeSpill::loadPage(uint32_t pageIndex) {
+    std::unique_ptr<ResidentPage>& residentPage = residentPages[pageIndex];
+    if (residentPage) {
+        leastRecentlyUsed.splice(leastRecentlyUsed.begin(), leastRecentlyUsed, residentPage->lruPosition);
+        return *residentPage;
+    }
+
+    const PageEntry& entry = pages[pageIndex];
+    std::vector<char> blob(static_cast<size_t>(entry.size));
+    pagesInput.clear();
+    pagesInput.seekg(static_cast<std::streamoff>(entry.offset));
+    pagesInput.read(blob.data(), static_cast<std::streamsize>(blob.size()));
+    if (!pagesInput || blob.size() < sizeof(PageHeader)) {
+        throw std::runtime_error("Could not read page of spill file: " + pagesFileName);
+    }
+
+    PageHeader header = readRecord<PageHeader>(blob.data());
+    size_t offsetsStart = sizeof(PageHeader);
+    size_t stringsStart = offsetsStart + alignTo8((static_cast<size_t>(header.stringCount) + 1) * sizeof(uint32_t));
+    size_t recordsStart = stringsStart + alignTo8(static_cast<size_t>(header.stringBytes));
+    size_t groupsStart = recordsStart + static_cast<size_t>(header.nodeCount) * sizeof(NodeRecord);
+    size_t groupNodesStart = groupsStart + static_cast<size_t>(header.stmtGroupCount) * sizeof(StmtGroupRecord);
+    if (header.nodeCount != entry.nodeCount || groupNodesStart + static_cast<size_t>(header.stmtNodeCount) * sizeof(uint32_t) != blob.size()) {
+        throw std::runtime_error("Damaged page in spill file: " + pagesFileName);
+    }
+
+    auto page = std::make_unique<ResidentPage>();
+    page->strings.reserve(header.stringCount);
+    for (uint32_t i = 0; i < header.stringCount; ++i) {
+        uint32_t begin = readRecord<uint32_t>(blob.data() + offsetsStart + i * sizeof(uint32_t));
+        uint32_t end = readRecord<uint32_t>(blob.data() + offsetsStart + (i + 1) * sizeof(uint32_t));
+        page->strings.push_back(InternedString::acquire(std::string_view(blob.data() + stringsStart + begin, end - begin)));
+    }
+
+    // nodes, parents precede their children
+    uint32_t firstNode = entry.firstNode;
+    page->nodes.reserve(entry.nodeCount);
+    page->depths.reserve(entry.nodeCount);
+    std::vector<uint32_t> parents(entry.nodeCount);
+    std::vector<uint32_t> childCounts(entry.nodeCount + 1, 0);
+    for (uint32_t position = 0; position < entry.nodeCount; ++position) {
+        NodeRecord record = readRecord<NodeRecord>(blob.data() + recordsStart + position * sizeof(NodeRecord));
+
+        Node* node = page->arena.createNode();
+        node->type = static_cast<NodeType>(record.type);
+        node->kind = page->strings[record.kind];
+        node->usr = page->strings[record.usr];
+        node->path = page->strings[record.path];
+        node->enhancedKey = page->strings[record.enhancedKey];
+        node->lineNumber = record.lineNumber;
+        node->columnNumber = record.columnNumber;
+        node->topologicalOrder = static_cast<int>(firstNode + position);
+        node->fingerprint = static_cast<size_t>(record.fingerprint);
+
+        if (record.parent == 0) {
+            node->parent = root;
+            parents[position] = TreeLayout::noIndex;
+            page->depths.push_back(1);
+        } else {
+            uint32_t parentPosition = record.parent - firstNode;
+            node->parent = page->nodes[parentPosition];
+            parents[position] = parentPosition;
+            page->depths.push_back(page->depths[parentPosition] + 1);
+            ++childCounts[parentPosition + 1];
+        }
+        page->nodes.push_back(node);
+    }
+
+    // children in CSR form, children follow their parent in file order
+    page->childOffsets.resize(entry.nodeCount + 1, 0);
+    for (uint32_t position = 0; position < entry.nodeCount; ++position) {
+        page->childOffsets[position + 1] = page->childOffsets[position] + childCounts[position + 1];
+    }
+    page->localChildren.resize(page->childOffsets.back());
+    page->globalChildren.resize(page->childOffsets.back());
+    std::vector<uint32_t> nextChild(page->childOffsets.begin(), page->childOffsets.end() - 1);
+    for (uint32_t position = 0; position < entry.nodeCount; ++position) {
+        if (parents[position] != TreeLayout::noIndex) {
+            uint32_t slot = nextChild[parents[position]]++;
+            page->localChildren[slot] = position;
+            page->globalChildren[slot] = firstNode + position;
+        }
+    }
+
+    page->subtreeEnds.assign(entry.nodeCount, 0);
+    for (uint32_t position = entry.nodeCount; position-- > 0;) {
+        uint32_t end = page->childOffsets[position] == page->childOffsets[position + 1]
+                     ? position + 1 : page->subtreeEnds[page->localChildren[page->childOffsets[position + 1] - 1]] - firstNode;
+        page->subtreeEnds[position] = firstNode + end;
+    }
+
+    for (uint32_t position = 0; position < entry.nodeCount; ++position) {
+        NodeChildren& children = page->nodes[position]->children;
+        children.indices = page->localChildren.data() + page->childOffsets[position];
+        children.nodes = page->nodes.data();
+        children.count = page->childOffsets[position + 1] - page->childOffsets[position];
+    }
+
+    // statement groups, positions in the page
+    page->stmtNodes.reserve(header.stmtNodeCount);
+    for (uint32_t i = 0; i < header.stmtNodeCount; ++i) {
+        page->stmtNodes.push_back(readRecord<uint32_t>(blob.data() + groupNodesStart + i * sizeof(uint32_t)) - firstNode);
+    }
+    for (uint32_t i = 0; i < header.stmtGroupCount; ++i) {
+        StmtGroupRecord group = readRecord<StmtGroupRecord>(blob.data() + groupsStart + i * sizeof(StmtGroupRecord));
+        page->stmtGroups.emplace(group.declaration, std::make_pair(group.firstNode, group.firstNode + group.nodeCount));
+    }
+
+    page->bytes = entry.nodeCount * (sizeof(Node) + sizeof(Node*) + 6 * sizeof(uint32_t))
+                + static_cast<size_t>(header.stringBytes) + header.stringCount * sizeof(InternedString::Entry)
+                + header.stmtNodeCount * sizeof(uint32_t) + header.stmtGroupCount * 4 * sizeof(uint32_t);
+    residentBytes += page->bytes;
+    leastRecentlyUsed.push_front(pageIndex);
+    page->lruPosition = leastRecentlyUsed.begin();
+
+    residentPage = std::move(page);
+    return *residentPage;
+}
+
+/*
+Description:
+    Frees the materialized page and releases its strings.
+*/
+void TreeSpill::evictPage(uint32_t pageIndex) {
+    std::unique_ptr<ResidentPage>& page = residentPages[pageIndex];
+    if (!page) {
+        return;
+    }
+
+    for (const InternedString& string : page->strings) {
+        InternedString::release(string);
+    }
+
+    residentBytes -= page->bytes;
+    leastRecentlyUsed.erase(page->lruPosition);
+    page.reset();
+}
+
+/*
+Description:
+    Returns the index entries with the hash of the key, entries of other keys with the same hash have to be filtered out.
+*/
+std::pair<const TreeSpill::KeyEntry*, const TreeSpill::KeyEntry*> TreeSpill::findKeyEntries(const InternedString& key) const {
+    if (!index) {
+        return {nullptr, nullptr};
+    }
+
+    const KeyEntry* entries = reinterpret_cast<const KeyEntry*>(index->data());
+    const KeyEntry* entriesEnd = entries + index->size() / sizeof(KeyEntry);
+    uint64_t hash = static_cast<uint64_t>(key.hash());
+    const KeyEntry* first = std::lower_bound(entries, entriesEnd, hash, [](const KeyEntry& entry, uint64_t value) { return entry.hash < value; });
+    const KeyEntry* last = first;
+    while (last != entriesEnd && last->hash == hash) {
+        ++last;
+    }
+    return {first, last};
+}
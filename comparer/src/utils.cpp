@@ -3,13 +3,14 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <charconv>
 
 /*
 Description:
     Generates a unique key for a statement node based on its parent
 */
 std::string Utils::getStmtKey(const Node* node, const std::string& declarationParentKey) {
-    std::string statementKey = node->kind + "|" + node->usr + "|" + node->path + "|";
+    std::string statementKey = node->kind.str() + "|" + node->usr.str() + "|" + node->path.str() + "|";
     return declarationParentKey + "|" + statementKey;  // concatenate parent and current node's key
 }
 
@@ -18,25 +19,47 @@ Description:
     Generates an enhanced key of the node from the path to the root
 */
 std::string Utils::getEnhancedDeclKey(const Node* node) {
-    std::string key = node->kind + "|" + node->usr + "|" + node->path + "|";
+    std::string key = node->kind.str() + "|" + node->usr.str() + "|" + node->path.str() + "|";
     return key;
 }
 
+// mixes a 64 bit value, finalizer of splitmix64
+static uint64_t mixHash(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+// combines the hash with a value, the order of the values matters
+static uint64_t combineHash(uint64_t hash, uint64_t value) {
+    return mixHash(hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2)));
+}
+
 /*
 Description:
-    Generates a unique fingerprint for a node based on its information and children, each node is hashed separately and the 
-    result is combined using XOR operation
+    Generates the Merkle fingerprint of a node from its kind, usr, path, location, type and the combined fingerprints of its
+    children, built with addChildFingerPrint. The topological order is left out, so equal subtrees at different positions of
+    the trees have equal fingerprints.
 */
-size_t Utils::getFingerPrint(const Node* node) {
-    size_t hash = hashString(node->kind) ^ hashString(node->usr) ^
-                  hashString(node->path) ^ std::hash<int>{}(node->lineNumber) ^
-                  std::hash<int>{}(node->columnNumber) ^ std::hash<int>{}(node->topologicalOrder);
-
-    for (const Node* child : node->children) {
-        hash ^= getFingerPrint(child);
-    }
+size_t Utils::getFingerPrint(const Node* node, size_t childrenHash) {
+    uint64_t hash = combineHash(node->kind.hash(), node->usr.hash());
+    hash = combineHash(hash, node->path.hash());
+    hash = combineHash(hash, static_cast<uint32_t>(node->lineNumber));
+    hash = combineHash(hash, static_cast<uint32_t>(node->columnNumber));
+    hash = combineHash(hash, static_cast<uint64_t>(node->type));
+    return static_cast<size_t>(combineHash(hash, childrenHash));
+}
 
-    return hash;
+/*
+Description:
+    Adds the fingerprint of a child to the combined fingerprints of the children of its parent. The child is weighted by its
+    preorder distance from the parent, so the order of the children is part of the result, but the children can be added in
+    any order: bottom-up in reverse preorder, or across the pages of an out-of-core tree.
+*/
+size_t Utils::addChildFingerPrint(size_t childrenHash, size_t childFingerPrint, uint32_t childOffset) {
+    return childrenHash + static_cast<size_t>(mixHash(combineHash(childFingerPrint, childOffset)));
 }
 
 /*
@@ -66,7 +89,7 @@ Description:
 void Utils::printNodeDetails(const Node* node, std::string indent) {
     std::cout << indent << "Node details:\n";
     std::cout << indent << node->kind << " " << node->type << " " << node->usr << " " << node->path << " " << node->lineNumber << ":" << node->columnNumber << "\n";
-    std::cout << indent << "*** Parent enhanced key: " << (node->parent ? node->parent->enhancedKey : "None") << "\n";
+    std::cout << indent << "*** Parent enhanced key: " << (node->parent ? node->parent->enhancedKey.str() : std::string("None")) << "\n";
     
     printSeparators();
 }
@@ -99,7 +122,7 @@ std::string Utils::nodeTypeToString(const NodeType type) {
 Description:
     Converts a string to a node type
 */
-NodeType Utils::stringToNodeType(const std::string& type) {
+NodeType Utils::stringToNodeType(std::string_view type) {
     if (type == "Declaration") {
         return DECLARATION;
     } else if (type == "Statement") {
@@ -140,6 +163,47 @@ std::vector<std::string> Utils::splitString(const std::string& str, const char d
     return tokens;
 }
 
+/*
+Description:
+    Splits a line into at most maxTokens views without allocating, the views point into the given line. Follows the 
+    std::getline semantics of splitString: a trailing delimiter does not produce an empty last token. Returns the number 
+    of tokens found.
+*/
+size_t Utils::splitLine(std::string_view line, std::string_view* tokens, size_t maxTokens, const char delimiter) {
+    size_t count = 0;
+    size_t start = 0;
+
+    while (start < line.size() && count < maxTokens) {
+        size_t end = line.find(delimiter, start);
+        if (end == std::string_view::npos) {
+            end = line.size();
+        }
+
+        tokens[count++] = line.substr(start, end - start);
+        start = end + 1;
+    }
+
+    return count;
+}
+
+/*
+Description:
+    Parses an integer from the beginning of the view with std::from_chars, leading whitespace is skipped similarly to
+    std::stoi. Returns false if no number could be parsed or it does not fit into an int.
+*/
+bool Utils::parseInt(std::string_view str, int& value) {
+    size_t first = 0;
+    while (first < str.size() && std::isspace(static_cast<unsigned char>(str[first]))) {
+        ++first;
+    }
+
+    const char* begin = str.data() + first;
+    const char* end = str.data() + str.size();
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+
+    return ec == std::errc() && ptr != begin;
+}
+
 /*
 Description:
     Trims the leading whitespace of a string
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include "../include/batch_comparer.h"
+#include "../include/counting_database_wrapper.h"
+#include "../include/tree_comparer.h"
+#include "dump_test_fixture.h"
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// counts the differences and records the comparisons they belong to
+class ComparisonRecordingWrapper : public CountingDatabaseWrapper {
+public:
+    std::vector<std::string> comparisons;
+    std::function<void()> onBeginComparison;
+
+    void beginComparison(const std::string& comparison) override {
+        comparisons.push_back(comparison);
+        if (onBeginComparison) {
+            onBeginComparison();
+        }
+    }
+};
+
+class BatchComparerTest : public DumpTestFixture {
+protected:
+    std::mutex loadMutex;
+    int runningPairs = 0;                // pairs with loaded trees that have not written their differences yet
+    int maxRunningPairs = 0;
+
+    void SetUp() override {
+        writeAST("test_batch_1.txt", baselineDump());
+        writeAST("test_batch_2.txt", candidateDump());
+    }
+
+    // loads the trees and tracks the running pairs, a pair starts with loading its first dump
+    BatchComparer::TreeLoader trackingLoader(const std::vector<BatchComparer::Pair>& pairs) {
+        return [this, &pairs](const std::string& filePath) {
+            std::lock_guard<std::mutex> lock(loadMutex);
+            bool isFirst = std::any_of(pairs.begin(), pairs.end(), [&filePath](const BatchComparer::Pair& pair) { return pair.first == filePath; });
+            if (isFirst) {
+                maxRunningPairs = std::max(maxRunningPairs, ++runningPairs);
+            }
+            return std::make_unique<Tree>(filePath, 1);
+        };
+    }
+
+    // differences of a single comparison of the dumps
+    static uint64_t countDifferences(const std::string& firstPath, const std::string& secondPath) {
+        Tree firstTree(firstPath, 1);
+        Tree secondTree(secondPath, 1);
+        CountingDatabaseWrapper counter;
+        TreeComparer comparer(firstTree, secondTree, counter);
+        comparer.printDifferences();
+        return counter.getNodeCount() + counter.getRelationshipCount();
+    }
+};
+
+// Test if the manifest is read line by line, comments and empty lines are skipped
+TEST_F(BatchComparerTest, ReadManifest_ReadsPairs) {
+    writeAST("test_batch_manifest.txt", {
+        "# nightly pairs",
+        "test_batch_1.txt\ttest_batch_2.txt",
+        "",
+        "test_batch_2.txt\ttest_batch_1.txt\r"
+    });
+
+    std::vector<BatchComparer::Pair> pairs = BatchComparer::readManifest("test_batch_manifest.txt");
+
+    ASSERT_EQ(pairs.size(), 2u);
+    EXPECT_EQ(pairs[0], BatchComparer::Pair("test_batch_1.txt", "test_batch_2.txt"));
+    EXPECT_EQ(pairs[1], BatchComparer::Pair("test_batch_2.txt", "test_batch_1.txt"));
+}
+
+// Test if a malformed line names its line number, a missing manifest throws as well
+TEST_F(BatchComparerTest, ReadManifest_InvalidLineThrows) {
+    writeAST("test_batch_manifest.txt", {
+        "test_batch_1.txt\ttest_batch_2.txt",
+        "test_batch_1.txt"
+    });
+
+    try {
+        BatchComparer::readManifest("test_batch_manifest.txt");
+        FAIL() << "Expected std::runtime_error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("line 2"), std::string::npos);
+    }
+    EXPECT_THROW(BatchComparer::readManifest("missing_manifest.txt"), std::runtime_error);
+}
+
+// Test if every pair writes the differences of a single comparison to the shared writer, a failed pair does not stop the batch
+TEST_F(BatchComparerTest, Run_WritesDifferencesOfAllPairs) {
+    std::vector<BatchComparer::Pair> pairs = {
+        {"test_batch_1.txt", "test_batch_2.txt"},
+        {"missing_batch.txt", "test_batch_2.txt"},
+        {"test_batch_2.txt", "test_batch_1.txt"},
+        {"test_batch_1.txt", "test_batch_1.txt"}
+    };
+    ComparisonRecordingWrapper writer;
+    BatchComparer::Options options;
+    options.threadCount = 3;
+    BatchComparer batch(writer, [](const std::string& filePath) { return std::make_unique<Tree>(filePath, 1); }, options);
+
+    BatchComparer::Report report = batch.run(pairs);
+
+    uint64_t expected = countDifferences("test_batch_1.txt", "test_batch_2.txt") + countDifferences("test_batch_2.txt", "test_batch_1.txt");
+    EXPECT_GT(expected, 0u);
+    EXPECT_EQ(report.pairs, 4u);
+    EXPECT_EQ(report.failed, 1u);
+    EXPECT_EQ(report.differences, expected);
+    EXPECT_EQ(writer.getNodeCount() + writer.getRelationshipCount(), expected);
+    EXPECT_GT(report.getPairsPerMinute(), 0);
+
+    std::sort(writer.comparisons.begin(), writer.comparisons.end());
+    EXPECT_EQ(writer.comparisons, std::vector<std::string>({
+        "test_batch_1.txt\ttest_batch_1.txt", "test_batch_1.txt\ttest_batch_2.txt", "test_batch_2.txt\ttest_batch_1.txt"
+    }));
+}
+
+// Test if pairs above the memory limit are admitted one at a time, and still compared
+TEST_F(BatchComparerTest, Run_AdmitsPairsWithinMemoryLimit) {
+    std::vector<BatchComparer::Pair> pairs(3, {"test_batch_1.txt", "test_batch_2.txt"});
+
+    // a pair is finished when it writes its differences
+    ComparisonRecordingWrapper writer;
+    writer.onBeginComparison = [this]() {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        --runningPairs;
+    };
+
+    BatchComparer::Options options;
+    options.threadCount = 4;
+    options.memoryLimit = 1000;
+    options.estimateMemory = [](const std::string&) { return size_t(800); };
+    BatchComparer batch(writer, trackingLoader(pairs), options);
+
+    BatchComparer::Report report = batch.run(pairs);
+
+    EXPECT_EQ(report.failed, 0u);
+    EXPECT_EQ(runningPairs, 0);
+    EXPECT_EQ(maxRunningPairs, 1);
+    EXPECT_GT(writer.getNodeCount(), 0u);
+}
+
+// Test if a binary dump is estimated like the text dump of the same tree, so pairs of binary dumps are admitted against the
+// memory their trees take and not against their smaller files
+TEST_F(BatchComparerTest, Run_AdmitsBinaryPairsByTheirTrees) {
+    std::vector<std::string> lines = {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0"};
+    for (int n = 0; n < 50; ++n) {
+        std::string path = "/usr/include/c++/12/bits/header_" + std::to_string(n % 10) + ".h";
+        lines.push_back(" Declaration\tNamespace\tc:@N@ns" + std::to_string(n) + "\t" + path + "\t1\t1");
+        for (int f = 0; f < 10; ++f) {
+            std::string line = std::to_string(10 * f + 2);
+            lines.push_back("  Declaration\tFunction\tc:@N@ns" + std::to_string(n) + "@F@function" + std::to_string(f) + "#I#\t" +
+                            path + "\t" + line + "\t1");
+            lines.push_back("   Statement\tCompoundStmt\tN/A\t" + path + "\t" + line + "\t5");
+            lines.push_back("    Statement\tReturnStmt\tN/A\t" + path + "\t" + line + "\t7");
+        }
+    }
+    writeAST("test_batch_tree.txt", lines);
+    writeBinaryAST("test_batch_tree.bin", lines);
+    writeBinaryAST("test_batch_tree_copy.bin", lines);
+
+    // both dumps build the same tree, the binary dump is several times smaller
+    size_t textEstimate = BatchComparer::estimateTreeMemory("test_batch_tree.txt");
+    size_t binaryEstimate = BatchComparer::estimateTreeMemory("test_batch_tree.bin");
+    ASSERT_LT(3 * std::filesystem::file_size("test_batch_tree.bin"), std::filesystem::file_size("test_batch_tree.txt"));
+    EXPECT_GT(binaryEstimate, textEstimate / 2);
+    EXPECT_LT(binaryEstimate, textEstimate * 2);
+
+    // the limit holds the trees of one pair, not of two
+    std::vector<BatchComparer::Pair> pairs(3, {"test_batch_tree.bin", "test_batch_tree_copy.bin"});
+    ComparisonRecordingWrapper writer;
+    writer.onBeginComparison = [this]() {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        --runningPairs;
+    };
+    BatchComparer::Options options;
+    options.threadCount = 2;
+    options.memoryLimit = 3 * textEstimate;
+    BatchComparer batch(writer, trackingLoader(pairs), options);
+
+    BatchComparer::Report report = batch.run(pairs);
+
+    EXPECT_EQ(report.failed, 0u);
+    EXPECT_EQ(runningPairs, 0);
+    EXPECT_EQ(maxRunningPairs, 1);
+}
+
+// Test if the strings of the compared pairs are released with their trees, a batch of dumps with new paths leaves the pool as it was
+TEST_F(BatchComparerTest, Run_ReleasesStringsOfThePairs) {
+    std::vector<BatchComparer::Pair> pairs;
+    for (int pair = 0; pair < 6; ++pair) {
+        std::string path = "/nightly/tu-" + std::to_string(pair) + ".cpp";
+        std::string firstFile = "test_batch_pair_" + std::to_string(pair) + "_1.txt";
+        std::string secondFile = "test_batch_pair_" + std::to_string(pair) + "_2.txt";
+        writeAST(firstFile, {
+            "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+            " Declaration\tFunction\tc:@F@nightly\t" + path + "\t10\t1",
+            "  Statement\tCompoundStmt\tN/A\t" + path + "\t10\t5"
+        });
+        writeAST(secondFile, {
+            "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+            " Declaration\tFunction\tc:@F@nightly\t" + path + "\t12\t1",
+            "  Statement\tReturnStmt\tN/A\t" + path + "\t13\t5"
+        });
+        pairs.emplace_back(firstFile, secondFile);
+    }
+    ComparisonRecordingWrapper writer;
+    BatchComparer::Options options;
+    options.threadCount = 2;
+    BatchComparer batch(writer, [](const std::string& filePath) { return std::make_unique<Tree>(filePath, 1); }, options);
+
+    size_t poolSize = InternedString::poolSize();
+    BatchComparer::Report report = batch.run(pairs);
+
+    EXPECT_EQ(report.failed, 0u);
+    EXPECT_GT(report.differences, 0u);
+    EXPECT_EQ(InternedString::poolSize(), poolSize);
+}
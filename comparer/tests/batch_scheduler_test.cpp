@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "../include/batch_scheduler.h"
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace {
+    const std::chrono::milliseconds blockedWait(100); // time a blocked call is given to return too early
+
+    // takes the next batch on another thread, the future is ready once a batch was handed out
+    std::future<BatchScheduler::Batch> takeAsync(BatchScheduler& scheduler) {
+        return std::async(std::launch::async, [&scheduler]() {
+            BatchScheduler::Batch batch;
+            EXPECT_TRUE(scheduler.take(batch));
+            return batch;
+        });
+    }
+}
+
+// Test if node batches are handed out at once and a relationship batch waits until all earlier node batches have finished,
+// also when they finish out of order
+TEST(BatchSchedulerTest, RelationshipsWaitForOutOfOrderNodeBatches) {
+    BatchScheduler scheduler(4);
+    scheduler.submitNodes("first nodes");
+    scheduler.submitNodes("second nodes");
+    scheduler.submitRelationships("relationships");
+    scheduler.submitNodes("third nodes");
+
+    BatchScheduler::Batch first;
+    BatchScheduler::Batch second;
+    BatchScheduler::Batch third;
+    ASSERT_TRUE(scheduler.take(first));
+    ASSERT_TRUE(scheduler.take(second));
+    ASSERT_TRUE(scheduler.take(third)); // the later node batch passes the waiting relationships
+    EXPECT_EQ(first.nodes, "first nodes");
+    EXPECT_EQ(second.nodes, "second nodes");
+    EXPECT_EQ(third.nodes, "third nodes");
+
+    auto relationships = takeAsync(scheduler);
+    scheduler.finish(second);
+    scheduler.finish(third);
+    EXPECT_EQ(relationships.wait_for(blockedWait), std::future_status::timeout);
+
+    scheduler.finish(first);
+    BatchScheduler::Batch batch = relationships.get();
+    EXPECT_EQ(batch.relationships, "relationships");
+    EXPECT_EQ(batch.nodeBatchIndex, 2u);
+    scheduler.finish(batch);
+    scheduler.drain();
+}
+
+// Test if submitting waits while the queue holds the maximum number of batches, and gets the buffer of a finished batch
+TEST(BatchSchedulerTest, SubmitWaitsWhileQueueIsFull) {
+    BatchScheduler scheduler(2);
+    scheduler.submitNodes(std::string(1000, 'n'));
+    scheduler.submitNodes("second nodes");
+
+    auto submitted = std::async(std::launch::async, [&scheduler]() { return scheduler.submitNodes("third nodes"); });
+    EXPECT_EQ(submitted.wait_for(blockedWait), std::future_status::timeout);
+
+    BatchScheduler::Batch batch;
+    ASSERT_TRUE(scheduler.take(batch));
+    EXPECT_TRUE(submitted.get().empty()); // no batch has finished yet
+    scheduler.finish(batch);
+
+    ASSERT_TRUE(scheduler.take(batch)); // room for the relationships
+    std::string buffer = scheduler.submitRelationships("relationships");
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_GE(buffer.capacity(), 1000u); // the buffer of the finished batch is reused
+}
+
+// Test if draining waits for the batches that are queued or being sent, and a stopped scheduler still hands out the queued
+// batches before take returns false
+TEST(BatchSchedulerTest, DrainAndStopWaitForQueuedBatches) {
+    BatchScheduler scheduler(4);
+    scheduler.submitNodes("first nodes");
+    scheduler.submitRelationships("relationships");
+
+    BatchScheduler::Batch first;
+    ASSERT_TRUE(scheduler.take(first));
+    auto drained = std::async(std::launch::async, [&scheduler]() { scheduler.drain(); });
+    EXPECT_EQ(drained.wait_for(blockedWait), std::future_status::timeout);
+
+    scheduler.stop();
+    scheduler.finish(first);
+    EXPECT_EQ(drained.wait_for(blockedWait), std::future_status::timeout); // the relationships are still queued
+
+    BatchScheduler::Batch batch;
+    ASSERT_TRUE(scheduler.take(batch));
+    EXPECT_EQ(batch.relationships, "relationships");
+    scheduler.finish(batch);
+    drained.get();
+    EXPECT_FALSE(scheduler.take(batch));
+}
@@ -0,0 +1,33 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/comparer/tests/batch_comparer_test.cpp" "CMakeFiles/test_all.dir/batch_comparer_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/batch_comparer_test.cpp.o.d"
+  "/root/repo/comparer/tests/batch_scheduler_test.cpp" "CMakeFiles/test_all.dir/batch_scheduler_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/batch_scheduler_test.cpp.o.d"
+  "/root/repo/comparer/tests/comparer_daemon_test.cpp" "CMakeFiles/test_all.dir/comparer_daemon_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/comparer_daemon_test.cpp.o.d"
+  "/root/repo/comparer/tests/csv_import_writer_test.cpp" "CMakeFiles/test_all.dir/csv_import_writer_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/csv_import_writer_test.cpp.o.d"
+  "/root/repo/comparer/tests/database_sink_test.cpp" "CMakeFiles/test_all.dir/database_sink_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/database_sink_test.cpp.o.d"
+  "/root/repo/comparer/tests/decl_join_test.cpp" "CMakeFiles/test_all.dir/decl_join_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/decl_join_test.cpp.o.d"
+  "/root/repo/comparer/tests/flat_index_test.cpp" "CMakeFiles/test_all.dir/flat_index_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/flat_index_test.cpp.o.d"
+  "/root/repo/comparer/tests/integration_test.cpp" "CMakeFiles/test_all.dir/integration_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/integration_test.cpp.o.d"
+  "/root/repo/comparer/tests/interned_string_test.cpp" "CMakeFiles/test_all.dir/interned_string_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/interned_string_test.cpp.o.d"
+  "/root/repo/comparer/tests/json_writer_test.cpp" "CMakeFiles/test_all.dir/json_writer_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/json_writer_test.cpp.o.d"
+  "/root/repo/comparer/tests/tree_comparer_test.cpp" "CMakeFiles/test_all.dir/tree_comparer_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/tree_comparer_test.cpp.o.d"
+  "/root/repo/comparer/tests/tree_test.cpp" "CMakeFiles/test_all.dir/tree_test.cpp.o" "gcc" "CMakeFiles/test_all.dir/tree_test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/comparer/tests/build/_deps/googletest-build/googletest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  "/root/repo/comparer/tests/build/_deps/googletest-build/googlemock/CMakeFiles/gmock.dir/DependInfo.cmake"
+  "/root/repo/comparer/tests/build/_deps/googletest-build/googletest/CMakeFiles/gtest_main.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,33 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_all.dir/batch_comparer_test.cpp.o"
+  "CMakeFiles/test_all.dir/batch_comparer_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/batch_scheduler_test.cpp.o"
+  "CMakeFiles/test_all.dir/batch_scheduler_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/comparer_daemon_test.cpp.o"
+  "CMakeFiles/test_all.dir/comparer_daemon_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/csv_import_writer_test.cpp.o"
+  "CMakeFiles/test_all.dir/csv_import_writer_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/database_sink_test.cpp.o"
+  "CMakeFiles/test_all.dir/database_sink_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/decl_join_test.cpp.o"
+  "CMakeFiles/test_all.dir/decl_join_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/flat_index_test.cpp.o"
+  "CMakeFiles/test_all.dir/flat_index_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/integration_test.cpp.o"
+  "CMakeFiles/test_all.dir/integration_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/interned_string_test.cpp.o"
+  "CMakeFiles/test_all.dir/interned_string_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/json_writer_test.cpp.o"
+  "CMakeFiles/test_all.dir/json_writer_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/tree_comparer_test.cpp.o"
+  "CMakeFiles/test_all.dir/tree_comparer_test.cpp.o.d"
+  "CMakeFiles/test_all.dir/tree_test.cpp.o"
+  "CMakeFiles/test_all.dir/tree_test.cpp.o.d"
+  "test_all"
+  "test_all.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_all.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
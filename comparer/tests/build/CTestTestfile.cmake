@@ -0,0 +1,10 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/comparer/tests
+# Build directory: /root/repo/comparer/tests/build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(test_all "/root/repo/comparer/tests/build/test_all")
+set_tests_properties(test_all PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/comparer/tests/CMakeLists.txt;77;add_test;/root/repo/comparer/tests/CMakeLists.txt;0;")
+subdirs("_deps/googletest-build")
+subdirs("_deps/nlohmann_json-build")
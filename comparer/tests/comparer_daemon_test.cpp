@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/comparer_daemon.h"
+#include "../include/counting_database_wrapper.h"
+#include "../include/tree_comparer.h"
+#include "dump_test_fixture.h"
+#include "mock_database_wrapper.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using ::testing::NiceMock;
+
+class ComparerDaemonTest : public DumpTestFixture {
+protected:
+    NiceMock<MockDatabaseWrapper> dbWrapper;
+    int loadCount = 0;
+
+    void SetUp() override {
+        writeAST("test_daemon_baseline.txt", baselineDump());
+        writeAST("test_daemon_candidate.txt", candidateDump());
+        removeAfterTest("test_daemon.sock");
+    }
+
+    ComparerDaemon::TreeLoader countingLoader() {
+        return [this](const std::string& filePath) {
+            ++loadCount;
+            return std::make_unique<Tree>(filePath, 1);
+        };
+    }
+
+    // summary of a comparison of freshly loaded trees, in the format of the daemon without the timings
+    std::string expectedSummary() {
+        Tree baseline("test_daemon_baseline.txt", 1);
+        Tree candidate("test_daemon_candidate.txt", 1);
+        CountingDatabaseWrapper counter;
+        TreeComparer comparer(baseline, candidate, counter);
+        comparer.printDifferences();
+
+        std::string summary = "ok\tnodes=" + std::to_string(counter.getNodeCount()) + "\trelationships=" + std::to_string(counter.getRelationshipCount());
+        for (const auto& [labels, count] : counter.getNodeCounts()) {
+            summary += "\t" + labels.first + ":" + labels.second + "=" + std::to_string(count);
+        }
+        return summary;
+    }
+
+    static std::string withoutTimings(const std::string& answer) {
+        return answer.substr(0, answer.find("\tload_ms="));
+    }
+
+    // connects to the socket of the daemon, retries until the daemon listens
+    static int connectClient() {
+        int client = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (client < 0) {
+            return -1;
+        }
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, "test_daemon.sock");
+        for (int attempt = 0; attempt < 200; ++attempt) {
+            if (connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+                return client;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        close(client);
+        return -1;
+    }
+
+    // reads the answers until the daemon closes the connection
+    static std::string receiveAll(int client) {
+        std::string answers;
+        char chunk[1024];
+        for (ssize_t received; (received = recv(client, chunk, sizeof(chunk), 0)) > 0;) {
+            answers.append(chunk, static_cast<size_t>(received));
+        }
+        return answers;
+    }
+};
+
+// Test if the baseline is loaded once and compared with every candidate, the summary matches a single comparison
+TEST_F(ComparerDaemonTest, HandleRequest_BaselineStaysResident) {
+    ComparerDaemon daemon("test_daemon.sock", dbWrapper, countingLoader(), 1);
+    std::string expected = expectedSummary();
+    EXPECT_NE(expected.find("ONLY_IN_SECOND_AST:SECOND_AST="), std::string::npos);
+
+    EXPECT_CALL(dbWrapper, clearDatabase()).Times(3);
+    for (int i = 0; i < 3; ++i) {
+        std::string answer = daemon.handleRequest("compare\ttest_daemon_baseline.txt\ttest_daemon_candidate.txt");
+        EXPECT_EQ(withoutTimings(answer), expected);
+        EXPECT_NE(answer.find("\tcompare_ms="), std::string::npos);
+    }
+
+    // the baseline once, the candidate for every request
+    EXPECT_EQ(loadCount, 4);
+    EXPECT_EQ(daemon.handleRequest("status"), "ok\tbaselines=1");
+}
+
+// Test if the strings of the candidates are released with them, candidates with new paths do not grow the string pool
+TEST_F(ComparerDaemonTest, HandleRequest_CandidateStringsAreReleased) {
+    ComparerDaemon daemon("test_daemon.sock", dbWrapper, countingLoader(), 1);
+    auto writeCandidate = [this](int request) {
+        std::string path = "/ci/checkout-" + std::to_string(request) + "/include/config.h";
+        writeAST("test_daemon_candidate.txt", {
+            "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+            " Declaration\tNamespace\tc:@N@std\t" + path + "\t308\t1",
+            "  Declaration\tFunction\tc:@F@doSomething\t" + path + "\t350\t5",
+            "   Statement\tCompoundStmt\tN/A\t" + path + "\t351\t6",
+            "    Statement\tReturnStmt\tN/A\t" + path + "\t354\t7"
+        });
+    };
+
+    writeCandidate(0);
+    ASSERT_EQ(daemon.handleRequest("compare\ttest_daemon_baseline.txt\ttest_daemon_candidate.txt").rfind("ok\t", 0), 0u);
+    size_t poolSize = InternedString::poolSize();
+    for (int request = 1; request <= 20; ++request) {
+        writeCandidate(request);
+        ASSERT_EQ(daemon.handleRequest("compare\ttest_daemon_baseline.txt\ttest_daemon_candidate.txt").rfind("ok\t", 0), 0u);
+        EXPECT_EQ(InternedString::poolSize(), poolSize);
+    }
+
+    // the baseline keeps its strings until it is unloaded
+    EXPECT_EQ(daemon.handleRequest("unload\ttest_daemon_baseline.txt"), "ok");
+    EXPECT_LT(InternedString::poolSize(), poolSize);
+}
+
+// Test the baseline management requests and the answers of invalid requests
+TEST_F(ComparerDaemonTest, HandleRequest_LoadUnloadAndErrors) {
+    ComparerDaemon daemon("test_daemon.sock", dbWrapper, countingLoader(), 1);
+
+    EXPECT_EQ(daemon.handleRequest("load\ttest_daemon_baseline.txt"), "ok\tnodes=6");
+    EXPECT_EQ(daemon.handleRequest("load\ttest_daemon_baseline.txt"), "ok\tnodes=6");
+    EXPECT_EQ(loadCount, 1);
+    EXPECT_EQ(daemon.handleRequest("unload\ttest_daemon_baseline.txt"), "ok");
+    EXPECT_EQ(daemon.handleRequest("status"), "ok\tbaselines=0");
+
+    EXPECT_EQ(daemon.handleRequest("unload\ttest_daemon_baseline.txt").rfind("error\t", 0), 0u);
+    EXPECT_EQ(daemon.handleRequest("compare\tmissing_baseline.txt\ttest_daemon_candidate.txt").rfind("error\t", 0), 0u);
+    EXPECT_EQ(daemon.handleRequest("compare\ttest_daemon_baseline.txt").rfind("error\t", 0), 0u);
+    EXPECT_EQ(daemon.handleRequest("restart").rfind("error\t", 0), 0u);
+    EXPECT_FALSE(daemon.isStopping());
+
+    EXPECT_EQ(daemon.handleRequest("shutdown"), "ok");
+    EXPECT_TRUE(daemon.isStopping());
+}
+
+// Test a client session over the socket: several requests on one connection, the daemon stops after the shutdown request
+TEST_F(ComparerDaemonTest, Run_ServesRequestsOverSocket) {
+    ComparerDaemon daemon("test_daemon.sock", dbWrapper, countingLoader(), 1);
+    std::string expected = expectedSummary();
+    std::thread server([&daemon]() { daemon.run(); });
+
+    int client = connectClient();
+    ASSERT_GE(client, 0);
+
+    std::string requests = "load\ttest_daemon_baseline.txt\n"
+                           "compare\ttest_daemon_baseline.txt\ttest_daemon_candidate.txt\r\n"
+                           "shutdown\n";
+    ASSERT_EQ(send(client, requests.data(), requests.size(), 0), static_cast<ssize_t>(requests.size()));
+
+    std::string answers = receiveAll(client);
+    close(client);
+    server.join();
+
+    std::vector<std::string> lines;
+    for (size_t start = 0, end; (end = answers.find('\n', start)) != std::string::npos; start = end + 1) {
+        lines.push_back(answers.substr(start, end - start));
+    }
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0], "ok\tnodes=6");
+    EXPECT_EQ(withoutTimings(lines[1]), expected);
+    EXPECT_EQ(lines[2], "ok");
+    EXPECT_FALSE(std::filesystem::exists("test_daemon.sock"));
+}
+
+// Test if a client that connects and sends no complete request is disconnected after the timeout, the next client is served
+TEST_F(ComparerDaemonTest, Run_DisconnectsIdleClient) {
+    ComparerDaemon daemon("test_daemon.sock", dbWrapper, countingLoader(), 1, 200);
+    std::thread server([&daemon]() { daemon.run(); });
+
+    int idleClient = connectClient();
+    ASSERT_GE(idleClient, 0);
+    ASSERT_EQ(send(idleClient, "stat", 4, 0), 4);
+
+    int client = connectClient();
+    ASSERT_GE(client, 0);
+    std::string requests = "status\nshutdown\n";
+    ASSERT_EQ(send(client, requests.data(), requests.size(), 0), static_cast<ssize_t>(requests.size()));
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(receiveAll(client), "ok\tbaselines=0\nok\n");
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    // the idle client was closed by the daemon without an answer
+    EXPECT_EQ(receiveAll(idleClient), "");
+
+    close(client);
+    close(idleClient);
+    server.join();
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "../include/counting_database_wrapper.h"
+#include "../include/csv_import_writer.h"
+#include "../include/tree_comparer.h"
+#include "dump_test_fixture.h"
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+class CsvImportWriterTest : public DumpTestFixture {
+protected:
+    void SetUp() override {
+        writeAST("test_csv_1.txt", baselineDump("C:\\include\\\"quoted\".h"));
+        writeAST("test_csv_2.txt", {
+            "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+            " Declaration\tNamespace\tc:@N@std\tC:\\include\\\"quoted\".h\t308\t1",
+            "  Declaration\tFunction\tc:@F@doSomethingElse\tC:\\include\\\"quoted\".h\t400\t5",
+            "   Statement\tCompoundStmt\tN/A\tC:\\include\\\"quoted\".h\t401\t6",
+            "    Statement\tReturnStmt\tN/A\tC:\\include\\\"quoted\".h\t402\t7"
+        });
+        removeAfterTest("test_csv_import");
+    }
+
+    // lines of the given files, the first file is the header and is skipped
+    static std::vector<std::string> readRows(const std::vector<std::string>& files) {
+        std::vector<std::string> rows;
+        for (size_t i = 1; i < files.size(); ++i) {
+            std::ifstream file(files[i]);
+            for (std::string line; std::getline(file, line);) {
+                rows.push_back(line);
+            }
+        }
+        return rows;
+    }
+
+    static std::string readFile(const std::string& path) {
+        std::ifstream file(path);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+};
+
+// Test if the rows match the counted differences, relationships connect written nodes and quotes in values are doubled
+TEST_F(CsvImportWriterTest, WritesNodesAndRelationshipsOfTheDifferences) {
+    Tree firstTree("test_csv_1.txt", 1);
+    Tree secondTree("test_csv_2.txt", 1);
+    CsvImportWriter writer("test_csv_import");
+    CountingDatabaseWrapper counter(&writer);
+    writer.clearDatabase();
+    writer.createIndices();
+    TreeComparer comparer(firstTree, secondTree, counter);
+    comparer.printDifferences();
+
+    EXPECT_EQ(readFile("test_csv_import/nodes_header.csv"),
+              "id:ID(Node),enhancedKey,type:int,kind,usr,path,lineNumber:int,columnNumber:int,topologicalOrder:int,"
+              "isHighLevel:boolean,diffType,ast,comparison\n");
+    EXPECT_EQ(readFile("test_csv_import/relationships_header.csv"), ":START_ID(Node),:END_ID(Node)\n");
+
+    std::vector<std::string> nodeRows = readRows(writer.getNodeFiles());
+    std::vector<std::string> relationshipRows = readRows(writer.getRelationshipFiles());
+    ASSERT_EQ(nodeRows.size(), counter.getNodeCount());
+    ASSERT_EQ(relationshipRows.size(), counter.getRelationshipCount());
+    EXPECT_GT(relationshipRows.size(), 0u);
+
+    std::set<std::string> nodeIds;
+    for (const std::string& row : nodeRows) {
+        EXPECT_TRUE(nodeIds.insert(row.substr(0, row.find(','))).second);
+        EXPECT_NE(row.find("\"C:\\include\\\"\"quoted\"\".h\""), std::string::npos);
+    }
+    for (const std::string& row : relationshipRows) {
+        size_t separator = row.find(',');
+        ASSERT_NE(separator, std::string::npos);
+        EXPECT_EQ(nodeIds.count(row.substr(0, separator)), 1u);
+        EXPECT_EQ(nodeIds.count(row.substr(separator + 1)), 1u);
+    }
+
+    std::string arguments = readFile("test_csv_import/import.args");
+    EXPECT_EQ(arguments.rfind("--nodes=Node=test_csv_import/nodes_header.csv,test_csv_import/nodes_part_0001.csv\n", 0), 0u);
+    EXPECT_NE(arguments.find("--relationships=HAS_CHILD=test_csv_import/relationships_header.csv,test_csv_import/relationships_part_0001.csv\n"), std::string::npos);
+    EXPECT_NE(arguments.find("--id-type=INTEGER\n"), std::string::npos);
+    EXPECT_NE(readFile("test_csv_import/schema.cypher").find("CREATE CONSTRAINT"), std::string::npos);
+}
+
+// Test if the rows are split into parts of the given size, and clearing removes the parts
+TEST_F(CsvImportWriterTest, SplitsPartsAndClearsThem) {
+    Tree firstTree("test_csv_1.txt", 1);
+    Tree secondTree("test_csv_2.txt", 1);
+    CsvImportWriter writer("test_csv_import", 1);
+    CountingDatabaseWrapper counter(&writer);
+    TreeComparer comparer(firstTree, secondTree, counter);
+    comparer.printDifferences();
+
+    // every row is larger than a part, so each gets a part of its own
+    ASSERT_EQ(writer.getNodeFiles().size(), counter.getNodeCount() + 1);
+    ASSERT_EQ(writer.getRelationshipFiles().size(), counter.getRelationshipCount() + 1);
+    for (size_t i = 1; i < writer.getNodeFiles().size(); ++i) {
+        EXPECT_EQ(readRows({"", writer.getNodeFiles()[i]}).size(), 1u);
+    }
+    std::string arguments = readFile("test_csv_import/import.args");
+    EXPECT_NE(arguments.find(writer.getNodeFiles().back()), std::string::npos);
+
+    std::vector<std::string> parts(writer.getNodeFiles().begin() + 1, writer.getNodeFiles().end());
+    writer.clearDatabase();
+    EXPECT_EQ(writer.getNodeFiles().size(), 1u);
+    EXPECT_EQ(writer.getRelationshipFiles().size(), 1u);
+    for (const std::string& part : parts) {
+        EXPECT_FALSE(std::filesystem::exists(part));
+    }
+    EXPECT_TRUE(std::filesystem::exists("test_csv_import/nodes_header.csv"));
+}
+
+// Test if a declaration moved out of a namespace gives unique node ids and relationships between written nodes only
+TEST_F(CsvImportWriterTest, MovedDeclarationWritesEveryNodeOnce) {
+    writeAST("test_csv_1.txt", {
+        "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+        " Declaration\tFunction\tc:@F@B\tx.cpp\t7\t1",
+        "  Statement\tCompoundStmt\tN/A\tx.cpp\t7\t5",
+        "   Statement\tIfStmt\tN/A\tx.cpp\t8\t5"
+    });
+    writeAST("test_csv_2.txt", {
+        "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+        " Declaration\tNamespace\tc:@N@old\tx.cpp\t1\t1",
+        "  Declaration\tFunction\tc:@F@B\tx.cpp\t2\t1",
+        "   Statement\tCompoundStmt\tN/A\tx.cpp\t2\t5",
+        "    Statement\tReturnStmt\tN/A\tx.cpp\t3\t5"
+    });
+    Tree firstTree("test_csv_1.txt", 1);
+    Tree secondTree("test_csv_2.txt", 1);
+    CsvImportWriter writer("test_csv_import");
+    TreeComparer comparer(firstTree, secondTree, writer);
+    comparer.printDifferences();
+
+    std::set<std::string> nodeIds;
+    for (const std::string& row : readRows(writer.getNodeFiles())) {
+        EXPECT_TRUE(nodeIds.insert(row.substr(0, row.find(','))).second) << row;
+    }
+    std::vector<std::string> relationshipRows = readRows(writer.getRelationshipFiles());
+    EXPECT_GT(relationshipRows.size(), 0u);
+    std::set<std::string> children;
+    for (const std::string& row : relationshipRows) {
+        size_t separator = row.find(',');
+        ASSERT_NE(separator, std::string::npos);
+        EXPECT_EQ(nodeIds.count(row.substr(0, separator)), 1u) << row;
+        EXPECT_EQ(nodeIds.count(row.substr(separator + 1)), 1u) << row;
+        EXPECT_TRUE(children.insert(row.substr(separator + 1)).second) << row;
+    }
+}
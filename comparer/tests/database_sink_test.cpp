@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "../include/counting_database_wrapper.h"
+#include "../include/null_database_wrapper.h"
+#include "../include/tree_comparer.h"
+#include "dump_test_fixture.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+// null sink that counts the differences it drops
+class DroppedCountingSink : public NullDatabaseWrapper {
+public:
+    uint64_t droppedNodes = 0;
+    uint64_t droppedRelationships = 0;
+
+    void addNodeToBatch(const Node& node, bool isHighLevel, const std::string& differenceType, const std::string& astOrigin) override {
+        ++droppedNodes;
+        NullDatabaseWrapper::addNodeToBatch(node, isHighLevel, differenceType, astOrigin);
+    }
+
+    void addRelationshipToBatch(const Node& parent, const Node& child) override {
+        ++droppedRelationships;
+        NullDatabaseWrapper::addRelationshipToBatch(parent, child);
+    }
+};
+
+class DatabaseSinkTest : public DumpTestFixture {
+protected:
+    void SetUp() override {
+        writeAST("test_sink_1.txt", baselineDump());
+        writeAST("test_sink_2.txt", candidateDump());
+    }
+};
+
+// Test if the count sink summarizes the differences by type and AST, followed by the totals
+TEST_F(DatabaseSinkTest, CountSink_PrintsTotalsByTypeAndAST) {
+    Tree firstTree("test_sink_1.txt", 1);
+    Tree secondTree("test_sink_2.txt", 1);
+    CountingDatabaseWrapper counter;
+    TreeComparer comparer(firstTree, secondTree, counter);
+    comparer.printDifferences();
+
+    // size_t and the expression only in the baseline, doSomethingElse and the return only in the candidate
+    EXPECT_EQ(counter.getNodeCount("ONLY_IN_FIRST_AST", "FIRST_AST"), 2u);
+    EXPECT_EQ(counter.getNodeCount("ONLY_IN_SECOND_AST", "SECOND_AST"), 2u);
+
+    std::ostringstream summary;
+    counter.printSummary(summary);
+    std::ostringstream expected;
+    for (const auto& [labels, count] : counter.getNodeCounts()) {
+        expected << labels.first << "\t" << labels.second << "\t" << count << "\n";
+    }
+    expected << "nodes\t\t" << counter.getNodeCount() << "\n" << "relationships\t\t" << counter.getRelationshipCount() << "\n";
+    EXPECT_EQ(summary.str(), expected.str());
+    EXPECT_NE(summary.str().find("ONLY_IN_SECOND_AST\tSECOND_AST\t2\n"), std::string::npos);
+}
+
+// Test if the null sink receives every difference and drops it, the trees are left unchanged, so the comparison can be
+// repeated with the count sink
+TEST_F(DatabaseSinkTest, NullSink_DropsDifferences) {
+    Tree firstTree("test_sink_1.txt", 1);
+    Tree secondTree("test_sink_2.txt", 1);
+    DroppedCountingSink sink;
+    TreeComparer nullComparer(firstTree, secondTree, sink);
+    nullComparer.printDifferences();
+
+    CountingDatabaseWrapper counter;
+    TreeComparer countingComparer(firstTree, secondTree, counter);
+    countingComparer.printDifferences();
+    EXPECT_GT(counter.getNodeCount(), 0u);
+    EXPECT_EQ(sink.droppedNodes, counter.getNodeCount());
+    EXPECT_EQ(sink.droppedRelationships, counter.getRelationshipCount());
+}
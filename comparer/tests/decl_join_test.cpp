@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "../include/decl_join.h"
+#include "../include/tree.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+class DeclJoinTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const char* fileName : {"test_join_1.txt", "test_join_2.txt"}) {
+            if (std::filesystem::exists(fileName)) {
+                std::filesystem::remove(fileName);
+            }
+        }
+    }
+
+    // writes a flat AST with a function for every index in [first, last), every third function has a duplicate
+    void writeAST(const std::string& fileName, int first, int last) {
+        std::ofstream file(fileName);
+        ASSERT_TRUE(file.is_open());
+        file << "Declaration\tTranslationUnit\tc:\tN/A\t0\t0\n";
+        for (int index = first; index < last; ++index) {
+            file << " Declaration\tFunction\tc:@F@join" << index << "\tjoin.cpp\t" << index << "\t1\n";
+            file << "  Statement\tCompoundStmt\tN/A\tjoin.cpp\t" << index << "\t2\n";
+            if (index % 3 == 0) {
+                file << " Declaration\tFunction\tc:@F@join" << index << "\tjoin.cpp\t" << index << "\t1\n";
+            }
+        }
+    }
+
+    // checks every declaration of the tree against a lookup of its key in the other tree
+    void expectMatchesLookup(const DeclJoin& join, const Tree& tree, const Tree& otherTree, ASTId ast) {
+        for (uint32_t index = 0; index < tree.getNodeCount(); ++index) {
+            const Node* node = tree.getNode(index);
+            uint32_t run = join.getRun(ast, index);
+            if (node->type != DECLARATION) {
+                EXPECT_EQ(run, DeclJoin::noRun);
+                continue;
+            }
+            ASSERT_NE(run, DeclJoin::noRun);
+
+            auto [first, last] = tree.getDeclNodeMultiMap().getRun(run);
+            EXPECT_EQ(first->first, node->enhancedKey);
+
+            uint32_t partnerRun = join.getPartnerRun(ast, run);
+            auto expected = otherTree.getDeclNodes(node->enhancedKey);
+            if (expected.first == expected.second) {
+                EXPECT_EQ(partnerRun, DeclJoin::noRun);
+            } else {
+                ASSERT_NE(partnerRun, DeclJoin::noRun);
+                auto partner = otherTree.getDeclNodeMultiMap().getRun(partnerRun);
+                EXPECT_EQ(partner.first, expected.first);
+                EXPECT_EQ(partner.second, expected.second);
+            }
+        }
+    }
+};
+
+// Test if the join pairs every declaration key with its run in the other tree, and leaves keys of a single tree unmatched
+TEST_F(DeclJoinTest, MatchesDeclarationKeysOfBothTrees) {
+    writeAST("test_join_1.txt", 0, 40);
+    writeAST("test_join_2.txt", 20, 60);
+    Tree firstTree("test_join_1.txt", 1);
+    Tree secondTree("test_join_2.txt", 1);
+
+    DeclJoin join(firstTree, secondTree);
+
+    // the translation unit and the functions 20..39
+    EXPECT_EQ(join.getMatchedKeyCount(), 21u);
+    expectMatchesLookup(join, firstTree, secondTree, FIRST_AST);
+    expectMatchesLookup(join, secondTree, firstTree, SECOND_AST);
+}
+
+// Test if a join split into many partitions and threads matches the same keys
+TEST_F(DeclJoinTest, PartitionedParallelJoinMatchesAllKeys) {
+    writeAST("test_join_1.txt", 0, 30000);
+    writeAST("test_join_2.txt", 10000, 40000);
+    Tree firstTree("test_join_1.txt", 1);
+    Tree secondTree("test_join_2.txt", 1);
+
+    DeclJoin join(firstTree, secondTree, 4);
+
+    EXPECT_EQ(join.getMatchedKeyCount(), 20001u);
+    expectMatchesLookup(join, firstTree, secondTree, FIRST_AST);
+    expectMatchesLookup(join, secondTree, firstTree, SECOND_AST);
+}
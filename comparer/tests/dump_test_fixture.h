@@ -0,0 +1,92 @@
+#ifndef _DUMP_TEST_FIXTURE_H_
+
+#define _DUMP_TEST_FIXTURE_H_
+
+#include <gtest/gtest.h>
+#include "../include/binary_dump.h"
+#include "../include/utils.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// helper function, writes the lines of a text dump into a binary dump
+inline void WriteBinaryDump(const std::string& fileName, const std::vector<std::string>& lines) {
+    std::ofstream file(fileName, std::ios::binary);
+    ASSERT_TRUE(file.is_open());
+
+    BinaryDump::Writer writer(file);
+    writer.writeHeader();
+    for (const std::string& line : lines) {
+        size_t depth = line.find_first_not_of(' ');
+        std::string_view tokens[6];
+        ASSERT_EQ(Utils::splitLine(std::string_view(line).substr(depth), tokens, 6), 6u);
+
+        uint8_t type = tokens[0] == "Declaration" ? BinaryDump::declarationType : BinaryDump::statementType;
+        writer.writeNode(static_cast<uint32_t>(depth), type, tokens[1], tokens[2], tokens[3],
+                         static_cast<uint32_t>(std::stoul(std::string(tokens[4]))), static_cast<uint32_t>(std::stoul(std::string(tokens[5]))));
+    }
+    writer.finish();
+}
+
+// Base fixture of the tests that compare small dumps written to the working directory. Every file written with writeAST or
+// writeBinaryAST, and every file or directory registered with removeAfterTest, is removed when the test ends.
+class DumpTestFixture : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const std::string& path : filesToRemove) {
+            std::filesystem::remove_all(path);
+        }
+    }
+
+    void writeAST(const std::string& fileName, const std::vector<std::string>& lines) {
+        removeAfterTest(fileName);
+        std::ofstream file(fileName);
+        ASSERT_TRUE(file.is_open());
+        for (const std::string& line : lines) {
+            file << line << "\n";
+        }
+    }
+
+    void writeBinaryAST(const std::string& fileName, const std::vector<std::string>& lines) {
+        removeAfterTest(fileName);
+        WriteBinaryDump(fileName, lines);
+    }
+
+    void removeAfterTest(const std::string& path) {
+        if (std::find(filesToRemove.begin(), filesToRemove.end(), path) == filesToRemove.end()) {
+            filesToRemove.push_back(path);
+        }
+    }
+
+    // the std namespace with the size_t typedef and doSomething, whose body holds an expression
+    static std::vector<std::string> baselineDump(const std::string& path = "C:\\include\\bits\\c++config.h") {
+        return {
+            "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+            " Declaration\tNamespace\tc:@N@std\t" + path + "\t308\t1",
+            "  Declaration\tTypedef\tc:@N@std@T@size_t\t" + path + "\t310\t3",
+            "  Declaration\tFunction\tc:@F@doSomething\t" + path + "\t350\t5",
+            "   Statement\tCompoundStmt\tN/A\t" + path + "\t351\t6",
+            "    Statement\tExprStmt\tN/A\t" + path + "\t353\t7"
+        };
+    }
+
+    // the baseline without size_t, doSomething returns instead and doSomethingElse is added
+    static std::vector<std::string> candidateDump(const std::string& path = "C:\\include\\bits\\c++config.h") {
+        return {
+            "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+            " Declaration\tNamespace\tc:@N@std\t" + path + "\t308\t1",
+            "  Declaration\tFunction\tc:@F@doSomething\t" + path + "\t350\t5",
+            "   Statement\tCompoundStmt\tN/A\t" + path + "\t351\t6",
+            "    Statement\tReturnStmt\tN/A\t" + path + "\t354\t7",
+            "  Declaration\tFunction\tc:@F@doSomethingElse\t" + path + "\t400\t5"
+        };
+    }
+
+private:
+    std::vector<std::string> filesToRemove;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "../include/flat_index.h"
+#include <utility>
+#include <vector>
+
+// Test if the values of a key form one run in insertion order, even if other keys are inserted in between
+TEST(FlatIndexTest, KeepsValuesOfKeyInInsertionOrder) {
+    std::vector<std::pair<uint32_t, int>> input = {{7, 1}, {3, 2}, {7, 3}, {0, 4}, {7, 5}, {3, 6}};
+    FlatIndex<int> index;
+    index.build(input.size(), [&input](auto&& addValue) {
+        for (const auto& [key, value] : input) {
+            addValue(key, value);
+        }
+    });
+
+    EXPECT_EQ(index.size(), 6u);
+    EXPECT_EQ(index.keyCount(), 3u);
+
+    auto range = index.equal_range(7);
+    EXPECT_EQ(std::vector<int>(range.first, range.second), (std::vector<int>{1, 3, 5}));
+    range = index.equal_range(3);
+    EXPECT_EQ(std::vector<int>(range.first, range.second), (std::vector<int>{2, 6}));
+    EXPECT_EQ(index.count(0), 1u);
+
+    std::vector<uint32_t> runKeys;
+    index.forEachRun([&runKeys](uint32_t key, auto, auto) { runKeys.push_back(key); });
+    EXPECT_EQ(runKeys, (std::vector<uint32_t>{7, 3, 0}));
+}
+
+// Test if a missing key returns an empty range, also on an index that was never built
+TEST(FlatIndexTest, MissingKeyReturnsEmptyRange) {
+    FlatIndex<int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.count(1), 0u);
+
+    FlatIndex<int> index;
+    index.build(1, [](auto&& addValue) { addValue(1, 10); });
+    auto range = index.equal_range(2);
+    EXPECT_EQ(range.first, range.second);
+    EXPECT_EQ(index.count(0xffffffffu), 0u);
+}
+
+// Test if the table grows when the value count passed to build is too small
+TEST(FlatIndexTest, GrowsBeyondValueCountHint) {
+    const uint32_t keyCount = 10000;
+    FlatIndex<uint32_t> index;
+    index.build(1, [](auto&& addValue) {
+        for (uint32_t key = 0; key < keyCount; ++key) {
+            addValue(key, key * 2);
+        }
+    });
+
+    EXPECT_EQ(index.keyCount(), keyCount);
+    for (uint32_t key = 0; key < keyCount; ++key) {
+        auto range = index.equal_range(key);
+        ASSERT_EQ(range.second - range.first, 1);
+        EXPECT_EQ(*range.first, key * 2);
+    }
+}
+
+// Test if a rebuilt index only contains the values of the last build
+TEST(FlatIndexTest, RebuildReplacesValues) {
+    FlatIndex<int> index;
+    index.build(2, [](auto&& addValue) { addValue(1, 10); addValue(2, 20); });
+    index.build(1, [](auto&& addValue) { addValue(3, 30); });
+
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_EQ(index.count(1), 0u);
+    EXPECT_EQ(index.count(3), 1u);
+}
@@ -8,12 +8,14 @@
 #include <fstream>
 #include <filesystem>
 #include <iostream>
+#include <thread>
 
 using ::testing::_;
 using ::testing::Exactly;
 using ::testing::AtLeast;
 using ::testing::Matcher;
 using ::testing::Field;
+using ::testing::InSequence;
 
 class IntegrationTest : public ::testing::Test {
 protected:
@@ -178,7 +180,7 @@ TEST_F(IntegrationTest, ProcessNodesInSingleAST_NodeOnlyInFirstASTWithStmtChildr
     ASSERT_NE(declNodeFirst.first, declNodeFirst.second);
     Node* functionNode = declNodeFirst.first->second;  // Get the declaration node (Function)
 
-    ASSERT_FALSE(functionNode->isProcessed);  // Ensure the node is not processed
+    ASSERT_FALSE(comparer.isProcessed(FIRST_AST, functionNode));  // Ensure the node is not processed
 
     // NODES
     EXPECT_CALL(dbWrapper, addNodeToBatch(Field(&Node::usr, functionNode->usr), _, "ONLY_IN_FIRST_AST", "FIRST_AST")).Times(1); // once for the function node
@@ -197,9 +199,9 @@ TEST_F(IntegrationTest, ProcessNodesInSingleAST_NodeOnlyInFirstASTWithStmtChildr
     comparer.processNodesInSingleAST(functionNode, firstAstTree, FIRST_AST, true);
 
     // Verify that nodes are marked as processed
-    ASSERT_TRUE(functionNode->isProcessed);
-    ASSERT_TRUE(firstChildNode->isProcessed);
-    ASSERT_TRUE(secondChildNode->isProcessed);
+    ASSERT_TRUE(comparer.isProcessed(FIRST_AST, functionNode));
+    ASSERT_TRUE(comparer.isProcessed(FIRST_AST, firstChildNode));
+    ASSERT_TRUE(comparer.isProcessed(FIRST_AST, secondChildNode));
 }
 
 TEST_F(IntegrationTest, ProcessNodesInSingleAST_NodeOnlyInSecondASTSingle) {
@@ -227,7 +229,7 @@ TEST_F(IntegrationTest, ProcessNodesInSingleAST_NodeOnlyInSecondASTSingle) {
 
     comparer.processNodesInSingleAST(typedefNode, secondAstTree, SECOND_AST, true);
 
-    ASSERT_TRUE(typedefNode->isProcessed);
+    ASSERT_TRUE(comparer.isProcessed(SECOND_AST, typedefNode));
 }
 
 TEST_F(IntegrationTest, ProcessNodesInSingleAST_NodeIsProcessed) {
@@ -243,10 +245,10 @@ TEST_F(IntegrationTest, ProcessNodesInSingleAST_NodeIsProcessed) {
     ASSERT_NE(declNodeFirst.first, declNodeFirst.second);
     Node* functionNode = declNodeFirst.first->second;
 
-    ASSERT_FALSE(functionNode->isProcessed);
+    ASSERT_FALSE(comparer.isProcessed(FIRST_AST, functionNode));
 
     // mark the node as processed, nothing should happen
-    functionNode->isProcessed = true;
+    comparer.markProcessed(FIRST_AST, functionNode);
 
     EXPECT_CALL(dbWrapper, addNodeToBatch(_, _, _, _)).Times(Exactly(0));
     EXPECT_CALL(dbWrapper, addRelationshipToBatch(_, _)).Times(Exactly(0));
@@ -283,7 +285,7 @@ TEST_F(IntegrationTest, ProcessNodesInSingleAST_ChildNodeIsProcessedAndExistsInO
     ASSERT_NE(secondChildNode, nullptr);
     ASSERT_NE(firstChildNodeChildNode, nullptr);
 
-    secondChildNode->isProcessed = true; // set Typedef as processed, also exists in first ast, should be skipped
+    comparer.markProcessed(SECOND_AST, secondChildNode); // set Typedef as processed, also exists in first ast, should be skipped
 
     // NODES and RELATIONSHIPS
     // EXPECT:
@@ -296,10 +298,10 @@ TEST_F(IntegrationTest, ProcessNodesInSingleAST_ChildNodeIsProcessedAndExistsInO
     comparer.processNodesInSingleAST(functionNode, secondAstTree, SECOND_AST, true);
 
     // verify that nodes are marked as processed
-    ASSERT_TRUE(functionNode->isProcessed);
-    ASSERT_TRUE(firstChildNode->isProcessed);
-    ASSERT_TRUE(secondChildNode->isProcessed);
-    ASSERT_TRUE(firstChildNodeChildNode->isProcessed);
+    ASSERT_TRUE(comparer.isProcessed(SECOND_AST, functionNode));
+    ASSERT_TRUE(comparer.isProcessed(SECOND_AST, firstChildNode));
+    ASSERT_TRUE(comparer.isProcessed(SECOND_AST, secondChildNode));
+    ASSERT_TRUE(comparer.isProcessed(SECOND_AST, firstChildNodeChildNode));
 }
 
 // **********************************************
@@ -393,6 +395,52 @@ TEST_F(IntegrationTest, CompareStmtNodes_PartiallyMatchingNodes) {
     mockComparer.compareStmtNodes(firstNode, secondNode);
 }
 
+TEST_F(IntegrationTest, CompareStmtNodes_RepeatedKeysMatchInOrder) {
+    createASTFile("test_ast_1_stmt_repeated.txt", {
+        "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+        " Declaration\tFunction\tc:@F@doSomething\tC:\\include\\bits\\c++config.h\t350\t5",
+        "  Statement\tExprStmt\tN/A\tC:\\include\\bits\\c++config.h\t351\t6",
+        "  Statement\tIfStmt\tN/A\tC:\\include\\bits\\c++config.h\t352\t6",     // Only in first AST
+        "  Statement\tExprStmt\tN/A\tC:\\include\\bits\\c++config.h\t353\t6",
+        "  Statement\tExprStmt\tN/A\tC:\\include\\bits\\c++config.h\t354\t6"     // Only in first AST
+    });
+
+    createASTFile("test_ast_2_stmt_repeated.txt", {
+        "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+        " Declaration\tFunction\tc:@F@doSomething\tC:\\include\\bits\\c++config.h\t350\t5",
+        "  Statement\tReturnStmt\tN/A\tC:\\include\\bits\\c++config.h\t360\t6",  // Only in second AST
+        "  Statement\tExprStmt\tN/A\tC:\\include\\bits\\c++config.h\t361\t6",
+        "  Statement\tExprStmt\tN/A\tC:\\include\\bits\\c++config.h\t362\t6"
+    });
+
+    Tree firstAstTree("test_ast_1_stmt_repeated.txt");
+    Tree secondAstTree("test_ast_2_stmt_repeated.txt");
+
+    PartialMockTreeComparer mockComparer(firstAstTree, secondAstTree, dbWrapper);
+
+    auto [firstNode, secondNode] = getMatchingNodes(firstAstTree, secondAstTree, "Function|c:@F@doSomething|C:\\include\\bits\\c++config.h|");
+    auto firstStmtNodes = firstAstTree.getStmtNodes(firstNode);
+    std::vector<Node*> firstStmts(firstStmtNodes.first, firstStmtNodes.second);
+    auto secondStmtNodes = secondAstTree.getStmtNodes(secondNode);
+    std::vector<Node*> secondStmts(secondStmtNodes.first, secondStmtNodes.second);
+    ASSERT_EQ(firstStmts.size(), 4u);
+    ASSERT_EQ(secondStmts.size(), 3u);
+
+    // the statements with the same key are paired in their order
+    {
+        InSequence sequence;
+        EXPECT_CALL(mockComparer, compareSourceLocations(firstStmts[0], secondStmts[1])).Times(1);
+        EXPECT_CALL(mockComparer, processNodesInSingleAST(firstStmts[1], _, FIRST_AST, false)).Times(1);
+        EXPECT_CALL(mockComparer, compareSourceLocations(firstStmts[2], secondStmts[2])).Times(1);
+        EXPECT_CALL(mockComparer, processNodesInSingleAST(firstStmts[3], _, FIRST_AST, false)).Times(1);
+        EXPECT_CALL(mockComparer, processNodesInSingleAST(secondStmts[0], _, SECOND_AST, false)).Times(1);
+    }
+    EXPECT_CALL(mockComparer, compareParents(_, _)).Times(2);
+
+    // invoke method
+    mockComparer.compareStmtNodes(firstNode, secondNode);
+}
+
 // **********************************************
 // compareSimilarDeclNodes tests
 // **********************************************
@@ -402,8 +450,8 @@ TEST_F(IntegrationTest, CompareSimilarDeclNodes_SameNodesNoDifference) {
 
     PartialMockTreeComparerForDeclNodes comparer(dummyTree1, dummyTree2, dbWrapper);
 
-    Node firstNode = createNode(DECLARATION, "FunctionDecl", "c:@N@func1", "C:\\project\\file1.cpp", 100, 10);
-    Node secondNode = createNode(DECLARATION, "FunctionDecl", "c:@N@func1", "C:\\project\\file1.cpp", 100, 10);
+    // the processed flags are indexed by the position in the tree, so the nodes are taken from the trees
+    auto [firstNode, secondNode] = getMatchingNodes(dummyTree1, dummyTree2, "Function|c:@F@doSomething|C:\\include\\bits\\c++config.h|");
 
     EXPECT_CALL(comparer, compareParents(_, _)).Times(Exactly(1));
     EXPECT_CALL(comparer, compareSourceLocations(_, _)).Times(Exactly(1));
@@ -411,10 +459,58 @@ TEST_F(IntegrationTest, CompareSimilarDeclNodes_SameNodesNoDifference) {
     EXPECT_CALL(dbWrapper, addNodeToBatch(_, _, _, _)).Times(Exactly(0));
     EXPECT_CALL(dbWrapper, addRelationshipToBatch(_, _)).Times(Exactly(0));
 
-    comparer.compareSimilarDeclNodes(&firstNode, &secondNode);
+    comparer.compareSimilarDeclNodes(firstNode, secondNode);
+
+    EXPECT_TRUE(comparer.isProcessed(FIRST_AST, firstNode));
+    EXPECT_TRUE(comparer.isProcessed(SECOND_AST, secondNode));
+}
+
+TEST_F(IntegrationTest, CompareSimilarDeclNodes_UnchangedSubtreesAreSkipped) {
+    createASTFile("test_ast_1_unchanged.txt", {
+        "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+        " Declaration\tNamespace\tc:@N@std\tC:\\include\\bits\\c++config.h\t308\t1",
+        "  Declaration\tFunction\tc:@F@doSomething\tC:\\include\\bits\\c++config.h\t350\t5",
+        "   Statement\tCompoundStmt\tN/A\tC:\\include\\bits\\c++config.h\t351\t6",
+        "    Declaration\tVar\tc:@F@doSomething@x\tC:\\include\\bits\\c++config.h\t352\t7",
+        "  Declaration\tFunction\tc:@F@doSomethingElse\tC:\\include\\bits\\c++config.h\t400\t5",
+        "   Statement\tReturnStmt\tN/A\tC:\\include\\bits\\c++config.h\t401\t6"
+    });
+
+    // same functions, the statement of the second one moved
+    createASTFile("test_ast_2_unchanged.txt", {
+        "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+        " Declaration\tNamespace\tc:@N@std\tC:\\include\\bits\\c++config.h\t308\t1",
+        "  Declaration\tFunction\tc:@F@doSomething\tC:\\include\\bits\\c++config.h\t350\t5",
+        "   Statement\tCompoundStmt\tN/A\tC:\\include\\bits\\c++config.h\t351\t6",
+        "    Declaration\tVar\tc:@F@doSomething@x\tC:\\include\\bits\\c++config.h\t352\t7",
+        "  Declaration\tFunction\tc:@F@doSomethingElse\tC:\\include\\bits\\c++config.h\t400\t5",
+        "   Statement\tReturnStmt\tN/A\tC:\\include\\bits\\c++config.h\t402\t6"
+    });
 
-    EXPECT_TRUE(firstNode.isProcessed);
-    EXPECT_TRUE(secondNode.isProcessed);
+    Tree firstAstTree("test_ast_1_unchanged.txt");
+    Tree secondAstTree("test_ast_2_unchanged.txt");
+    PartialMockTreeComparerForDeclNodes comparer(firstAstTree, secondAstTree, dbWrapper);
+
+    // unchanged function: only the parents are compared, the whole subtree is marked as processed
+    auto [firstNode, secondNode] = getMatchingNodes(firstAstTree, secondAstTree, "Function|c:@F@doSomething|C:\\include\\bits\\c++config.h|");
+    EXPECT_CALL(comparer, compareParents(firstNode, secondNode)).Times(Exactly(1));
+    EXPECT_CALL(comparer, compareSourceLocations(firstNode, secondNode)).Times(Exactly(0));
+    EXPECT_CALL(comparer, compareStmtNodes(firstNode, secondNode)).Times(Exactly(0));
+
+    comparer.compareSimilarDeclNodes(firstNode, secondNode);
+
+    firstAstTree.processSubTree(firstNode, [&comparer](Node* node, int) { EXPECT_TRUE(comparer.isProcessed(FIRST_AST, node)); });
+    secondAstTree.processSubTree(secondNode, [&comparer](Node* node, int) { EXPECT_TRUE(comparer.isProcessed(SECOND_AST, node)); });
+
+    // changed function: compared as usual
+    auto [firstChangedNode, secondChangedNode] = getMatchingNodes(firstAstTree, secondAstTree, "Function|c:@F@doSomethingElse|C:\\include\\bits\\c++config.h|");
+    EXPECT_CALL(comparer, compareParents(firstChangedNode, secondChangedNode)).Times(Exactly(1));
+    EXPECT_CALL(comparer, compareSourceLocations(firstChangedNode, secondChangedNode)).Times(Exactly(1));
+    EXPECT_CALL(comparer, compareStmtNodes(firstChangedNode, secondChangedNode)).Times(Exactly(1));
+
+    comparer.compareSimilarDeclNodes(firstChangedNode, secondChangedNode);
+
+    EXPECT_FALSE(comparer.isProcessed(FIRST_AST, firstChangedNode->children[0]));
 }
 
 // **********************************************
@@ -445,10 +541,10 @@ TEST_F(IntegrationTest, ProcessMultiDeclNodes_AllNodesAlreadyProcessed) {
     auto secondASTRange = secondAstTree.getDeclNodes(nodeKey);
 
     for (auto it = firstASTRange.first; it != firstASTRange.second; ++it) {
-        it->second->isProcessed = true;
+        mockComparer.markProcessed(FIRST_AST, it->second);
     }
     for (auto it = secondASTRange.first; it != secondASTRange.second; ++it) {
-        it->second->isProcessed = true;
+        mockComparer.markProcessed(SECOND_AST, it->second);
     }
 
     // no nodes should be added to the database
@@ -574,8 +670,8 @@ TEST_F(IntegrationTest, ProcessMultiDeclNodes_SingleNodeInFirstAST_ThreeNodesInS
     Node* varInFirst = firstFunctionNodeInFirst->children[0];
     Node* varInSecond = firstFunctionNodeInSecond->children[0];
 
-    ASSERT_FALSE(varInFirst->isProcessed);
-    ASSERT_FALSE(varInSecond->isProcessed);
+    ASSERT_FALSE(mockComparer.isProcessed(FIRST_AST, varInFirst));
+    ASSERT_FALSE(mockComparer.isProcessed(SECOND_AST, varInSecond));
 
     // invoke method call
     mockComparer.processMultiDeclNodes(firstASTRange, secondASTRange);
@@ -1067,4 +1163,241 @@ TEST_F(IntegrationTest, PrintDifferences_SharedChildrenWithDifferentStructures)
 
     TreeComparer comparer(firstAstTree, secondAstTree, dbWrapper);
     comparer.printDifferences();
-}
\ No newline at end of file
+}
+
+// **********************************************
+// out-of-core and parallel comparison tests
+// **********************************************
+// database wrapper that records the calls of the comparer in order
+class RecordingDatabaseWrapper : public IDatabaseWrapper {
+public:
+    std::vector<std::string> calls;
+
+    void addNodeToBatch(const Node& node, bool isHighestLevelNode, const std::string& differenceType, const std::string& ast) override {
+        calls.push_back("node " + node.enhancedKey.str() + " " + std::to_string(node.topologicalOrder) + " " +
+                        std::to_string(isHighestLevelNode) + " " + differenceType + " " + ast);
+    }
+    void addRelationshipToBatch(const Node& parent, const Node& child) override {
+        calls.push_back("relationship " + std::to_string(parent.topologicalOrder) + " " + std::to_string(child.topologicalOrder));
+    }
+    void createIndices() override {}
+    void finalize() override { calls.push_back("finalize"); }
+    void clearDatabase() override {}
+};
+
+TEST_F(IntegrationTest, PrintDifferences_OutOfCoreTreesMatchInMemoryTrees) {
+    // namespaces of functions, the second AST moves, drops and adds functions and statements
+    std::vector<std::string> firstLines = {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0"};
+    std::vector<std::string> secondLines = {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0"};
+    for (int n = 0; n < 40; ++n) {
+        std::string path = "C:\\project\\file" + std::to_string(n) + ".cpp";
+        std::string namespaceLine = " Declaration\tNamespace\tc:@N@ns" + std::to_string(n) + "\t" + path + "\t1\t1";
+        firstLines.push_back(namespaceLine);
+        secondLines.push_back(namespaceLine);
+
+        for (int f = 0; f < 25; ++f) {
+            std::string usr = "c:@N@ns" + std::to_string(n) + "@F@function" + std::to_string(f);
+            int line = 10 * f;
+            firstLines.push_back("  Declaration\tFunction\t" + usr + "\t" + path + "\t" + std::to_string(line) + "\t1");
+            firstLines.push_back("   Statement\tCompoundStmt\tN/A\t" + path + "\t" + std::to_string(line + 1) + "\t2");
+            firstLines.push_back("    Statement\tReturnStmt\tN/A\t" + path + "\t" + std::to_string(line + 2) + "\t3");
+
+            if ((n + f) % 7 == 0) {
+                continue; // only in the first AST
+            }
+            int secondLine = (n * f) % 5 == 0 ? line + 3 : line;
+            secondLines.push_back("  Declaration\tFunction\t" + usr + "\t" + path + "\t" + std::to_string(secondLine) + "\t1");
+            secondLines.push_back("   Statement\tCompoundStmt\tN/A\t" + path + "\t" + std::to_string(secondLine + 1) + "\t2");
+            if (f % 3 == 0) {
+                secondLines.push_back("    Statement\tExprStmt\tN/A\t" + path + "\t" + std::to_string(secondLine + 2) + "\t3");
+            } else {
+                secondLines.push_back("    Statement\tReturnStmt\tN/A\t" + path + "\t" + std::to_string(secondLine + 2) + "\t3");
+            }
+            if (f % 4 == 0) {
+                secondLines.push_back("    Declaration\tVar\t" + usr + "@x\t" + path + "\t" + std::to_string(secondLine + 3) + "\t5");
+            }
+        }
+    }
+    createASTFile("test_ast_1_out_of_core.txt", firstLines);
+    createASTFile("test_ast_2_out_of_core.txt", secondLines);
+
+    RecordingDatabaseWrapper memoryRecording;
+    {
+        Tree firstAstTree("test_ast_1_out_of_core.txt");
+        Tree secondAstTree("test_ast_2_out_of_core.txt");
+        TreeComparer comparer(firstAstTree, secondAstTree, memoryRecording);
+        comparer.printDifferences();
+    }
+
+    RecordingDatabaseWrapper outOfCoreRecording;
+    {
+        Tree firstAstTree("test_ast_1_out_of_core.txt", TreeSpill::Options{"test_spill", 16 * 1024});
+        Tree secondAstTree("test_ast_2_out_of_core.txt", TreeSpill::Options{"test_spill", 16 * 1024});
+        TreeComparer comparer(firstAstTree, secondAstTree, outOfCoreRecording);
+        comparer.printDifferences();
+    }
+
+    EXPECT_GT(memoryRecording.calls.size(), 100u);
+    EXPECT_EQ(memoryRecording.calls, outOfCoreRecording.calls);
+
+    std::filesystem::remove("test_ast_1_out_of_core.txt");
+    std::filesystem::remove("test_ast_2_out_of_core.txt");
+    std::filesystem::remove_all("test_spill");
+}
+
+TEST_F(IntegrationTest, PrintDifferences_OutOfCoreTreeIsComparedOnceAtATime) {
+    createASTFile("test_ast_1_out_of_core.txt", {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+                                                 " Declaration\tFunction\tc:@F@function\tx.cpp\t1\t1"});
+    createASTFile("test_ast_2_out_of_core.txt", {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+                                                 " Declaration\tFunction\tc:@F@function\tx.cpp\t2\t1"});
+    {
+        Tree firstAstTree("test_ast_1_out_of_core.txt", TreeSpill::Options{"test_spill", 16 * 1024});
+        Tree secondAstTree("test_ast_2_out_of_core.txt");
+        RecordingDatabaseWrapper recording;
+
+        // a comparison of the out-of-core tree is running
+        firstAstTree.beginTraversal();
+        TreeComparer comparer(firstAstTree, secondAstTree, recording);
+        EXPECT_THROW(comparer.printDifferences(), std::runtime_error);
+        firstAstTree.endTraversal();
+
+        // the in-memory tree allows traversals of any number of comparisons
+        secondAstTree.beginTraversal();
+        comparer.printDifferences();
+        secondAstTree.endTraversal();
+        EXPECT_EQ(recording.calls.back(), "finalize");
+
+        // the failed comparison ended its traversals, the tree can be compared again, but not with itself
+        recording.calls.clear();
+        comparer.printDifferences();
+        EXPECT_EQ(recording.calls.back(), "finalize");
+        TreeComparer selfComparer(firstAstTree, firstAstTree, recording);
+        EXPECT_THROW(selfComparer.printDifferences(), std::runtime_error);
+    }
+
+    std::filesystem::remove("test_ast_1_out_of_core.txt");
+    std::filesystem::remove("test_ast_2_out_of_core.txt");
+    std::filesystem::remove_all("test_spill");
+}
+
+// comparer that counts the calls of one of its overrides
+class SourceLocationCountingComparer : public TreeComparer {
+public:
+    size_t sourceLocationCalls = 0;
+
+    SourceLocationCountingComparer(Tree& firstTree, Tree& secondTree, IDatabaseWrapper& db, unsigned int threadCount)
+        : TreeComparer(firstTree, secondTree, db, threadCount) {}
+
+protected:
+    void compareSourceLocations(const Node* firstNode, const Node* secondNode) override {
+        ++sourceLocationCalls;
+        TreeComparer::compareSourceLocations(firstNode, secondNode);
+    }
+};
+
+TEST_F(IntegrationTest, PrintDifferences_ParallelComparisonMatchesSequential) {
+    // namespaces of functions, the second AST moves functions between namespaces, repeats keys, drops and adds namespaces
+    std::vector<std::string> firstLines = {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0"};
+    std::vector<std::string> secondLines = {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0"};
+    auto addFunction = [](std::vector<std::string>& lines, const std::string& usr, const std::string& path, int line, bool isChanged) {
+        lines.push_back("  Declaration\tFunction\t" + usr + "\t" + path + "\t" + std::to_string(line) + "\t1");
+        lines.push_back("   Statement\tCompoundStmt\tN/A\t" + path + "\t" + std::to_string(line + 1) + "\t2");
+        lines.push_back("    Statement\t" + std::string(isChanged ? "ExprStmt" : "ReturnStmt") + "\tN/A\t" + path + "\t" + std::to_string(line + 2) + "\t3");
+        lines.push_back("     Declaration\tVar\t" + usr + "@x\t" + path + "\t" + std::to_string(line + 3) + "\t5");
+    };
+    for (int n = 0; n < 30; ++n) {
+        std::string path = "C:\\project\\file" + std::to_string(n) + ".cpp";
+        std::string namespaceLine = " Declaration\tNamespace\tc:@N@ns" + std::to_string(n) + "\t" + path + "\t1\t1";
+        std::string typedefLine = "  Declaration\tTypedef\tc:@N@std@T@size_t\tC:\\include\\bits\\c++config.h\t310\t3";
+        if (n % 11 != 5) {
+            firstLines.push_back(namespaceLine);
+            if (n % 4 == 0) {
+                firstLines.push_back(typedefLine); // same key in many namespaces
+            }
+        }
+        if (n % 13 != 7) {
+            secondLines.push_back(namespaceLine);
+            if (n % 6 == 0) {
+                secondLines.push_back(typedefLine);
+            }
+        }
+
+        for (int f = 0; f < 12; ++f) {
+            std::string usr = "c:@N@ns" + std::to_string(n) + "@F@function" + std::to_string(f);
+            if (n % 11 != 5) {
+                addFunction(firstLines, usr, path, 10 * f, false);
+            }
+            if (n % 13 != 7 && (n + f) % 9 != 0) {
+                addFunction(secondLines, usr, path, (n * f) % 5 == 0 ? 10 * f + 1 : 10 * f, f % 4 == 0);
+            }
+        }
+
+        // function of the previous namespace moved into this one
+        if (n > 0 && n % 3 == 0 && n % 13 != 7) {
+            std::string movedUsr = "c:@N@ns" + std::to_string(n - 1) + "@F@function0";
+            addFunction(secondLines, movedUsr, "C:\\project\\file" + std::to_string(n - 1) + ".cpp", 0, false);
+        }
+    }
+    createASTFile("test_ast_1_parallel.txt", firstLines);
+    createASTFile("test_ast_2_parallel.txt", secondLines);
+
+    RecordingDatabaseWrapper sequentialRecording;
+    {
+        Tree firstAstTree("test_ast_1_parallel.txt");
+        Tree secondAstTree("test_ast_2_parallel.txt");
+        TreeComparer comparer(firstAstTree, secondAstTree, sequentialRecording);
+        comparer.printDifferences();
+    }
+    EXPECT_GT(sequentialRecording.calls.size(), 100u);
+
+    for (unsigned int threadCount : {2u, 4u, 8u}) {
+        RecordingDatabaseWrapper parallelRecording;
+        Tree firstAstTree("test_ast_1_parallel.txt");
+        Tree secondAstTree("test_ast_2_parallel.txt");
+        TreeComparer comparer(firstAstTree, secondAstTree, parallelRecording, threadCount);
+        comparer.printDifferences();
+
+        EXPECT_EQ(sequentialRecording.calls, parallelRecording.calls) << "Mismatch with " << threadCount << " threads";
+    }
+
+    // a comparison does not change the trees, the same loaded trees feed several concurrent comparisons
+    {
+        Tree firstAstTree("test_ast_1_parallel.txt");
+        Tree secondAstTree("test_ast_2_parallel.txt");
+        std::vector<RecordingDatabaseWrapper> recordings(4);
+        std::vector<std::thread> comparisons;
+        for (size_t i = 0; i < recordings.size(); ++i) {
+            comparisons.emplace_back([&firstAstTree, &secondAstTree, &recordings, i]() {
+                TreeComparer comparer(firstAstTree, secondAstTree, recordings[i], i % 2 == 0 ? 1 : 2);
+                comparer.printDifferences();
+            });
+        }
+        for (std::thread& comparison : comparisons) {
+            comparison.join();
+        }
+
+        for (size_t i = 0; i < recordings.size(); ++i) {
+            EXPECT_EQ(sequentialRecording.calls, recordings[i].calls) << "Mismatch in concurrent comparison " << i;
+        }
+    }
+
+    // a subclass asking for threads is compared sequentially, so every step goes through its overrides
+    {
+        Tree firstAstTree("test_ast_1_parallel.txt");
+        Tree secondAstTree("test_ast_2_parallel.txt");
+        RecordingDatabaseWrapper sequentialSubclassRecording;
+        SourceLocationCountingComparer sequentialComparer(firstAstTree, secondAstTree, sequentialSubclassRecording, 1);
+        sequentialComparer.printDifferences();
+
+        RecordingDatabaseWrapper threadedSubclassRecording;
+        SourceLocationCountingComparer threadedComparer(firstAstTree, secondAstTree, threadedSubclassRecording, 4);
+        threadedComparer.printDifferences();
+
+        EXPECT_GT(sequentialComparer.sourceLocationCalls, 0u);
+        EXPECT_EQ(threadedComparer.sourceLocationCalls, sequentialComparer.sourceLocationCalls);
+        EXPECT_EQ(threadedSubclassRecording.calls, sequentialRecording.calls);
+    }
+
+    std::filesystem::remove("test_ast_1_parallel.txt");
+    std::filesystem::remove("test_ast_2_parallel.txt");
+}
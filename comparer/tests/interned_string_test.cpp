@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "../include/interned_string.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Test if equal strings share the same entry of the pool
+TEST(InternedStringTest, EqualStringsShareEntry) {
+    std::string path = "C:\\include\\bits\\c++config.h";
+    InternedString first(path);
+    InternedString second(std::string_view(path.data(), path.size()));
+    InternedString other("C:\\include\\bits\\other_config.h");
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.id(), second.id());
+    EXPECT_EQ(&first.str(), &second.str());
+    EXPECT_NE(first, other);
+    EXPECT_NE(first.id(), other.id());
+}
+
+// Test the comparison of handles with plain strings
+TEST(InternedStringTest, ComparesWithPlainStrings) {
+    InternedString kind("FunctionDecl");
+
+    EXPECT_TRUE(kind == "FunctionDecl");
+    EXPECT_TRUE(kind == std::string("FunctionDecl"));
+    EXPECT_TRUE(kind != "VarDecl");
+    EXPECT_EQ(kind + "|", "FunctionDecl|");
+    EXPECT_EQ(kind.size(), 12u);
+}
+
+// Test if the default handle is the interned empty string
+TEST(InternedStringTest, DefaultIsEmptyString) {
+    InternedString defaultString;
+
+    EXPECT_TRUE(defaultString.empty());
+    EXPECT_EQ(defaultString, InternedString(""));
+    EXPECT_EQ(defaultString.id(), 0u);
+}
+
+// Test if strings interned on different threads end up in the same entries
+TEST(InternedStringTest, ConcurrentInterningReturnsSameEntries) {
+    const int threadCount = 4;
+    const int stringCount = 1000;
+    std::vector<std::vector<InternedString>> results(threadCount);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&results, t]() {
+            for (int i = 0; i < stringCount; ++i) {
+                results[t].emplace_back("c:@N@concurrent@F@function" + std::to_string(i));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 1; t < threadCount; ++t) {
+        for (int i = 0; i < stringCount; ++i) {
+            EXPECT_EQ(results[0][i], results[t][i]);
+        }
+    }
+}
+
+// Test if acquired handles share the entry of the value and the entry is freed by the last release
+TEST(InternedStringTest, AcquiredStringsAreFreedByLastRelease) {
+    InternedString first = InternedString::acquire("c:@N@acquired@F@function");
+    InternedString second = InternedString::acquire("c:@N@acquired@F@function");
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(first == "c:@N@acquired@F@function");
+
+    size_t poolSize = InternedString::poolSize();
+    InternedString::release(first);
+    EXPECT_EQ(second.str(), "c:@N@acquired@F@function"); // still referenced
+    InternedString::release(second);
+    EXPECT_EQ(InternedString::poolSize(), poolSize - 1);
+
+    // the value gets a new entry after it was freed
+    InternedString third = InternedString::acquire("c:@N@acquired@F@function");
+    EXPECT_EQ(InternedString::poolSize(), poolSize);
+    InternedString::release(third);
+}
+
+// Test if the ids of freed entries are reused, so loading and releasing trees does not use up the 32-bit ids
+TEST(InternedStringTest, IdsOfFreedEntriesAreReused) {
+    auto acquireRound = [](int round) {
+        std::vector<InternedString> strings;
+        for (int i = 0; i < 1000; ++i) {
+            strings.push_back(InternedString::acquire("c:@N@round" + std::to_string(round) + "@F@function" + std::to_string(i)));
+        }
+        uint32_t maxId = 0;
+        for (const InternedString& string : strings) {
+            maxId = std::max(maxId, string.id());
+            InternedString::release(string);
+        }
+        return maxId;
+    };
+
+    uint32_t firstMaxId = acquireRound(0);
+    uint32_t maxId = firstMaxId;
+    for (int round = 1; round < 50; ++round) {
+        maxId = std::max(maxId, acquireRound(round));
+    }
+    // without reuse the rounds would take 49000 more ids, only the shards getting more strings than before take new ones
+    EXPECT_LT(maxId, firstMaxId + 1000);
+}
+
+// Test if an acquired entry that is also interned is kept after its release
+TEST(InternedStringTest, InternedAcquiredStringIsKept) {
+    InternedString acquired = InternedString::acquire("c:@N@acquired@F@kept");
+    InternedString interned("c:@N@acquired@F@kept");
+    EXPECT_EQ(acquired, interned);
+
+    InternedString::release(acquired);
+    EXPECT_EQ(interned.str(), "c:@N@acquired@F@kept");
+    InternedString reacquired = InternedString::acquire("c:@N@acquired@F@kept");
+    EXPECT_EQ(reacquired.id(), interned.id());
+    InternedString::release(reacquired);
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include "../include/json_writer.h"
+#include <climits>
+#include <string>
+
+// Test if quotes, backslashes and control characters are escaped, and the result parses back to the original
+TEST(JsonWriterTest, AppendString_EscapesSpecialCharacters) {
+    std::string value = "C:\\include\\\"bits\"\n\t\r\b\f\x01\x1f end";
+    std::string out;
+    JsonWriter::appendString(out, value);
+
+    EXPECT_EQ(out, "\"C:\\\\include\\\\\\\"bits\\\"\\n\\t\\r\\b\\f\\u0001\\u001f end\"");
+    EXPECT_EQ(nlohmann::json::parse(out).get<std::string>(), value);
+}
+
+// Test if valid UTF-8 is kept and invalid bytes are replaced with U+FFFD
+TEST(JsonWriterTest, AppendString_ReplacesInvalidUTF8) {
+    std::string out;
+    JsonWriter::appendString(out, "c:@F@\xc3\xa9t\xe2\x82\xac\xf0\x9f\x98\x80");
+    EXPECT_EQ(nlohmann::json::parse(out).get<std::string>(), "c:@F@\xc3\xa9t\xe2\x82\xac\xf0\x9f\x98\x80");
+
+    out.clear();
+    JsonWriter::appendString(out, "a\xff" "b\xc3" "c\xe2\x82");
+    EXPECT_EQ(out, "\"a\\ufffdb\\ufffdc\\ufffd\\ufffd\"");
+    EXPECT_EQ(nlohmann::json::parse(out).get<std::string>(), "a\xef\xbf\xbd" "b\xef\xbf\xbd" "c\xef\xbf\xbd\xef\xbf\xbd");
+}
+
+// Test if overlong encodings, surrogates and code points above U+10FFFF are replaced, the boundaries of the ranges are kept
+TEST(JsonWriterTest, AppendString_ReplacesIllFormedSequences) {
+    for (const char* value : {"\xed\xa0\x80", "\xe0\x80\xaf", "\xf4\x90\x80\x80", "\xf0\x80\x80\xaf", "\xc0\xaf", "\xf5\x80\x80\x80"}) {
+        std::string out;
+        JsonWriter::appendString(out, value);
+        EXPECT_EQ(out.find_first_of("\x80\x8f\x90\xa0\xaf\xc0\xe0\xed\xf0\xf4\xf5"), std::string::npos) << out;
+        EXPECT_NO_THROW(nlohmann::json::parse(out)) << out;
+    }
+
+    // U+0800, U+D7FF, U+E000, U+10000 and U+10FFFF
+    std::string valid = "\xe0\xa0\x80\xed\x9f\xbf\xee\x80\x80\xf0\x90\x80\x80\xf4\x8f\xbf\xbf";
+    std::string out;
+    JsonWriter::appendString(out, valid);
+    EXPECT_EQ(out, "\"" + valid + "\"");
+    EXPECT_EQ(nlohmann::json::parse(out).get<std::string>(), valid);
+}
+
+// Test if numbers and booleans are appended to the existing content
+TEST(JsonWriterTest, AppendNumberAndBool_AppendValues) {
+    std::string out = "[";
+    JsonWriter::appendNumber(out, -42);
+    out += ',';
+    JsonWriter::appendNumber(out, LLONG_MAX);
+    out += ',';
+    JsonWriter::appendBool(out, true);
+    out += ',';
+    JsonWriter::appendBool(out, false);
+    out += ']';
+
+    EXPECT_EQ(out, "[-42,9223372036854775807,true,false]");
+}
@@ -13,6 +13,8 @@ public:
     using TreeComparer::processNodesInSingleAST;
     
     using TreeComparer::processDeclNodes;
+    using TreeComparer::isProcessed;
+    using TreeComparer::markProcessed;
 
     TreeComparerTestWrapper(Tree& t1, Tree& t2, IDatabaseWrapper& dbWrapper)
         : TreeComparer(t1, t2, dbWrapper) { }
@@ -26,6 +28,9 @@ public:
     MOCK_METHOD(void, compareParents, (const Node* firstNode, const Node* secondNode), (override));
     MOCK_METHOD(void, compareSourceLocations, (const Node* firstNode, const Node* secondNode), (override));
     MOCK_METHOD(void, processNodesInSingleAST, (Node* current, Tree& tree, const ASTId ast, bool isDeclaration), (override));
+
+    using TreeComparer::isProcessed;
+    using TreeComparer::markProcessed;
 };
 
 class PartialMockTreeComparer : public BaseMockTreeComparer{
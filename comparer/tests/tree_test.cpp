@@ -1,7 +1,21 @@
 #include <gtest/gtest.h>
 #include "../include/tree.h"
+#include "../include/binary_dump.h"
+#include "../include/utils.h"
+#include "dump_test_fixture.h"
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <sstream>
+#include <thread>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
 
 class TreeTest : public ::testing::Test {
 protected:
@@ -344,6 +358,25 @@ TEST_F(TreeTest, CheckStatementMultiMapSize) {
     EXPECT_EQ(stmtMultiMap.size(), 2); // only two functions have statements
 }
 
+// Test if the statement map requested by concurrent comparisons is built once and shared
+TEST_F(TreeTest, StatementMultiMapIsBuiltOnceForConcurrentRequests) {
+    Tree testTree("test_ast_2.txt");
+
+    std::vector<const std::unordered_map<std::string, std::vector<Node*>>*> maps(4, nullptr);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < maps.size(); ++i) {
+        threads.emplace_back([&testTree, &maps, i]() { maps[i] = &testTree.getStmtNodeMultiMap(); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto* map : maps) {
+        EXPECT_EQ(map, maps[0]);
+    }
+    EXPECT_EQ(maps[0]->size(), 2);
+}
+
 // helper function
 void CheckStatementsForFunction(Tree& testTree, const std::string& functionKey, 
                                 const std::vector<std::string>& expectedStmtKinds, 
@@ -388,6 +421,29 @@ TEST_F(TreeTest, CheckStatementsForFunctions) {
     CheckStatementsForFunction(testTree, funcDoSomethingElseKey, expectedStmtKindsDoSomethingElse, expectedLineColsDoSomethingElse);
 }
 
+// Test if the statements of a declaration node are found without a string key, and only for a node with the same key
+TEST_F(TreeTest, StatementsByDeclarationNode) {
+    Tree testTree("test_ast_2.txt");
+
+    auto declNodeRange = testTree.getDeclNodes("Function|c:@F@doSomethingElse|C:\\include\\bits\\c++config.h|");
+    ASSERT_NE(declNodeRange.first, declNodeRange.second);
+    const Node* declNode = declNodeRange.first->second;
+
+    auto byNode = testTree.getStmtNodes(declNode);
+    auto byKey = testTree.getStmtNodes(declNode->enhancedKey + "|" + std::to_string(declNode->topologicalOrder));
+    ASSERT_EQ(std::distance(byNode.first, byNode.second), 3);
+    EXPECT_TRUE(std::equal(byNode.first, byNode.second, byKey.first, byKey.second));
+
+    // same topological order, but a different declaration
+    Node otherNode = *declNode;
+    otherNode.enhancedKey = "Function|c:@F@doSomething|C:\\include\\bits\\c++config.h|";
+    auto otherRange = testTree.getStmtNodes(&otherNode);
+    EXPECT_EQ(otherRange.first, otherRange.second);
+
+    auto wrongKeyRange = testTree.getStmtNodes(otherNode.enhancedKey + "|" + std::to_string(declNode->topologicalOrder));
+    EXPECT_EQ(wrongKeyRange.first, wrongKeyRange.second);
+}
+
 // Test for retrieving statements for a non-existent function
 TEST_F(TreeTest, RetrieveStatementsForNonexistentFunction) {
     Tree testTree("test_ast_2.txt");
@@ -486,4 +542,563 @@ TEST_F(TreeTest, VerifyParentChildRelationships) {
     ASSERT_NE(returnStmt, nullptr);
     EXPECT_EQ(returnStmt->kind, "ReturnStmt");
     ASSERT_EQ(returnStmt->children.size(), 0);
-}
\ No newline at end of file
+}
+// **********************************************
+// Parallel construction tests
+// **********************************************
+// helper function to compare two subtrees node by node
+void ExpectSameSubtree(const Node* expected, const Node* actual) {
+    ASSERT_NE(expected, nullptr);
+    ASSERT_NE(actual, nullptr);
+    EXPECT_EQ(expected->kind, actual->kind);
+    EXPECT_EQ(expected->usr, actual->usr);
+    EXPECT_EQ(expected->enhancedKey, actual->enhancedKey);
+    EXPECT_EQ(expected->topologicalOrder, actual->topologicalOrder);
+    EXPECT_EQ(expected->lineNumber, actual->lineNumber);
+    EXPECT_EQ(expected->columnNumber, actual->columnNumber);
+
+    ASSERT_EQ(expected->children.size(), actual->children.size());
+    for (size_t i = 0; i < expected->children.size(); ++i) {
+        EXPECT_EQ(actual->children[i]->parent, actual);
+        ExpectSameSubtree(expected->children[i], actual->children[i]);
+    }
+}
+
+// Test if the parallel construction builds the same tree and maps as the sequential one
+TEST_F(TreeTest, ParallelConstructionMatchesSequential) {
+    for (const char* fileName : {"test_ast_2.txt", "test_ast_nested.txt"}) {
+        Tree sequentialTree(fileName, 1);
+        Tree parallelTree(fileName, 4);
+
+        ExpectSameSubtree(sequentialTree.getRoot(), parallelTree.getRoot());
+        EXPECT_EQ(sequentialTree.getDeclNodeMultiMap().size(), parallelTree.getDeclNodeMultiMap().size());
+        ASSERT_EQ(sequentialTree.getStmtNodeMultiMap().size(), parallelTree.getStmtNodeMultiMap().size());
+
+        for (const auto& [key, stmtNodes] : sequentialTree.getStmtNodeMultiMap()) {
+            auto parallelRange = parallelTree.getStmtNodes(key);
+            ASSERT_EQ(static_cast<size_t>(std::distance(parallelRange.first, parallelRange.second)), stmtNodes.size()) << "Statement group mismatch for key " << key;
+
+            auto parallelIt = parallelRange.first;
+            for (const Node* stmtNode : stmtNodes) {
+                EXPECT_EQ(stmtNode->topologicalOrder, (*parallelIt++)->topologicalOrder);
+            }
+        }
+    }
+}
+
+// Test if the parallel construction falls back to the sequential behaviour when the file has multiple depth 0 lines
+TEST_F(TreeTest, ParallelConstructionWithMultipleRootLevelNodes) {
+    std::ofstream file("multiple_roots.txt");
+    ASSERT_TRUE(file.is_open());
+    file << "Declaration\tTranslationUnit\tc:\tN/A\t0\t0\n";
+    file << " Declaration\tNamespace\tc:@N@std\tC:\\include\\bits\\c++config.h\t308\t1\n";
+    file << "Declaration\tTranslationUnit\tc:\tN/A\t1\t0\n";
+    file << " Declaration\tNamespace\tc:@N@other\tC:\\include\\bits\\c++config.h\t309\t1\n";
+    file.close();
+
+    {
+        Tree sequentialTree("multiple_roots.txt", 1);
+        Tree parallelTree("multiple_roots.txt", 4);
+
+        ExpectSameSubtree(sequentialTree.getRoot(), parallelTree.getRoot());
+        EXPECT_EQ(parallelTree.getRoot()->lineNumber, 1);
+    }
+
+    std::filesystem::remove("multiple_roots.txt");
+}
+
+// Test if errors raised on worker threads are propagated by the parallel construction
+TEST_F(TreeTest, ParallelConstructionThrowsOnInvalidLineOrColumn) {
+    std::ofstream file("invalid_parallel.txt");
+    ASSERT_TRUE(file.is_open());
+    file << "Declaration\tTranslationUnit\tc:\tN/A\t0\t0\n";
+    file << " Declaration\tNamespace\tc:@N@std\tC:\\include\\bits\\c++config.h\t308\t1\n";
+    file << " Declaration\tNamespace\tc:@N@other\tC:\\include\\bits\\c++config.h\tABC\t1\n";
+    file.close();
+
+    std::stringstream buffer;
+    std::streambuf* oldCerrBuffer = std::cerr.rdbuf(buffer.rdbuf());
+
+    EXPECT_THROW({
+        Tree testTree("invalid_parallel.txt", 4);
+    }, std::runtime_error);
+
+    std::cerr.rdbuf(oldCerrBuffer);
+    std::filesystem::remove("invalid_parallel.txt");
+}
+
+// Test if the preorder layout matches the linked nodes
+TEST_F(TreeTest, LayoutMatchesNodeStructure) {
+    Tree testTree("test_ast_nested.txt");
+    const TreeLayout& layout = testTree.getLayout();
+
+    ASSERT_EQ(layout.size(), 14u);
+    EXPECT_EQ(layout.getNode(0), testTree.getRoot());
+    EXPECT_EQ(layout.getParent(0), TreeLayout::noIndex);
+    EXPECT_EQ(layout.getSubtreeEnd(0), 14u);
+
+    for (uint32_t index = 0; index < layout.size(); ++index) {
+        Node* node = layout.getNode(index);
+        EXPECT_EQ(node->topologicalOrder, static_cast<int>(index));
+        EXPECT_EQ(layout.indexOf(node), index);
+        EXPECT_EQ(layout.getType(index), node->type);
+
+        ASSERT_EQ(static_cast<size_t>(layout.childrenEnd(index) - layout.childrenBegin(index)), node->children.size());
+        for (Node* child : node->children) {
+            uint32_t childIndex = layout.indexOf(child);
+            EXPECT_EQ(layout.getParent(childIndex), index);
+            EXPECT_EQ(layout.getDepth(childIndex), layout.getDepth(index) + 1);
+            EXPECT_GT(childIndex, index);
+            EXPECT_LE(layout.getSubtreeEnd(childIndex), layout.getSubtreeEnd(index));
+        }
+    }
+
+    Node standaloneNode;
+    EXPECT_EQ(layout.indexOf(&standaloneNode), TreeLayout::noIndex);
+}
+
+// Test if processSubTree visits exactly the subtree in preorder with relative depths
+TEST_F(TreeTest, ProcessSubTreeVisitsSubtreeInPreorder) {
+    Tree testTree("test_ast_nested.txt");
+    Node* classVector = testTree.getRoot()->children[0]->children[2];
+    ASSERT_EQ(classVector->kind, "Class");
+
+    std::vector<std::pair<std::string, int>> visited;
+    testTree.processSubTree(classVector, [&visited](Node* node, int depth) { visited.emplace_back(node->kind.str(), depth); });
+
+    std::vector<std::pair<std::string, int>> expected = {
+        {"Class", 0}, {"Function", 1}, {"CompoundStmt", 2}, {"ExprStmt", 3}, {"Var", 4}
+    };
+    EXPECT_EQ(visited, expected);
+}
+
+// Test if the fingerprints cover the subtrees: equal subtrees at different positions match, changes reach every ancestor
+TEST_F(TreeTest, FingerprintsCoverSubtrees) {
+    std::ofstream changedFile("test_ast_nested_changed.txt");
+    ASSERT_TRUE(changedFile.is_open());
+    changedFile << "Declaration\tTranslationUnit\tc:\tN/A\t0\t0\n";
+    changedFile << " Declaration\tNamespace\tc:@N@added\tC:\\include\\bits\\c++config.h\t5\t1\n";
+    changedFile << " Declaration\tNamespace\tc:@N@std\tC:\\include\\bits\\c++config.h\t10\t1\n";
+    changedFile << "  Declaration\tTypedef\tc:@N@std@T@size_t\tC:\\include\\bits\\c++config.h\t310\t3\n";
+    changedFile << "  Declaration\tTypedef\tc:@N@std@T@size_t\tC:\\include\\bits\\c++config.h\t310\t3\n";
+    changedFile << "  Declaration\tClass\tc:@N@std@C@Vector\tC:\\include\\bits\\c++config.h\t15\t3\n";
+    changedFile << "   Declaration\tFunction\tc:@N@std@C@Vector@F@push_back\tC:\\include\\bits\\c++config.h\t20\t5\n";
+    changedFile << "    Statement\tCompoundStmt\tN/A\tC:\\include\\bits\\c++config.h\t21\t6\n";
+    changedFile << "     Statement\tExprStmt\tN/A\tC:\\include\\bits\\c++config.h\t22\t8\n";
+    changedFile << "      Declaration\tVar\tc:@N@std@C@Vector@F@push_back@x\tC:\\include\\bits\\c++config.h\t23\t8\n";
+    changedFile << " Declaration\tNamespace\tc:@N@other\tC:\\include\\bits\\c++config_other.h\t30\t1\n";
+    changedFile << "  Declaration\tClass\tc:@N@other@C@List\tC:\\include\\bits\\c++config_other.h\t35\t3\n";
+    changedFile << "   Declaration\tFunction\tc:@N@other@C@List@F@add\tC:\\include\\bits\\c++config_other.h\t40\t5\n";
+    changedFile << "    Statement\tCompoundStmt\tN/A\tC:\\include\\bits\\c++config_other.h\t41\t6\n";
+    changedFile << "     Statement\tReturnStmt\tN/A\tC:\\include\\bits\\c++config_other.h\t42\t7\n";
+    changedFile.close();
+
+    Tree originalTree("test_ast_nested.txt");
+    Tree changedTree("test_ast_nested_changed.txt");
+    auto getNode = [](const Tree& tree, const std::string& key) { return tree.getDeclNodes(InternedString(key)).first->second; };
+
+    // the subtree of the other namespace is unchanged, but every node is shifted by the added namespace
+    const std::string listKey = "Class|c:@N@other@C@List|C:\\include\\bits\\c++config_other.h|";
+    EXPECT_EQ(getNode(originalTree, listKey)->fingerprint, getNode(changedTree, listKey)->fingerprint);
+    EXPECT_NE(getNode(originalTree, listKey)->topologicalOrder, getNode(changedTree, listKey)->topologicalOrder);
+
+    // the changed statement reaches every ancestor, but not the unchanged descendants
+    const std::string pushBackKey = "Function|c:@N@std@C@Vector@F@push_back|C:\\include\\bits\\c++config.h|";
+    const std::string vectorKey = "Class|c:@N@std@C@Vector|C:\\include\\bits\\c++config.h|";
+    const std::string varKey = "Var|c:@N@std@C@Vector@F@push_back@x|C:\\include\\bits\\c++config.h|";
+    EXPECT_NE(getNode(originalTree, pushBackKey)->fingerprint, getNode(changedTree, pushBackKey)->fingerprint);
+    EXPECT_NE(getNode(originalTree, vectorKey)->fingerprint, getNode(changedTree, vectorKey)->fingerprint);
+    EXPECT_NE(originalTree.getRoot()->fingerprint, changedTree.getRoot()->fingerprint);
+    EXPECT_EQ(getNode(originalTree, varKey)->fingerprint, getNode(changedTree, varKey)->fingerprint);
+
+    std::filesystem::remove("test_ast_nested_changed.txt");
+}
+
+// Test if subtrees are only marked as having unique keys when none of their declaration keys is repeated
+TEST_F(TreeTest, UniqueDeclKeysOfSubtrees) {
+    Tree testTree("test_ast_nested.txt");
+    Node* stdNamespace = testTree.getRoot()->children[0];
+    Node* otherNamespace = testTree.getRoot()->children[1];
+
+    EXPECT_FALSE(testTree.getRoot()->hasUniqueDeclKeys);
+    EXPECT_FALSE(stdNamespace->hasUniqueDeclKeys);       // repeated typedef
+    EXPECT_FALSE(stdNamespace->children[0]->hasUniqueDeclKeys);
+    EXPECT_TRUE(stdNamespace->children[2]->hasUniqueDeclKeys);
+    EXPECT_TRUE(otherNamespace->hasUniqueDeclKeys);
+}
+
+// Test if a binary dump builds the same tree as the text dump with the same content
+TEST_F(TreeTest, BinaryDumpMatchesTextDump) {
+    std::vector<std::string> lines;
+    std::ifstream textFile("test_ast_nested.txt");
+    for (std::string line; std::getline(textFile, line);) {
+        lines.push_back(line);
+    }
+    WriteBinaryDump("test_ast_nested.bin", lines);
+
+    {
+        Tree textTree("test_ast_nested.txt");
+        Tree binaryTree("test_ast_nested.bin");
+
+        ExpectSameSubtree(textTree.getRoot(), binaryTree.getRoot());
+        EXPECT_EQ(textTree.getDeclNodeMultiMap().size(), binaryTree.getDeclNodeMultiMap().size());
+        EXPECT_EQ(textTree.getStmtNodeMultiMap().size(), binaryTree.getStmtNodeMultiMap().size());
+        EXPECT_EQ(binaryTree.getLayout().size(), lines.size());
+
+        std::string typedefKey = "Typedef|c:@N@std@T@size_t|C:\\include\\bits\\c++config.h|";
+        auto typedefRange = binaryTree.getDeclNodes(typedefKey);
+        EXPECT_EQ(std::distance(typedefRange.first, typedefRange.second), 2);
+    }
+
+    std::filesystem::remove("test_ast_nested.bin");
+}
+
+// Test if a truncated binary dump is rejected
+TEST_F(TreeTest, TruncatedBinaryDumpThrows) {
+    WriteBinaryDump("truncated.bin", {
+        "Declaration\tTranslationUnit\tc:\tN/A\t0\t0",
+        " Declaration\tNamespace\tc:@N@std\tC:\\include\\bits\\c++config.h\t308\t1"
+    });
+    std::filesystem::resize_file("truncated.bin", std::filesystem::file_size("truncated.bin") - 3);
+
+    EXPECT_THROW({
+        Tree testTree("truncated.bin");
+    }, std::runtime_error);
+
+    std::filesystem::remove("truncated.bin");
+}
+
+// helper function, creates a dump that is larger than a decompressed block
+std::vector<std::string> CreateLargeDumpLines() {
+    std::vector<std::string> lines = {"Declaration\tTranslationUnit\tc:\tN/A\t0\t0"};
+    for (int i = 0; i < 8000; ++i) {
+        std::string path = "C:\\src\\file" + std::to_string(i % 50) + ".cpp";
+        lines.push_back(" Declaration\tFunction\tc:@F@function" + std::to_string(i) + "\t" + path + "\t" + std::to_string(i) + "\t1");
+        lines.push_back("  Statement\tCompoundStmt\tN/A\t" + path + "\t" + std::to_string(i) + "\t2");
+        lines.push_back("   Statement\tReturnStmt\tN/A\t" + path + "\t" + std::to_string(i + 1) + "\t3");
+    }
+    return lines;
+}
+
+// helper function, compresses a file with the given codec, returns false if the codec is not available for the tests
+bool CompressFile(const std::string& source, const std::string& destination, DecompressingStream::Codec codec) {
+    if (!DecompressingStream::isCodecAvailable(codec)) {
+        return false;
+    }
+
+    std::ifstream input(source, std::ios::binary);
+    std::stringstream contents;
+    contents << input.rdbuf();
+    std::string data = contents.str();
+
+    if (codec == DecompressingStream::GZIP) {
+#ifdef WITH_ZLIB
+        gzFile output = gzopen(destination.c_str(), "wb");
+        gzwrite(output, data.data(), static_cast<unsigned int>(data.size()));
+        gzclose(output);
+        return true;
+#endif
+    } else if (codec == DecompressingStream::ZSTD) {
+#ifdef WITH_ZSTD
+        std::string compressed(ZSTD_compressBound(data.size()), '\0');
+        compressed.resize(ZSTD_compress(&compressed[0], compressed.size(), data.data(), data.size(), 3));
+        std::ofstream output(destination, std::ios::binary);
+        output.write(compressed.data(), compressed.size());
+        return true;
+#endif
+    }
+    return false;
+}
+
+// Test if compressed text and binary dumps build the same tree as the uncompressed text dump
+TEST_F(TreeTest, CompressedDumpsMatchUncompressedDump) {
+    std::vector<std::string> lines = CreateLargeDumpLines();
+    {
+        std::ofstream textFile("large_dump.txt");
+        for (const std::string& line : lines) {
+            textFile << line << "\n";
+        }
+    }
+    WriteBinaryDump("large_dump.bin", lines);
+
+    Tree textTree("large_dump.txt", 1);
+    int testedFiles = 0;
+    for (DecompressingStream::Codec codec : {DecompressingStream::GZIP, DecompressingStream::ZSTD}) {
+        for (const std::string source : {"large_dump.txt", "large_dump.bin"}) {
+            if (!CompressFile(source, "large_dump.compressed", codec)) {
+                continue;
+            }
+
+            Tree compressedTree("large_dump.compressed");
+            ExpectSameSubtree(textTree.getRoot(), compressedTree.getRoot());
+            EXPECT_EQ(textTree.getDeclNodeMultiMap().size(), compressedTree.getDeclNodeMultiMap().size());
+            EXPECT_EQ(textTree.getStmtNodeMultiMap().size(), compressedTree.getStmtNodeMultiMap().size());
+            ++testedFiles;
+        }
+    }
+
+    std::filesystem::remove("large_dump.txt");
+    std::filesystem::remove("large_dump.bin");
+    std::filesystem::remove("large_dump.compressed");
+
+    if (testedFiles == 0) {
+        GTEST_SKIP() << "No compression library available";
+    }
+}
+
+// Test if a truncated compressed dump is rejected
+TEST_F(TreeTest, TruncatedCompressedDumpThrows) {
+    if (!CompressFile("test_ast_2.txt", "truncated.gz", DecompressingStream::GZIP)) {
+        GTEST_SKIP() << "gzip support is not available";
+    }
+    std::filesystem::resize_file("truncated.gz", std::filesystem::file_size("truncated.gz") / 2);
+
+    EXPECT_THROW({
+        Tree testTree("truncated.gz");
+    }, std::runtime_error);
+
+    std::filesystem::remove("truncated.gz");
+}
+
+// Test if the binary reader resumes records that are cut off at the end of a part
+TEST_F(TreeTest, BinaryReaderResumesRecordsAcrossParts) {
+    WriteBinaryDump("parts.bin", CreateLargeDumpLines());
+    std::ifstream file("parts.bin", std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string data = contents.str();
+    std::filesystem::remove("parts.bin");
+
+    BinaryDump::Reader wholeReader(data);
+    std::vector<std::string> expected;
+    BinaryDump::Record record;
+    while (wholeReader.readNode(record)) {
+        expected.push_back(std::to_string(record.depth) + std::string(wholeReader.getString(record.kind)) +
+                           std::string(wholeReader.getString(record.usr)) + std::to_string(record.lineNumber));
+    }
+
+    // strings have to be copied while their part is alive, like the tree interns them
+    BinaryDump::Reader partReader;
+    std::vector<std::string> strings;
+    std::vector<std::string> actual;
+    std::string buffer;
+    for (size_t offset = 0; offset < data.size(); offset += 7) {
+        buffer += data.substr(offset, 7);
+        partReader.setContents(buffer, offset + 7 >= data.size());
+        while (partReader.readNode(record)) {
+            while (strings.size() < partReader.getStringCount()) {
+                strings.emplace_back(partReader.getString(static_cast<uint32_t>(strings.size())));
+            }
+            actual.push_back(std::to_string(record.depth) + strings[record.kind] + strings[record.usr] + std::to_string(record.lineNumber));
+        }
+        buffer.erase(0, partReader.getPosition());
+    }
+
+    EXPECT_EQ(actual, expected);
+}
+
+// **********************************************
+// Snapshot cache tests
+// **********************************************
+// helper function, expects that the trees have the same nodes and maps
+void ExpectSameTree(const Tree& expected, const Tree& actual) {
+    ExpectSameSubtree(expected.getRoot(), actual.getRoot());
+    EXPECT_EQ(expected.getDeclNodeMultiMap().size(), actual.getDeclNodeMultiMap().size());
+    ASSERT_EQ(expected.getStmtNodeMultiMap().size(), actual.getStmtNodeMultiMap().size());
+
+    for (const auto& [key, stmtNodes] : expected.getStmtNodeMultiMap()) {
+        auto actualRange = actual.getStmtNodes(key);
+        ASSERT_EQ(static_cast<size_t>(std::distance(actualRange.first, actualRange.second)), stmtNodes.size()) << "Statement group mismatch for key " << key;
+
+        auto actualIt = actualRange.first;
+        for (const Node* stmtNode : stmtNodes) {
+            EXPECT_EQ(stmtNode->topologicalOrder, (*actualIt)->topologicalOrder);
+            EXPECT_EQ(stmtNode->fingerprint, (*actualIt++)->fingerprint);
+        }
+    }
+}
+
+// Test if a tree loaded from its snapshot matches the tree parsed from the dump
+TEST_F(TreeTest, SnapshotMatchesParsedTree) {
+    const std::string snapshotDirectory = "test_snapshots";
+    std::filesystem::remove_all(snapshotDirectory);
+
+    Tree parsedTree("test_ast_nested.txt");
+    Tree firstRunTree("test_ast_nested.txt", 0, snapshotDirectory);
+    ASSERT_EQ(std::distance(std::filesystem::directory_iterator(snapshotDirectory), std::filesystem::directory_iterator()), 1);
+
+    Tree loadedTree("test_ast_nested.txt", 0, snapshotDirectory);
+    ExpectSameTree(parsedTree, loadedTree);
+    ExpectSameTree(firstRunTree, loadedTree);
+
+    auto declRange = loadedTree.getDeclNodes("Function|c:@N@std@C@Vector@F@push_back|C:\\include\\bits\\c++config.h|");
+    ASSERT_NE(declRange.first, declRange.second);
+    EXPECT_EQ(declRange.first->second->lineNumber, 20);
+
+    std::filesystem::remove_all(snapshotDirectory);
+}
+
+// Test if a changed dump gets a new snapshot instead of the one of its previous contents
+TEST_F(TreeTest, SnapshotIsInvalidatedByChangedDump) {
+    const std::string snapshotDirectory = "test_snapshots";
+    std::filesystem::remove_all(snapshotDirectory);
+
+    std::filesystem::copy_file("test_ast_1.txt", "test_ast_snapshot.txt", std::filesystem::copy_options::overwrite_existing);
+    Tree firstTree("test_ast_snapshot.txt", 0, snapshotDirectory);
+    EXPECT_EQ(firstTree.getLayout().size(), 3u);
+
+    std::filesystem::copy_file("test_ast_2.txt", "test_ast_snapshot.txt", std::filesystem::copy_options::overwrite_existing);
+    Tree changedTree("test_ast_snapshot.txt", 0, snapshotDirectory);
+    Tree parsedTree("test_ast_2.txt");
+    ExpectSameTree(parsedTree, changedTree);
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(snapshotDirectory), std::filesystem::directory_iterator()), 2);
+
+    std::filesystem::remove("test_ast_snapshot.txt");
+    std::filesystem::remove_all(snapshotDirectory);
+}
+
+// Test if a damaged snapshot is ignored and the tree is built from the dump
+TEST_F(TreeTest, DamagedSnapshotFallsBackToDump) {
+    const std::string snapshotDirectory = "test_snapshots";
+    std::filesystem::remove_all(snapshotDirectory);
+
+    { Tree firstTree("test_ast_2.txt", 0, snapshotDirectory); }
+    std::filesystem::path snapshotPath = std::filesystem::directory_iterator(snapshotDirectory)->path();
+    std::filesystem::resize_file(snapshotPath, std::filesystem::file_size(snapshotPath) - 4);
+
+    testing::internal::CaptureStderr();
+    Tree rebuiltTree("test_ast_2.txt", 0, snapshotDirectory);
+    std::string output = testing::internal::GetCapturedStderr();
+    EXPECT_NE(output.find("Could not load the snapshot"), std::string::npos);
+
+    Tree parsedTree("test_ast_2.txt");
+    ExpectSameTree(parsedTree, rebuiltTree);
+
+    // the damaged snapshot was replaced
+    Tree loadedTree("test_ast_2.txt", 0, snapshotDirectory);
+    ExpectSameTree(parsedTree, loadedTree);
+
+    std::filesystem::remove_all(snapshotDirectory);
+}
+
+// **********************************************
+// Out-of-core tree tests
+// **********************************************
+// helper function, expects that the out-of-core tree has the same nodes and lookups as the in-memory tree
+void ExpectSameOutOfCoreTree(Tree& expected, Tree& actual) {
+    ASSERT_TRUE(actual.isOutOfCore());
+    ASSERT_EQ(expected.getNodeCount(), actual.getNodeCount());
+
+    for (uint32_t index = 0; index < expected.getNodeCount(); ++index) {
+        const Node* expectedNode = expected.getNode(index);
+        const Node* actualNode = actual.getNode(index);
+        ASSERT_NE(actualNode, nullptr);
+        EXPECT_EQ(expectedNode->kind, actualNode->kind);
+        EXPECT_EQ(expectedNode->path, actualNode->path);
+        EXPECT_EQ(expectedNode->enhancedKey, actualNode->enhancedKey);
+        EXPECT_EQ(expectedNode->topologicalOrder, actualNode->topologicalOrder);
+        EXPECT_EQ(expectedNode->lineNumber, actualNode->lineNumber);
+        EXPECT_EQ(expectedNode->fingerprint, actualNode->fingerprint);
+        EXPECT_EQ(expectedNode->type, actual.getNodeType(index));
+        EXPECT_EQ(expectedNode->parent ? expectedNode->parent->topologicalOrder : -1, actualNode->parent ? actualNode->parent->topologicalOrder : -1);
+
+        auto [expectedBegin, expectedEnd] = expected.getChildIndices(index);
+        auto [actualBegin, actualEnd] = actual.getChildIndices(index);
+        EXPECT_TRUE(std::equal(expectedBegin, expectedEnd, actualBegin, actualEnd)) << "Children mismatch at index " << index;
+        actual.releaseNodes();
+    }
+
+    for (const auto& [key, node] : expected.getDeclNodeMultiMap()) {
+        EXPECT_TRUE(actual.isDeclNodeInAST(key));
+        auto expectedRange = expected.getDeclNodes(key);
+        auto actualRange = actual.getDeclNodes(key);
+        EXPECT_EQ(std::distance(expectedRange.first, expectedRange.second), std::distance(actualRange.first, actualRange.second));
+    }
+    EXPECT_FALSE(actual.isDeclNodeInAST("Function|c:@F@missing|C:\\src\\missing.cpp|"));
+
+    for (const auto& [key, stmtNodes] : expected.getStmtNodeMultiMap()) {
+        auto actualRange = actual.getStmtNodes(key);
+        ASSERT_EQ(static_cast<size_t>(std::distance(actualRange.first, actualRange.second)), stmtNodes.size()) << "Statement group mismatch for key " << key;
+
+        auto actualIt = actualRange.first;
+        for (const Node* stmtNode : stmtNodes) {
+            EXPECT_EQ(stmtNode->topologicalOrder, (*actualIt++)->topologicalOrder);
+        }
+    }
+}
+
+// Test if an out-of-core tree with a small memory limit has the same nodes and lookups as the in-memory tree
+TEST_F(TreeTest, OutOfCoreTreeMatchesInMemoryTree) {
+    const std::string spillDirectory = "test_spill";
+    std::vector<std::string> lines = CreateLargeDumpLines();
+    {
+        std::ofstream file("large_dump.txt");
+        for (const std::string& line : lines) {
+            file << line << "\n";
+        }
+    }
+
+    for (const char* fileName : {"large_dump.txt", "test_ast_2.txt", "test_ast_nested.txt"}) {
+        Tree memoryTree(fileName);
+        Tree spilledTree(fileName, TreeSpill::Options{spillDirectory, 64 * 1024});
+        ExpectSameOutOfCoreTree(memoryTree, spilledTree);
+
+        // a walk over the whole tree visits the nodes in preorder
+        std::vector<std::pair<int, int>> expectedVisits;
+        std::vector<std::pair<int, int>> actualVisits;
+        memoryTree.processSubTree(memoryTree.getRoot(), [&expectedVisits](Node* node, int depth) { expectedVisits.emplace_back(node->topologicalOrder, depth); });
+        spilledTree.processSubTree(spilledTree.getRoot(), [&actualVisits](Node* node, int depth) { actualVisits.emplace_back(node->topologicalOrder, depth); });
+        EXPECT_EQ(expectedVisits, actualVisits);
+    }
+
+    // the spill files are removed with the tree
+    EXPECT_TRUE(std::filesystem::is_empty(spillDirectory));
+
+    std::filesystem::remove("large_dump.txt");
+    std::filesystem::remove_all(spillDirectory);
+}
+
+// Test if out-of-core trees are built from binary and compressed dumps
+TEST_F(TreeTest, OutOfCoreTreeFromBinaryAndCompressedDumps) {
+    const std::string spillDirectory = "test_spill";
+    std::vector<std::string> lines = CreateLargeDumpLines();
+    {
+        std::ofstream file("large_dump.txt");
+        for (const std::string& line : lines) {
+            file << line << "\n";
+        }
+    }
+    WriteBinaryDump("large_dump.bin", lines);
+
+    Tree memoryTree("large_dump.txt");
+    {
+        Tree binaryTree("large_dump.bin", TreeSpill::Options{spillDirectory, 64 * 1024});
+        ExpectSameOutOfCoreTree(memoryTree, binaryTree);
+    }
+    if (CompressFile("large_dump.bin", "large_dump.bin.zst", DecompressingStream::ZSTD)) {
+        Tree compressedTree("large_dump.bin.zst", TreeSpill::Options{spillDirectory, 64 * 1024});
+        ExpectSameOutOfCoreTree(memoryTree, compressedTree);
+    }
+
+    std::filesystem::remove("large_dump.txt");
+    std::filesystem::remove("large_dump.bin");
+    std::filesystem::remove("large_dump.bin.zst");
+    std::filesystem::remove_all(spillDirectory);
+}
+
+// Test if a dump with multiple depth 0 lines is rejected by the out-of-core construction
+TEST_F(TreeTest, OutOfCoreTreeRejectsMultipleRoots) {
+    std::ofstream file("multiple_roots.txt");
+    ASSERT_TRUE(file.is_open());
+    file << "Declaration\tTranslationUnit\tc:\tN/A\t0\t0\n";
+    file << " Declaration\tNamespace\tc:@N@std\tC:\\include\\bits\\c++config.h\t308\t1\n";
+    file << "Declaration\tTranslationUnit\tc:\tN/A\t1\t0\n";
+    file.close();
+
+    EXPECT_THROW({
+        Tree testTree("multiple_roots.txt", TreeSpill::Options{"test_spill", 64 * 1024});
+    }, std::runtime_error);
+
+    std::filesystem::remove("multiple_roots.txt");
+    std::filesystem::remove_all("test_spill");
+}
@@ -0,0 +1,158 @@
+#ifndef _COMPRESSING_STREAM_BUF_H_
+
+#define _COMPRESSING_STREAM_BUF_H_
+
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+
+// Stream buffer compressing everything written to it into the underlying stream, as a gzip member or a zstd frame.
+// The dump is compressed while it is written, there is no uncompressed temporary file.
+class CompressingStreamBuf : public std::streambuf {
+public:
+  enum class Codec { Gzip, Zstd };
+
+  CompressingStreamBuf(std::ostream& output, Codec codec)
+    : output(output), codec(codec), inputBuffer(bufferSize), outputBuffer(bufferSize) {
+    if (codec == Codec::Gzip) {
+#ifdef WITH_ZLIB
+      if (deflateInit2(&gzipStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("Could not initialize the gzip compression.");
+      }
+#else
+      throw std::runtime_error("The tool was built without gzip support.");
+#endif
+    } else {
+#ifdef WITH_ZSTD
+      zstdContext = ZSTD_createCCtx();
+      if (!zstdContext) {
+        throw std::runtime_error("Could not initialize the zstd compression.");
+      }
+      ZSTD_CCtx_setParameter(zstdContext, ZSTD_c_compressionLevel, 3);
+#else
+      throw std::runtime_error("The tool was built without zstd support.");
+#endif
+    }
+
+    setp(inputBuffer.data(), inputBuffer.data() + inputBuffer.size());
+  }
+
+  ~CompressingStreamBuf() override {
+    close();
+#ifdef WITH_ZLIB
+    if (codec == Codec::Gzip) {
+      deflateEnd(&gzipStream);
+    }
+#endif
+#ifdef WITH_ZSTD
+    ZSTD_freeCCtx(zstdContext);
+#endif
+  }
+
+  // Returns the codec that belongs to the extension of the file name, false if it is not a compressed file name
+  static bool codecFromFileName(const std::string& fileName, Codec& codec) {
+    auto hasSuffix = [&fileName](const std::string& suffix) {
+      return fileName.size() >= suffix.size() && fileName.compare(fileName.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+
+    if (hasSuffix(".zst")) {
+      codec = Codec::Zstd;
+      return true;
+    }
+    if (hasSuffix(".gz")) {
+      codec = Codec::Gzip;
+      return true;
+    }
+    return false;
+  }
+
+  // Compresses the remaining data and ends the compressed stream, returns false if writing the output failed
+  bool close() {
+    if (!isClosed) {
+      compress(true);
+      isClosed = true;
+    }
+    return isGood && output.good();
+  }
+
+protected:
+  int_type overflow(int_type ch) override {
+    if (isClosed) {
+      return traits_type::eof();
+    }
+
+    compress(false);
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+private:
+  static const size_t bufferSize = 1 << 20;
+
+  std::ostream& output;
+  Codec codec;
+  std::vector<char> inputBuffer;
+  std::vector<char> outputBuffer;
+  bool isClosed = false;
+  bool isGood = true;
+#ifdef WITH_ZLIB
+  z_stream gzipStream{};
+#endif
+#ifdef WITH_ZSTD
+  ZSTD_CCtx* zstdContext = nullptr;
+#endif
+
+  // compresses the buffered input, when finishing also the end of the gzip member or zstd frame is written
+  void compress(bool finish) {
+    char* data = pbase();
+    size_t size = static_cast<size_t>(pptr() - pbase());
+
+    if (codec == Codec::Gzip) {
+#ifdef WITH_ZLIB
+      gzipStream.next_in = reinterpret_cast<Bytef*>(data);
+      gzipStream.avail_in = static_cast<uInt>(size);
+      int result = Z_OK;
+      do {
+        gzipStream.next_out = reinterpret_cast<Bytef*>(outputBuffer.data());
+        gzipStream.avail_out = static_cast<uInt>(outputBuffer.size());
+        result = deflate(&gzipStream, finish ? Z_FINISH : Z_NO_FLUSH);
+        if (result == Z_STREAM_ERROR) {
+          isGood = false;
+          break;
+        }
+        output.write(outputBuffer.data(), outputBuffer.size() - gzipStream.avail_out);
+      } while (gzipStream.avail_out == 0 || (finish && result != Z_STREAM_END));
+#endif
+    } else {
+#ifdef WITH_ZSTD
+      ZSTD_inBuffer inBuffer = {data, size, 0};
+      size_t remaining = 0;
+      do {
+        ZSTD_outBuffer outBuffer = {outputBuffer.data(), outputBuffer.size(), 0};
+        remaining = ZSTD_compressStream2(zstdContext, &outBuffer, &inBuffer, finish ? ZSTD_e_end : ZSTD_e_continue);
+        if (ZSTD_isError(remaining)) {
+          isGood = false;
+          break;
+        }
+        output.write(outputBuffer.data(), outBuffer.pos);
+      } while (finish ? remaining != 0 : inBuffer.pos < inBuffer.size);
+#endif
+    }
+
+    setp(inputBuffer.data(), inputBuffer.data() + inputBuffer.size());
+  }
+};
+
+#endif
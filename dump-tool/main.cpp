@@ -6,11 +6,15 @@
 #include <clang/Tooling/Tooling.h>
 #include <llvm/Support/CommandLine.h>
 #include <fstream>
+#include "../comparer/include/binary_dump.h"
+#include "compressing_stream_buf.h"
+
+enum class DumpFormat { Text, Binary };
 
 class TreeBuilder : public clang::RecursiveASTVisitor<TreeBuilder> {
 public:
-  explicit TreeBuilder(clang::ASTContext* Context, std::ofstream& outFile)
-    : Context(Context), depth(-1), outFile(outFile) {}
+  explicit TreeBuilder(clang::ASTContext* Context, std::ostream& outFile, BinaryDump::Writer* binaryWriter)
+    : Context(Context), depth(-1), outFile(outFile), binaryWriter(binaryWriter) {}
 
   bool shouldVisitImplicitCode() const {
     return true;
@@ -33,8 +37,6 @@ public:
   }
 
   bool VisitDecl(clang::Decl* decl) {
-    indent();
-
     clang::SourceLocation loc = decl->getBeginLoc();
     clang::SourceManager& sm = Context->getSourceManager();
     std::string filePath = sm.getFilename(loc).str();
@@ -42,21 +44,13 @@ public:
       filePath = "N/A";
     }
 
-    outFile
-      << "Declaration\t"
-      << decl->getDeclKindName() << '\t'
-      << getUSR(decl) << '\t'
-      << filePath << '\t'
-      << sm.getSpellingLineNumber(loc) << '\t'
-      << sm.getSpellingColumnNumber(loc) << '\t'
-      << (decl->isImplicit() ? "(implicit)" : "") << '\n';
+    writeNode(true, decl->getDeclKindName(), getUSR(decl), filePath,
+              sm.getSpellingLineNumber(loc), sm.getSpellingColumnNumber(loc), decl->isImplicit());
 
     return true;
   }
 
   bool VisitStmt(clang::Stmt* stmt) {
-    indent();
-
     clang::SourceLocation loc = stmt->getBeginLoc();
     clang::SourceManager& sm = Context->getSourceManager();
     std::string filePath = sm.getFilename(loc).str();
@@ -64,13 +58,8 @@ public:
       filePath = "N/A";
     }
 
-    outFile
-      << "Statement\t"
-      << stmt->getStmtClassName() << '\t'
-      << "N/A" << '\t'
-      << filePath << '\t'
-      << sm.getSpellingLineNumber(loc) << '\t'
-      << sm.getSpellingColumnNumber(loc) << '\n';
+    writeNode(false, stmt->getStmtClassName(), "N/A", filePath,
+              sm.getSpellingLineNumber(loc), sm.getSpellingColumnNumber(loc), false);
 
     return true;
   }
@@ -78,13 +67,38 @@ public:
 private:
   clang::ASTContext* Context;
   int depth;
-  std::ofstream& outFile;
+  std::ostream& outFile;
+  BinaryDump::Writer* binaryWriter; // null for the text format
 
   void indent() const {
     for (int i = 0; i < depth; ++i)
       outFile << ' ';
   }
 
+  // writes one node either as a binary record or as an indented, tab-separated line
+  void writeNode(bool isDeclaration, const char* kind, const std::string& usr, const std::string& filePath,
+                 unsigned line, unsigned column, bool isImplicit) {
+    if (binaryWriter) {
+      binaryWriter->writeNode(static_cast<uint32_t>(depth),
+                              isDeclaration ? BinaryDump::declarationType : BinaryDump::statementType,
+                              kind, usr, filePath, line, column, isImplicit ? BinaryDump::implicitFlag : 0);
+      return;
+    }
+
+    indent();
+    outFile
+      << (isDeclaration ? "Declaration\t" : "Statement\t")
+      << kind << '\t'
+      << usr << '\t'
+      << filePath << '\t'
+      << line << '\t'
+      << column;
+    if (isDeclaration) {
+      outFile << '\t' << (isImplicit ? "(implicit)" : "");
+    }
+    outFile << '\n';
+  }
+
   std::string getUSR(clang::Decl* decl) const {
     llvm::SmallVector<char> Usr;
     clang::index::generateUSRForDecl(decl, Usr);
@@ -94,8 +108,8 @@ private:
 
 class CustomASTComsumer : public clang::ASTConsumer {
 public:
-  explicit CustomASTComsumer(clang::ASTContext* Context, std::ofstream& outFile) 
-    : Visitor(Context, outFile) { }
+  explicit CustomASTComsumer(clang::ASTContext* Context, std::ostream& outFile, BinaryDump::Writer* binaryWriter) 
+    : Visitor(Context, outFile, binaryWriter) { }
 
   virtual void HandleTranslationUnit(clang::ASTContext &Context) {
     Visitor.TraverseDecl(Context.getTranslationUnitDecl());
@@ -107,26 +121,28 @@ private:
 
 class CustomFrontendAction : public clang::ASTFrontendAction {
 public:
-  CustomFrontendAction(std::ofstream& outFile) : outFile(outFile) {}
+  CustomFrontendAction(std::ostream& outFile, BinaryDump::Writer* binaryWriter) : outFile(outFile), binaryWriter(binaryWriter) {}
 
   virtual std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance& Compiler, llvm::StringRef InFile) override {
-    return std::make_unique<CustomASTComsumer>(&Compiler.getASTContext(), outFile);
+    return std::make_unique<CustomASTComsumer>(&Compiler.getASTContext(), outFile, binaryWriter);
   }
 
 private:
-  std::ofstream& outFile;
+  std::ostream& outFile;
+  BinaryDump::Writer* binaryWriter;
 };
 
 class CustomFrontendActionFactory : public clang::tooling::FrontendActionFactory {
 public:
-  CustomFrontendActionFactory(std::ofstream& outFile) : outFile(outFile) {}
+  CustomFrontendActionFactory(std::ostream& outFile, BinaryDump::Writer* binaryWriter) : outFile(outFile), binaryWriter(binaryWriter) {}
 
   std::unique_ptr<clang::FrontendAction> create() override {
-    return std::make_unique<CustomFrontendAction>(outFile);
+    return std::make_unique<CustomFrontendAction>(outFile, binaryWriter);
   }
 
 private:
-  std::ofstream& outFile;
+  std::ostream& outFile;
+  BinaryDump::Writer* binaryWriter;
 };
 
 int main(int argc, const char* argv[]) {
@@ -140,6 +156,17 @@ int main(int argc, const char* argv[]) {
     llvm::cl::cat(MyToolCategory)
   );
 
+  llvm::cl::opt<DumpFormat> Format(
+    "format",
+    llvm::cl::desc("Specify output format"),
+    llvm::cl::values(
+      clEnumValN(DumpFormat::Text, "text", "Tab-separated lines, depth encoded by leading spaces"),
+      clEnumValN(DumpFormat::Binary, "binary", "Binary records with a string table, read faster by the comparer")
+    ),
+    llvm::cl::init(DumpFormat::Text),
+    llvm::cl::cat(MyToolCategory)
+  );
+
   auto ExpectedParser = clang::tooling::CommonOptionsParser::create(argc, argv, MyToolCategory);
 
   if (!ExpectedParser) {
@@ -158,16 +185,45 @@ int main(int argc, const char* argv[]) {
 
   Tool.appendArgumentsAdjuster(clang::tooling::getInsertArgumentAdjuster(Args, clang::tooling::ArgumentInsertPosition::END));
 
-  std::ofstream outFile(OutputFileName);
+  // a .zst or .gz output file name compresses the dump while it is written
+  CompressingStreamBuf::Codec codec;
+  bool isCompressed = CompressingStreamBuf::codecFromFileName(OutputFileName, codec);
+
+  std::ofstream outFile(OutputFileName, Format == DumpFormat::Binary || isCompressed ? std::ios::out | std::ios::binary : std::ios::out);
   if (!outFile.is_open()) {
     llvm::errs() << "Error: Could not open output file " << OutputFileName << " for writing.\n";
     return 1;
   }
 
+  std::unique_ptr<CompressingStreamBuf> compressingBuffer;
+  if (isCompressed) {
+    try {
+      compressingBuffer = std::make_unique<CompressingStreamBuf>(outFile, codec);
+    } catch (const std::exception& e) {
+      llvm::errs() << "Error: " << e.what() << "\n";
+      return 1;
+    }
+  }
+  std::ostream output(isCompressed ? static_cast<std::streambuf*>(compressingBuffer.get()) : outFile.rdbuf());
+
+  std::unique_ptr<BinaryDump::Writer> binaryWriter;
+  if (Format == DumpFormat::Binary) {
+    binaryWriter = std::make_unique<BinaryDump::Writer>(output);
+    binaryWriter->writeHeader();
+  }
+
   // Use the custom factory to create actions
-  CustomFrontendActionFactory factory(outFile);
+  CustomFrontendActionFactory factory(output, binaryWriter.get());
   int result = Tool.run(&factory);
 
+  if (binaryWriter) {
+    binaryWriter->finish();
+  }
+  output.flush();
+  if (compressingBuffer && !compressingBuffer->close()) {
+    llvm::errs() << "Error: Could not write the compressed output file " << OutputFileName << ".\n";
+    result = 1;
+  }
   outFile.close();
 
   return result;